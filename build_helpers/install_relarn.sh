@@ -37,10 +37,14 @@ cp -r ../data/fonts "$LIBDIR/"
 chmod 664 "$LIBDIR"/fonts/*
 
 
-# Create the score directory and empty scorefile.
+# Create the score directory and empty scorefiles.  (The game converts
+# an existing old-style Relarn-scoreboard the first time it runs.)
 mkdir -p "$SCOREDIR"
-touch "$SCOREDIR/Relarn-scoreboard"     # TODO: derive this from sources
-chmod a+rw "$SCOREDIR/Relarn-scoreboard"
+for f in Relarn-scores.dat Relarn-scores.idx   # TODO: derive from sources
+do
+    touch "$SCOREDIR/$f"
+    chmod a+rw "$SCOREDIR/$f"
+done
 
 # Create the executable directories and install the executable and
 # launch script.
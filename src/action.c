@@ -178,7 +178,7 @@ readscr () {
         readbook(Invent[iz].iarg);  
     }/* if .. else*/    
 
-    Invent[iz] = NULL_OBJ; 
+    inv_set(iz, NULL_OBJ); 
 }/* readscr */
 
 /*
@@ -197,7 +197,7 @@ eatcookie () {
 
     show_cookie();
 
-    Invent[iz] = NULL_OBJ;;
+    inv_set(iz, NULL_OBJ);
 }/* eatcookie */
 
 /*
@@ -215,7 +215,7 @@ quaff () {
     ASSERT(ispotion(Invent[iz]));
 
     quaffpotion(Invent[iz]); 
-    Invent[iz] = NULL_OBJ;; 
+    inv_set(iz, NULL_OBJ); 
 }/* quaff */
 
 
@@ -0,0 +1,298 @@
+// This file is part of ReLarn; Copyright (C) 1986 - 2023; GPLv2; NO WARRANTY!
+// See Copyright.txt, LICENSE.txt and AUTHORS.txt for terms.
+
+#include "allocstats.h"
+
+#include "settings.h"
+#include "stringbuilder.h"
+#include "util.h"
+#include "internal_assert.h"
+
+#include <stdio.h>
+#include <stdint.h>
+
+
+#ifdef ALLOC_STATS
+
+#include <pthread.h>
+
+// util.h sends free() to xfree() in this build; we need the real one.
+#undef free
+
+// Most call sites we keep apart.  Any more are lumped into Sites[0].
+#define MAX_SITES 256
+
+// Histogram bucket 0 counts turns with no allocations; bucket n > 0
+// those with 2^(n-1) to 2^n - 1 of them.  The last also takes
+// everything above.
+#define NUM_BUCKETS 12
+
+struct Site {
+    const char *file, *func;
+    unsigned long allocs;
+    uint64_t bytes;
+    long liveBlocks;
+    int64_t liveBytes;
+};
+
+// Prepended to every block we hand out.  It's 16 bytes so that the
+// caller's part stays as aligned as malloc() made it.
+struct Header {
+    uint32_t magic;
+    uint32_t site;                      // Index into Sites[]
+    uint64_t size;                      // Bytes the caller asked for
+};
+#define MAGIC 0xA110CA7EU
+
+struct Totals {
+    unsigned long allocs;
+    uint64_t bytes;
+    long liveBlocks;
+    int64_t liveBytes, peakBytes;
+
+    unsigned long turns, turnAllocs, maxPerTurn;
+    unsigned long perTurn[NUM_BUCKETS];
+};
+
+static pthread_mutex_t Lock = PTHREAD_MUTEX_INITIALIZER;
+static struct Site Sites[MAX_SITES] = { {"(other)", "(other)"} };
+static int NumSites = 1;
+static struct Totals Totals;
+
+// The thread's allocation count (xalloc_count()) when its current
+// turn started.
+static __thread unsigned long TurnStart;
+static __thread bool InTurn = false;
+
+
+// Return the index of the site for function 'func' in 'file',
+// adding it if it's new.  Caller holds Lock.  (__func__ is a distinct
+// array in each function, so its address is enough to go by.)
+static uint32_t
+site_index(const char *file, const char *func) {
+    for (int n = 1; n < NumSites; n++) {
+        if (Sites[n].func == func) { return n; }
+    }// for
+
+    if (NumSites == MAX_SITES) { return 0; }
+
+    Sites[NumSites].file = file;
+    Sites[NumSites].func = func;
+    return NumSites++;
+}// site_index
+
+// Record the new block at 'hdr'.
+static void
+add_block(struct Header *hdr, size_t size, const char *file,
+          const char *func) {
+    hdr->magic = MAGIC;
+    hdr->size = size;
+
+    pthread_mutex_lock(&Lock);
+
+    hdr->site = site_index(file, func);
+    struct Site *st = &Sites[hdr->site];
+    st->allocs++;
+    st->bytes += size;
+    st->liveBlocks++;
+    st->liveBytes += size;
+
+    Totals.allocs++;
+    Totals.bytes += size;
+    Totals.liveBlocks++;
+    Totals.liveBytes += size;
+    if (Totals.liveBytes > Totals.peakBytes) {
+        Totals.peakBytes = Totals.liveBytes;
+    }// if
+
+    pthread_mutex_unlock(&Lock);
+}// add_block
+
+// Record that the block at 'hdr' is going away.
+static void
+drop_block(struct Header *hdr) {
+    ASSERT(hdr->magic == MAGIC);
+
+    pthread_mutex_lock(&Lock);
+
+    struct Site *st = &Sites[hdr->site];
+    st->liveBlocks--;
+    st->liveBytes -= hdr->size;
+
+    Totals.liveBlocks--;
+    Totals.liveBytes -= hdr->size;
+
+    pthread_mutex_unlock(&Lock);
+}// drop_block
+
+
+void *
+alloc_stats_malloc(size_t size, const char *file, const char *func) {
+    struct Header *hdr = malloc(sizeof(struct Header) + size);
+    if (!hdr) { return NULL; }
+
+    add_block(hdr, size, file, func);
+    return hdr + 1;
+}// alloc_stats_malloc
+
+void *
+alloc_stats_calloc(size_t count, size_t size, const char *file,
+                   const char *func) {
+    if (size && count > SIZE_MAX / size) { return NULL; }
+
+    void *result = alloc_stats_malloc(count * size, file, func);
+    if (result) { memset(result, 0, count * size); }
+    return result;
+}// alloc_stats_calloc
+
+// Resizing counts as a new allocation by the caller (since that's
+// what it usually costs).
+void *
+alloc_stats_realloc(void *ptr, size_t size, const char *file,
+                    const char *func) {
+    if (!ptr) { return alloc_stats_malloc(size, file, func); }
+
+    struct Header *hdr = (struct Header *)ptr - 1;
+    drop_block(hdr);
+
+    struct Header *moved = realloc(hdr, sizeof(struct Header) + size);
+    if (!moved) { return NULL; }
+
+    add_block(moved, size, file, func);
+    return moved + 1;
+}// alloc_stats_realloc
+
+// Free a block from xmalloc() and friends.  (In this build, free() is
+// a macro that calls this.)
+void
+xfree(void *ptr) {
+    if (!ptr) { return; }
+
+    struct Header *hdr = (struct Header *)ptr - 1;
+    drop_block(hdr);
+    hdr->magic = 0;
+    free(hdr);
+}// xfree
+
+
+// Add the allocations made during the turn that just ended (if any)
+// to the histogram and start counting the next one's.
+void
+alloc_next_turn() {
+    unsigned long now = xalloc_count();
+    unsigned long count = now - TurnStart;
+    bool ended = InTurn;
+
+    TurnStart = now;
+    InTurn = true;
+    if (!ended) { return; }
+
+    int bucket = 0;
+    for (unsigned long n = count; n && bucket < NUM_BUCKETS - 1; n >>= 1) {
+        bucket++;
+    }// for
+
+    pthread_mutex_lock(&Lock);
+    Totals.turns++;
+    Totals.turnAllocs += count;
+    Totals.perTurn[bucket]++;
+    if (count > Totals.maxPerTurn) { Totals.maxPerTurn = count; }
+    pthread_mutex_unlock(&Lock);
+}// alloc_next_turn
+
+
+// Order sites by number of allocations, most first.
+static int
+cmp_sites(const void *left, const void *right) {
+    const struct Site *a = left, *b = right;
+    if (a->allocs != b->allocs) { return a->allocs < b->allocs ? 1 : -1; }
+    return strcmp(a->func, b->func);
+}// cmp_sites
+
+// Append a summary of all allocations so far to 'sb'.
+void
+alloc_report(struct StringBuilder *sb) {
+    // Appending to 'sb' allocates, so work from a copy.
+    struct Site sites[MAX_SITES];
+    struct Totals totals;
+
+    pthread_mutex_lock(&Lock);
+    int count = NumSites;
+    memcpy(sites, Sites, count * sizeof(struct Site));
+    totals = Totals;
+    pthread_mutex_unlock(&Lock);
+
+    sb_append(sb, "Heap allocations\n\n");
+    sb_appendf(sb, "%lu allocations, %llu bytes\n", totals.allocs,
+               (unsigned long long)totals.bytes);
+    sb_appendf(sb, "%ld blocks (%lld bytes) still live, peak %lld bytes\n",
+               totals.liveBlocks, (long long)totals.liveBytes,
+               (long long)totals.peakBytes);
+
+    if (totals.turns) {
+        unsigned long inTurns = 0;
+        sb_appendf(sb, "%lu turns; allocations per turn (allocations:turns):",
+                   totals.turns);
+        for (int b = 0; b < NUM_BUCKETS; b++) {
+            if (!totals.perTurn[b]) { continue; }
+
+            unsigned long low = b ? 1UL << (b - 1) : 0;
+            unsigned long high = b ? (1UL << b) - 1 : 0;
+            if (b == NUM_BUCKETS - 1) {
+                sb_appendf(sb, " %lu+", low);
+            } else if (high > low) {
+                sb_appendf(sb, " %lu-%lu", low, high);
+            } else {
+                sb_appendf(sb, " %lu", low);
+            }// if .. else
+            sb_appendf(sb, ":%lu", totals.perTurn[b]);
+
+            inTurns += totals.perTurn[b];
+        }// for
+        sb_appendf(sb, "\nmean %.3f per turn, most in one turn %lu\n",
+                   (double)totals.turnAllocs / totals.turns,
+                   totals.maxPerTurn);
+        ASSERT(inTurns == totals.turns);
+    }// if
+
+    qsort(sites, count, sizeof(struct Site), cmp_sites);
+
+    sb_appendf(sb, "\n%10s %12s %8s %12s  %s\n", "allocs", "bytes", "live",
+               "live bytes", "site");
+    for (int n = 0; n < count; n++) {
+        const struct Site *st = &sites[n];
+        if (!st->allocs) { continue; }
+
+        sb_appendf(sb, "%10lu %12llu %8ld %12lld  %s %s()\n", st->allocs,
+                   (unsigned long long)st->bytes, st->liveBlocks,
+                   (long long)st->liveBytes, st->file, st->func);
+    }// for
+}// alloc_report
+
+#else
+
+void
+alloc_report(struct StringBuilder *sb) {
+    sb_append(sb, "Allocation statistics were not compiled in "
+              "(see config.mk).\n");
+}// alloc_report
+
+#endif // ALLOC_STATS
+
+
+// Append the report to the file named by the 'alloc-stats-file'
+// option, if set.  This is registered with atexit().
+void
+alloc_write_file() {
+    if (!GameSettings.allocStatsFile[0]) { return; }
+
+    FILE *fh = fopen(GameSettings.allocStatsFile, "a");
+    if (!fh) { return; }
+
+    struct StringBuilder *sb = sb_alloc();
+    alloc_report(sb);
+    fprintf(fh, "%s\n", sb_str(sb));
+    sb_free(sb);
+
+    fclose(fh);
+}// alloc_write_file
@@ -0,0 +1,50 @@
+// This file is part of ReLarn; Copyright (C) 1986 - 2023; GPLv2; NO WARRANTY!
+// See Copyright.txt, LICENSE.txt and AUTHORS.txt for terms.
+
+// Heap allocation accounting.
+//
+// If ALLOC_STATS is defined (see config.mk), xmalloc() and friends
+// (util.h) record each allocation against its call site (the calling
+// file and function) and free() is redirected to xfree(), which
+// credits the block back to the site that made it.  We keep counts
+// and bytes per site, the live and peak live totals and a histogram
+// of allocations per turn (onemove() calls alloc_next_turn()).
+//
+// That's enough to find code that churns the heap and, since the
+// report shows what each site still has live, leaks.  The report is
+// in the debug menu and is appended to the file named by the
+// 'alloc-stats-file' option at exit; relarn-sim prints it at the end.
+//
+// The statistics are shared by all threads (under a lock), so this
+// slows every allocation down noticeably.  Otherwise, nothing is
+// recorded and alloc_report() just says so.
+
+#ifndef HDR_GUARD_ALLOCSTATS_H
+#define HDR_GUARD_ALLOCSTATS_H
+
+#include <stddef.h>
+
+struct StringBuilder;
+
+void alloc_report(struct StringBuilder *sb);
+void alloc_write_file(void);
+
+#ifdef ALLOC_STATS
+
+// The allocators proper, for util.c.  These return NULL on failure.
+void *alloc_stats_malloc(size_t size, const char *file, const char *func);
+void *alloc_stats_calloc(size_t count, size_t size, const char *file,
+                         const char *func);
+void *alloc_stats_realloc(void *ptr, size_t size, const char *file,
+                          const char *func);
+void xfree(void *ptr);
+
+void alloc_next_turn(void);
+
+#else
+
+static inline void alloc_next_turn(void) {}
+
+#endif // ALLOC_STATS
+
+#endif
@@ -0,0 +1,141 @@
+// This file is part of ReLarn; Copyright (C) 1986 - 2023; GPLv2; NO WARRANTY!
+// See Copyright.txt, LICENSE.txt and AUTHORS.txt for terms.
+
+#include "arena.h"
+
+#include "internal_assert.h"
+#include "util.h"
+
+#include <string.h>
+
+// Everything we hand out is aligned to this (which is enough for any
+// type we have).
+#define ARENA_ALIGN 16
+
+// The usual size of a chunk.  Bigger requests get a chunk to
+// themselves.
+#define CHUNK_SIZE (16 * 1024)
+
+// A block of memory to allocate from.  The memory follows the header
+// (at HEADER_SIZE bytes from its start).
+struct ArenaChunk {
+    struct ArenaChunk *next;
+    size_t size;                // Bytes of memory
+    size_t used;                // Bytes handed out so far
+};
+
+#define ROUND_UP(n) (((n) + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1))
+#define HEADER_SIZE ROUND_UP(sizeof(struct ArenaChunk))
+
+// This thread's chunks, in the order they're used.  Those before
+// Current are full (as far as we're concerned) and those after it are
+// free.
+static __thread struct ArenaChunk *First = NULL;
+static __thread struct ArenaChunk *Current = NULL;
+
+
+// Create a chunk of at least 'size' bytes and put it after Current.
+static struct ArenaChunk *
+new_chunk(size_t size) {
+    if (size < CHUNK_SIZE) { size = CHUNK_SIZE; }
+
+    struct ArenaChunk *ch = xmalloc(HEADER_SIZE + size);
+    ch->size = size;
+    ch->used = 0;
+
+    if (Current) {
+        ch->next = Current->next;
+        Current->next = ch;
+    } else {
+        ch->next = First;
+        First = ch;
+    }// if .. else
+
+    return ch;
+}// new_chunk
+
+
+// Return 'size' bytes of uninitialized memory from the arena.  Never
+// fails.
+void *
+arena_alloc(size_t size) {
+    size = ROUND_UP(size ? size : 1);
+
+    // Move on to the next free chunk that's big enough, making one if
+    // there isn't one.  (Any we skip just go unused until the next
+    // release.)
+    if (!Current) {
+        Current = First;
+        if (Current) { Current->used = 0; }
+    }// if
+    while (!Current || Current->used + size > Current->size) {
+        struct ArenaChunk *next = Current ? Current->next : NULL;
+        while (next && next->size < size) { next = next->next; }
+
+        Current = next ? next : new_chunk(size);
+        Current->used = 0;
+    }// while
+
+    void *result = (char *)Current + HEADER_SIZE + Current->used;
+    Current->used += size;
+    return result;
+}// arena_alloc
+
+// Like arena_alloc() but the memory is zeroed (as with calloc()).
+void *
+arena_calloc(size_t count, size_t size) {
+    ASSERT(size == 0 || count <= (size_t)-1 / size);
+
+    void *result = arena_alloc(count * size);
+    memset(result, 0, count * size);
+    return result;
+}// arena_calloc
+
+// Return a copy of 'src' in the arena.
+char *
+arena_strdup(const char *src) {
+    size_t len = strlen(src);
+    char *result = arena_alloc(len + 1);
+    memcpy(result, src, len + 1);
+    return result;
+}// arena_strdup
+
+
+// Return the arena's current position.  Passing it to arena_release()
+// frees everything allocated after this call.
+struct ArenaMark
+arena_mark() {
+    struct ArenaMark mark = { Current, Current ? Current->used : 0 };
+    return mark;
+}// arena_mark
+
+// Free everything allocated since 'mark' was taken.
+void
+arena_release(struct ArenaMark mark) {
+    Current = mark.chunk;
+    if (Current) {
+        ASSERT(mark.used <= Current->used);
+        Current->used = mark.used;
+    }// if
+}// arena_release
+
+// Free everything in the arena.  Nothing allocated from it may be in
+// use.
+void
+arena_reset() {
+    Current = NULL;
+}// arena_reset
+
+// Like arena_reset() but also give the arena's memory back to the
+// system.  Threads that use the arena should call this before they
+// exit.
+void
+arena_free() {
+    while (First) {
+        struct ArenaChunk *next = First->next;
+        free(First);
+        First = next;
+    }// while
+
+    Current = NULL;
+}// arena_free
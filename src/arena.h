@@ -0,0 +1,44 @@
+// This file is part of ReLarn; Copyright (C) 1986 - 2023; GPLv2; NO WARRANTY!
+// See Copyright.txt, LICENSE.txt and AUTHORS.txt for terms.
+
+// Scratch memory for short-lived temporaries.
+//
+// arena_alloc() and friends hand out memory from a per-thread arena
+// by bumping a pointer.  Nothing is freed individually.  Instead,
+// arena_mark() records how much of the arena is in use and
+// arena_release() throws away everything allocated since; since the
+// arena keeps its memory, the next allocations reuse it without going
+// near malloc().
+//
+// onemove() does this for each turn and play_turn() for each command,
+// so memory from the arena lasts until the end of the current command
+// at most.  Code that wants it gone sooner (e.g. a loop making lots of
+// temporaries) can open a scope of its own.  Scopes must nest; don't
+// release a mark after one taken before it.
+//
+// Anything that needs to outlive the command (or go into the game
+// state) belongs on the heap.
+
+#ifndef HDR_GUARD_ARENA_H
+#define HDR_GUARD_ARENA_H
+
+#include <stddef.h>
+
+struct ArenaChunk;
+
+// A position in the arena; see arena_mark().
+struct ArenaMark {
+    struct ArenaChunk *chunk;
+    size_t used;
+};
+
+void *arena_alloc(size_t size);
+void *arena_calloc(size_t count, size_t size);
+char *arena_strdup(const char *src);
+
+struct ArenaMark arena_mark(void);
+void arena_release(struct ArenaMark mark);
+void arena_reset(void);
+void arena_free(void);
+
+#endif
@@ -14,26 +14,58 @@ static void show_taxes_msg(const char *branchTitle);
 static void bankmenu(const char *str);
 
 
+// Return 'balance' after 'mobuls' mobuls of interest.  Each mobul
+// adds balance/INTEREST_DIV, rounded down (at 1 mobul ~=~ 1 hour,
+// that's 10% a year) until the balance reaches BANKLIMIT.
+//
+// This used to go one mobul at a time, which took thousands of
+// iterations after a long trip (and spun uselessly on balances too
+// small to earn anything).  But the interest only changes when the
+// balance passes a multiple of INTEREST_DIV, so we can do all of the
+// mobuls up to there in one step.  That gives exactly the same result
+// in at most about 1100 steps, however long the player was away.
+// (bench/check_interest.c checks this against the old loop.)
+int64_t
+bank_interest(int64_t balance, long mobuls) {
+    if (balance <= 0 || balance >= BANKLIMIT) { return balance; }
+
+    // balance == rate * INTEREST_DIV + rem throughout.
+    int64_t rate = balance / INTEREST_DIV;
+    int64_t rem = balance % INTEREST_DIV;
+
+    while (mobuls > 0 && rate > 0 && balance < BANKLIMIT) {
+        // Mobuls until the rate goes up (or we run out)...
+        int64_t steps = (INTEREST_DIV - rem + rate - 1) / rate;
+        if (steps > mobuls) { steps = mobuls; }
+
+        // ...or until we reach the limit, which is rarer.
+        if (balance + (steps - 1) * rate >= BANKLIMIT) {
+            steps = (BANKLIMIT - balance + rate - 1) / rate;
+        }// if
+
+        balance += steps * rate;
+        mobuls -= steps;
+
+        for (rem += steps * rate; rem >= INTEREST_DIV; rem -= INTEREST_DIV) {
+            rate++;
+        }// for
+    }// while
+
+    return balance;
+}// bank_interest
+
+
 /*
  *  function to put interest on your bank account
- *
- *  limit of 1 million gold pieces in bank
  */
-
 static void
 ointerest() {
-    const int BANKLIMIT = 1000000;
-    int i;
-
     if (UU.bankaccount < 0) {
         UU.bankaccount = 0;
-    } else if (UU.bankaccount > 0 && UU.bankaccount < BANKLIMIT) {
-        i = (UU.gtime-UU.banktime)/MOBUL; /*# mobuls elapsed since last here*/
-
-        while ((i-- > 0) && (UU.bankaccount < BANKLIMIT)) {
-            /* at 1 mobul ~=~ 1 hour, is 10 % a year */
-            UU.bankaccount += (long) (UU.bankaccount / 877);
-        }/* while */
+    } else {
+        /*# mobuls elapsed since last here*/
+        long mobuls = (UU.gtime - UU.banktime) / MOBUL;
+        UU.bankaccount = bank_interest(UU.bankaccount, mobuls);
     }/* if */
 
     UU.banktime = (UU.gtime/MOBUL)*MOBUL;
@@ -7,7 +7,15 @@
 #define HDR_GUARD_BANK_H
 
 #include <stdbool.h>
+#include <stdint.h>
+
+// The bank doesn't pay interest on balances this large (or larger).
+#define BANKLIMIT 1000000
+
+// Each mobul, the bank adds balance / INTEREST_DIV (rounded down).
+#define INTEREST_DIV 877
 
 void obank(bool isMain);
+int64_t bank_interest(int64_t balance, long mobuls);
 
 #endif
@@ -0,0 +1,630 @@
+// This file is part of ReLarn; Copyright (C) 1986 - 2023; GPLv2; NO WARRANTY!
+// See Copyright.txt, LICENSE.txt and AUTHORS.txt for terms.
+
+// Benchmark driver for the game's hot paths: level creation and
+// changing levels, monster movement, inventory bookkeeping, timed
+// effects, field of view, redrawing, missile spells, save games, the
+// scoreboard and text handling.  It links against the headless UI
+// (ui_headless.c) so it needs no terminal and drawing costs nothing.
+//
+// Every benchmark seeds the RNG itself so runs are repeatable.
+// Results are printed one per line in the form
+//
+//     bench <name> iters=<n> total_us=<usec> us_per_iter=<usec>
+//
+// so that scripts can pick them out; everything else goes to stderr.
+// If an argument is given, only benchmarks whose names contain it
+// are run.  '-r <runs>' runs the whole set that many times (in this
+// process, one after the other) and prints a line for each run;
+// bench/perf_gate.pl uses this to get medians.
+//
+// All files (config dir, save game, scoreboard) are created in a
+// scratch install root that is deleted afterward.  Run from src/.
+
+#define _XOPEN_SOURCE 700   // For nftw()
+
+#include "arena.h"
+#include "map.h"
+#include "cast.h"
+#include "display.h"
+#include "monster.h"
+#include "movem.h"
+#include "player.h"
+#include "pregen.h"
+#include "savegame.h"
+#include "score_file.h"
+#include "settings.h"
+#include "store.h"
+#include "text_template.h"
+#include "textbuffer.h"
+#include "os.h"
+#include "util.h"
+
+#include "bench/ui_headless.h"
+
+#include <stdio.h>
+#include <limits.h>
+#include <unistd.h>
+#include <ftw.h>
+#include <sys/stat.h>
+
+#define SEED 1986
+
+static const char *Filter = NULL;
+
+static uint64_t Elapsed = 0;
+static uint64_t ClockStart = 0;
+
+
+// Start and stop the benchmark clock.  Only time between the two is
+// counted, so setup inside the loop can be left out.
+static void clock_on()  { ClockStart = monotonic_usec(); }
+static void clock_off() { Elapsed += monotonic_usec() - ClockStart; }
+
+
+static bool
+wanted(const char *name) {
+    return !Filter || strstr(name, Filter);
+}// wanted
+
+
+// Print the result for 'name' and reset the clock.
+static void
+report(const char *name, long iters) {
+    printf("bench %s iters=%ld total_us=%llu us_per_iter=%.3f\n", name,
+           iters, (unsigned long long)Elapsed, (double)Elapsed / iters);
+    fflush(stdout);
+    Elapsed = 0;
+}// report
+
+
+// A world with no levels created yet.
+static struct World *Blank = NULL;
+
+// Throw away all levels and create level 'depth' from scratch, with
+// the player somewhere sensible.
+static void
+fresh_level(int depth) {
+    restore_global_world_from(Blank);
+    UU.x = rnd(MAXX - 2);
+    UU.y = rnd(MAXY - 2);
+    setlevel(depth, false);
+    positionplayer();
+}// fresh_level
+
+
+static void
+bench_newcavelevel() {
+    if (!wanted("newcavelevel")) { return; }
+
+    // Individual levels are quick so we also report the whole set,
+    // which is a much steadier number.
+    const int iters = 100;
+    uint64_t all = 0;
+    for (int depth = 0; depth <= VBOTTOM; depth++) {
+        seed_rng(SEED + depth);
+
+        for (int n = 0; n < iters; n++) {
+            restore_global_world_from(Blank);
+            clock_on();
+            setlevel(depth, false);
+            clock_off();
+        }// for
+
+        char name[40];
+        snprintf(name, sizeof(name), "newcavelevel.d%02d", depth);
+        all += Elapsed;
+        report(name, iters);
+    }// for
+
+    Elapsed = all;
+    report("newcavelevel.all", iters * (VBOTTOM + 1));
+}// bench_newcavelevel
+
+
+// Going down the stairs to a new level, built on arrival ("now") and
+// ahead of time in the background as in the game ("ahead").  The
+// player spends long enough on the level above for it to be done, so
+// we wait for that before starting the clock.
+static void
+bench_levelchange() {
+    if (!wanted("levelchange")) { return; }
+
+    const int iters = 100;
+    for (int ahead = 0; ahead <= 1; ahead++) {
+        pregen_set_background(ahead);
+        seed_rng(SEED);
+
+        for (int n = 0; n < iters; n++) {
+            int depth = 1 + n % (DBOTTOM - 1);
+            restore_global_world_from(Blank);
+            setlevel(depth, false);
+            pregen_finish();
+
+            clock_on();
+            setlevel(depth + 1, true);
+            clock_off();
+        }// for
+
+        report(ahead ? "levelchange.ahead" : "levelchange.now", iters);
+    }// for
+
+    restore_global_world_from(Blank);
+    pregen_set_background(false);
+}// bench_levelchange
+
+
+// Create a deep level crowded with monsters.
+static void
+populated_level() {
+    seed_rng(SEED);
+    fresh_level(10);
+    for (int n = 0; n < 60; n++) {
+        fillmonst(makemonst(getlevel()));
+    }
+}// populated_level
+
+
+static void
+bench_movemonst() {
+    static const struct { const char *name; bool aggravate; } cases[] = {
+        {"movemonst.normal",        false},
+        {"movemonst.aggravated",    true},
+    };
+
+    struct World *start = xmalloc(sizeof(struct World));
+    const int iters = 5000;
+
+    for (int c = 0; c < 2; c++) {
+        if (!wanted(cases[c].name)) { continue; }
+
+        populated_level();
+        stash_global_world_at(start);
+        struct Player startUU = UU;
+
+        for (int n = 0; n < iters; n++) {
+            // Every so often, go back to the starting position so the
+            // monsters don't all end up in a pile around the player.
+            if (n % 100 == 0) {
+                restore_global_world_from(start);
+                UU = startUU;
+                effect_set(EFF_AGGRAVATE, cases[c].aggravate ? 100000 : 0);
+            }// if
+
+            // The player mustn't die; that would end the program.
+            UU.hp = UU.hpmax = 1000000;
+
+            clock_on();
+            movemonst();
+            clock_off();
+        }// for
+
+        report(cases[c].name, iters);
+    }// for
+
+    free(start);
+}// bench_movemonst
+
+
+// The per-turn inventory bookkeeping (regen() and recalc()) and has_a()
+// with a full pack.
+static void
+bench_inventory() {
+    static const enum OBJECT_ID pack[] = {
+        OLONGSWORD, OPLATE, OSHIELD, OPROTRING, OREGENRING, ORINGOFEXTRA,
+        OENERGYRING, ODEXRING, OSTRRING, OCLEVERRING, ODAMRING, OBELT,
+        OORB, OSPHTALISMAN, OCOOKIE, OBOOK, OSSTEALTH, OPTREASURE,
+    };
+
+    struct Player startUU = UU;
+    struct Object startInvent[IVENSIZE];
+    memcpy(startInvent, Invent, sizeof(startInvent));
+
+    for (int n = 0; n < (int)(sizeof(pack)/sizeof(pack[0])); n++) {
+        inv_set(n, obj(pack[n], 1));
+    }// for
+    UU.wield = 0;
+    UU.wear = 1;
+    UU.shield = 2;
+
+    const int iters = 200000;
+    if (wanted("inventory.turn")) {
+        clock_on();
+        for (int n = 0; n < iters; n++) {
+            regen();
+            recalc();
+        }// for
+        clock_off();
+        report("inventory.turn", iters);
+    }// if
+
+    if (wanted("inventory.has_a")) {
+        int found = 0;
+        clock_on();
+        for (int n = 0; n < iters; n++) {
+            found += has_a(OHANDofFEAR) + has_a(OORB) + has_a(OAMULET) +
+                has_a(OSPHTALISMAN);
+        }// for
+        clock_off();
+        ASSERT(found == 2 * iters);
+        report("inventory.has_a", iters);
+    }// if
+
+    UU = startUU;
+    inv_set_all(startInvent);
+}// bench_inventory
+
+
+// regen() with no timed effects and with a dozen long-running ones
+// (as after a few potions and spells).
+static void
+bench_effects() {
+    static const enum EFFECT buffs[] = {
+        EFF_HERO, EFF_PROTECTION, EFF_DEXCOUNT, EFF_STRCOUNT, EFF_CHARM,
+        EFF_INVISIBILITY, EFF_HASTESELF, EFF_STEALTH, EFF_SPIRITPRO,
+        EFF_UNDEADPRO, EFF_FIRERESISTANCE, EFF_SEEINVISIBLE,
+    };
+
+    struct Player startUU = UU;
+    const int iters = 500000;
+
+    for (int busy = 0; busy < 2; busy++) {
+        const char *name = busy ? "effects.regen_busy" : "effects.regen_idle";
+        if (!wanted(name)) { continue; }
+
+        for (int n = 0; busy && n < (int)(sizeof(buffs)/sizeof(buffs[0])); n++){
+            effect_set(buffs[n], 2 * iters);
+        }// for
+
+        clock_on();
+        for (int n = 0; n < iters; n++) {
+            regen();
+        }// for
+        clock_off();
+        report(name, iters);
+
+        UU = startUU;
+    }// for
+}// bench_effects
+
+
+static void
+bench_fov() {
+    static const int radii[] = {0, 2, 5, 100};
+    const int iters = 20000;
+
+    for (int r = 0; r < 4; r++) {
+        char name[40];
+        snprintf(name, sizeof(name), "fov.r%d", radii[r]);
+        if (!wanted(name)) { continue; }
+
+        populated_level();
+
+        // Enlightenment is the only way to pick an arbitrary radius.
+        UU.enlightenment.time = 255;
+        UU.enlightenment.radius = radii[r];
+
+        clock_on();
+        for (int n = 0; n < iters; n++) {
+            see_and_update_fov();
+        }
+        clock_off();
+
+        UU.enlightenment.time = 0;
+        report(name, iters);
+    }// for
+}// bench_fov
+
+
+static void
+bench_redraw() {
+    if (!wanted("redraw")) { return; }
+
+    populated_level();
+    set_reveal(true);
+
+    const int iters = 5000;
+    clock_on();
+    for (int n = 0; n < iters; n++) {
+        redraw();
+    }
+    clock_off();
+
+    report("redraw", iters);
+}// bench_redraw
+
+
+// Answer direction prompts by going around the compass.
+static char
+next_direction(enum HEADLESS_INPUT what, void *arg) {
+    int *turn = arg;
+    return "hjklyubn"[(*turn)++ % 8];
+}// next_direction
+
+
+// Missile spells (godirect()) fired in every direction across a
+// crowded level.
+static void
+bench_godirect() {
+    if (!wanted("godirect")) { return; }
+
+    struct World *start = xmalloc(sizeof(struct World));
+    populated_level();
+    stash_global_world_at(start);
+    struct Player startUU = UU;
+
+    int turn = 0;
+    headless_set_input(next_direction, &turn);
+
+    const int iters = 20000;
+    for (int n = 0; n < iters; n++) {
+        // Put back the monsters and walls every so often.
+        if (n % 100 == 0) {
+            restore_global_world_from(start);
+            UU = startUU;
+        }// if
+
+        // The player mustn't die (the bolt can bounce back).
+        UU.hp = UU.hpmax = 1000000;
+
+        clock_on();
+        godirect(CMMISSILE, 100, "The missile hits the %s.", 0, '+');
+        clock_off();
+    }// for
+
+    headless_set_input(NULL, NULL);
+    report("godirect", iters);
+
+    restore_global_world_from(start);
+    UU = startUU;
+    free(start);
+}// bench_godirect
+
+
+static void
+bench_savegame(const char *scratch) {
+    char path[PATH_MAX];
+    snprintf(path, sizeof(path), "%s/bench.sav", scratch);
+
+    populated_level();
+    stash_game_state();
+
+    const int iters = 500;
+
+    if (wanted("stash_game_state")) {
+        clock_on();
+        for (int n = 0; n < iters; n++) {
+            stash_game_state();
+        }
+        clock_off();
+        report("stash_game_state", iters);
+    }// if
+
+    // Always write the file; the load benchmark needs it.
+    for (int n = 0; n < iters; n++) {
+        FILE *fh = fopen(path, "wb");
+        ENSURE_MSG(fh, "Unable to create save file.");
+
+        clock_on();
+        ENSURE_MSG(save_stashed_game_to_file(fh), "Save failed.");
+        fclose(fh);
+        clock_off();
+    }// for
+    if (wanted("savegame.save")) {
+        report("savegame.save", iters);
+    }
+    Elapsed = 0;
+
+    if (wanted("savegame.load")) {
+        for (int n = 0; n < iters; n++) {
+            FILE *fh = fopen(path, "rb");
+            ENSURE_MSG(fh, "Unable to open save file.");
+
+            bool wrongVersion = false;
+            clock_on();
+            ENSURE_MSG(load_stashed_game_from_file(fh, &wrongVersion),
+                       "Load failed.");
+            fclose(fh);
+            clock_off();
+        }// for
+        report("savegame.load", iters);
+    }// if
+
+    unlink(path);
+}// bench_savegame
+
+
+// Time adding scores to an empty board, then reading it back.
+static void
+bench_scores_of_size(int size) {
+    char name[40];
+
+    unlink(scoredata_path());
+    unlink(scoreindex_path());
+    ensureboard();
+
+    seed_rng(SEED);
+    for (int n = 0; n < size; n++) {
+        long score = rng_next() % 1000000;
+        UU.level = 1 + n % 30;
+        UU.challenge = n % 10;
+
+        clock_on();
+        newscore(score, score % 7 == 0, n % 16, "were killed by a bench", &UU);
+        clock_off();
+    }// for
+
+    snprintf(name, sizeof(name), "score.newscore.%d", size);
+    if (wanted(name)) { report(name, size); }
+    Elapsed = 0;
+
+    const int exports = 20;
+    snprintf(name, sizeof(name), "score.export.%d", size);
+    if (wanted(name)) {
+        clock_on();
+        for (int n = 0; n < exports; n++) {
+            ENSURE_MSG(write_scores("/dev/null"), "Score export failed.");
+        }
+        clock_off();
+        report(name, exports);
+    }// if
+
+    const int lookups = 500;
+    snprintf(name, sizeof(name), "score.taxes.%d", size);
+    if (wanted(name)) {
+        clock_on();
+        for (int n = 0; n < lookups; n++) {
+            get_taxes_owed();
+        }
+        clock_off();
+        report(name, lookups);
+    }// if
+}// bench_scores_of_size
+
+
+static void
+bench_scores() {
+    if (!wanted("score.")) { return; }
+
+    bench_scores_of_size(1000);
+    bench_scores_of_size(10000);
+}// bench_scores
+
+
+static void
+bench_textbuffer() {
+    if (!wanted("tb_append")) { return; }
+
+    // Same shape as the console's buffer.
+    struct TextBuffer *tb = tb_malloc(300, 80);
+
+    const int iters = 200000;
+    clock_on();
+    for (int n = 0; n < iters; n++) {
+        switch (n % 3) {
+        case 0: tb_append(tb, "You hit the bugbear. ");                 break;
+        case 1: tb_append(tb, "The bugbear hits you.\n");               break;
+        case 2: tb_append(tb, "The bugbear dies! You feel a bit more "
+                          "experienced and rather pleased with "
+                          "yourself.\n");
+            break;
+        }// switch
+    }// for
+    clock_off();
+
+    tb_free(tb);
+    report("tb_append", iters);
+}// bench_textbuffer
+
+
+static void
+bench_text_expand() {
+    if (!wanted("text_expand")) { return; }
+
+    char *template =
+        "Dear ${player},\n\n"
+        "Our records show that you owe ${taxes_owed_gp} on a fortune of "
+        "${wealth_gp}.  Please remit payment by ${date} or contact "
+        "${player_email} for an extension.  Your score of ${score} has "
+        "been noted.  $$5 processing fee applies.\n";
+
+    const int iters = 50000;
+    size_t total = 0;
+    clock_on();
+    for (int n = 0; n < iters; n++) {
+        char *text = text_expand(template, &UU);
+        total += strlen(text);
+        arena_reset();
+    }// for
+    clock_off();
+
+    ENSURE_MSG(total > 0, "text_expand() produced nothing.");
+    report("text_expand", iters);
+}// bench_text_expand
+
+
+static int
+remove_entry(const char *path, const struct stat *sb, int flag,
+             struct FTW *ftwbuf) {
+    return remove(path);
+}// remove_entry
+
+
+// Create a scratch install root with the data files linked in and
+// point the game at it.
+static void
+make_scratch_root(char *root) {
+    ENSURE_MSG(mkdtemp(root), "Unable to create scratch directory.");
+
+    char data[PATH_MAX], path[PATH_MAX];
+    ENSURE_MSG(realpath("../data", data), "Can't find ../data; run from src/.");
+
+    static const char *dirs[] = {"share", "share/relarn", "var",
+                                 "var/relarn", NULL};
+    for (int n = 0; dirs[n]; n++) {
+        snprintf(path, sizeof(path), "%s/%s", root, dirs[n]);
+        ENSURE_MSG(mkdir(path, 0700) == 0, "Unable to create directory.");
+    }// for
+
+    snprintf(path, sizeof(path), "%s/share/relarn/lib", root);
+    ENSURE_MSG(symlink(data, path) == 0, "Unable to link data directory.");
+
+    setenv("RELARN_INSTALL_ROOT", root, 1);
+    setenv("HOME", root, 1);
+}// make_scratch_root
+
+
+int
+main(int argc, char *argv[]) {
+    int runs = 1;
+    for (int opt; (opt = getopt(argc, argv, "r:")) != -1; ) {
+        if (opt != 'r' || (runs = atoi(optarg)) < 1) {
+            fprintf(stderr, "usage: %s [-r runs] [filter]\n", argv[0]);
+            return 1;
+        }// if
+    }// for
+    if (optind < argc) { Filter = argv[optind]; }
+
+    char root[] = "/tmp/relarn-bench-XXXXXX";
+    make_scratch_root(root);
+
+    init_os(argv[0]);
+    initopts();
+    gc_bind(gc_new());
+    ensureboard();
+
+    // Building levels in the background would just add noise to
+    // everything but bench_levelchange(), which turns it on itself.
+    pregen_set_background(false);
+
+    seed_rng(SEED);
+    init_new_player(CCWIZARD, FEMALE, MALE, 0);
+    zstrncpy(UU.name, "Bench Marker", sizeof(UU.name));
+
+    Blank = xcalloc(1, sizeof(struct World));
+
+    uint64_t start = monotonic_usec();
+
+    for (int run = 0; run < runs; run++) {
+        bench_newcavelevel();
+        bench_levelchange();
+        bench_movemonst();
+        bench_inventory();
+        bench_effects();
+        bench_fov();
+        bench_redraw();
+        bench_godirect();
+        bench_savegame(root);
+        bench_scores();
+        bench_textbuffer();
+        bench_text_expand();
+    }// for
+
+    fprintf(stderr, "bench_game: done in %.2f s\n",
+            (monotonic_usec() - start) / 1e6);
+
+    free(Blank);
+    nftw(root, remove_entry, 16, FTW_DEPTH | FTW_PHYS);
+
+    return 0;
+}// main
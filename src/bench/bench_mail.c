@@ -0,0 +1,89 @@
+// This file is part of ReLarn; Copyright (C) 1986 - 2023; GPLv2; NO WARRANTY!
+// See Copyright.txt, LICENSE.txt and AUTHORS.txt for terms.
+
+// Benchmark: time text_expand() and write_emails() over the full
+// junk mail template set.  $HOME is pointed at a scratch directory
+// so the real mailbox is left alone.
+
+#include "arena.h"
+#include "bill.h"
+#include "game_context.h"
+#include "text_template.h"
+#include "player.h"
+#include "os.h"
+#include "util.h"
+
+#include <stdio.h>
+#include <unistd.h>
+
+#define EXPAND_ROUNDS   20000
+#define MAIL_ROUNDS     2000
+
+// Read all of 'path' into a malloc'd string.
+static char *
+slurp(const char *path) {
+    FILE *fh = fopen(path, "r");
+    ENSURE_MSG(fh, "Unable to open the email template file.");
+
+    size_t len = 0;
+    char *text = xmalloc(1);
+    for (int c = getc(fh); c != EOF; c = getc(fh)) {
+        text = xrealloc(text, len + 2);
+        text[len++] = c;
+    }// for
+    text[len] = 0;
+
+    fclose(fh);
+    return text;
+}// slurp
+
+int
+main(int argc, char *argv[]) {
+    char home[] = "/tmp/relarn-bench-XXXXXX";
+    ENSURE_MSG(mkdtemp(home), "Unable to create scratch directory.");
+    setenv("HOME", home, 1);
+
+    init_os(argv[0]);
+    load_email_templates();
+    gc_bind(gc_new());
+
+    zstrncpy(UU.name, "Bench Marker", sizeof(UU.name));
+    UU.gold = 123456;
+    UU.bankaccount = 7890;
+    UU.wizardMode = true;       // Send every message
+
+    // Expand the whole file as one big template.
+    char *all = slurp(junkmail_path());
+    size_t outlen = 0;
+
+    uint64_t start = monotonic_usec();
+    for (int n = 0; n < EXPAND_ROUNDS; n++) {
+        char *text = text_expand(all, &UU);
+        outlen += strlen(text);
+        arena_reset();
+    }// for
+    uint64_t elapsed = monotonic_usec() - start;
+
+    printf("text_expand: %d x %zu bytes in %.3f s (%.1f MB/s out)\n",
+           EXPAND_ROUNDS, strlen(all), elapsed / 1e6,
+           outlen / (double)elapsed);
+
+    start = monotonic_usec();
+    for (int n = 0; n < MAIL_ROUNDS; n++) {
+        ENSURE_MSG(write_emails(), "write_emails() failed.");
+    }// for
+    elapsed = monotonic_usec() - start;
+
+    printf("write_emails: %d calls in %.3f s (%.0f us/call)\n",
+           MAIL_ROUNDS, elapsed / 1e6, elapsed / (double)MAIL_ROUNDS);
+
+    free(all);
+
+    // Clean up the scratch directory.
+    unlink(mailfile_path());
+    unlink(cfgfile_path());
+    rmdir(cfgdir_path());
+    rmdir(home);
+
+    return 0;
+}// main
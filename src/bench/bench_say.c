@@ -0,0 +1,43 @@
+// This file is part of ReLarn; Copyright (C) 1986 - 2020; GPLv2; NO WARRANTY!
+// See Copyright.txt, LICENSE.txt and AUTHORS.txt for terms.
+
+// Benchmark: time a large number of say() calls.  The UI is never
+// initialized so this measures message formatting and the console
+// TextBuffer, not curses.
+
+#include "ui.h"
+#include "util.h"
+
+#include <stdio.h>
+
+#define SAY_CALLS 1000000
+
+int
+main(int argc, char *argv[]) {
+    static const char *monsters[] = {
+        "giant ant", "kobold", "jackal", "hobgoblin", "bugbear",
+        "water lord", "demon prince",
+    };
+    const int nmon = sizeof(monsters) / sizeof(monsters[0]);
+
+    uint64_t start = monotonic_usec();
+    for (int n = 0; n < SAY_CALLS; n++) {
+        // Mix partial lines (which get joined to the last line) with
+        // whole ones, roughly the way combat messages do.
+        switch (n % 4) {
+        case 0: say("You hit the %s. ", monsters[n % nmon]);    break;
+        case 1: say("The %s hits you.\n", monsters[n % nmon]);  break;
+        case 2: say("You found %d gold pieces.\n", n % 1000);   break;
+        case 3: say("The %s dies! You feel a bit more experienced "
+                    "and rather pleased with yourself.\n",
+                    monsters[n % nmon]);
+            break;
+        }// switch
+    }// for
+    uint64_t elapsed = monotonic_usec() - start;
+
+    printf("say: %d calls in %.3f s (%.0f ns/call)\n", SAY_CALLS,
+           elapsed / 1e6, elapsed * 1000.0 / SAY_CALLS);
+
+    return 0;
+}// main
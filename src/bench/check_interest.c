@@ -0,0 +1,124 @@
+// This file is part of ReLarn; Copyright (C) 1986 - 2023; GPLv2; NO WARRANTY!
+// See Copyright.txt, LICENSE.txt and AUTHORS.txt for terms.
+
+// Exhaustive check of bank_interest() against the mobul-at-a-time
+// loop it replaced.  For every balance from just below zero to just
+// past BANKLIMIT, it checks:
+//
+//  1. Every elapsed time up to a couple of mobuls past the first
+//     change in the rate.  This covers every step bank_interest()
+//     can take (each one starts at some balance and ends at another),
+//     so together with (2) it covers all elapsed times.
+//
+//  2. One mobul short of what the loop needs to finish (i.e. reach
+//     BANKLIMIT or stop earning) and "forever".
+//
+// It also compares every elapsed time outright for a spread of
+// balances.  Prints a summary and exits with status 1 on the first
+// mismatch.
+
+#include "bank.h"
+
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define LOW     (-2)
+#define HIGH    (BANKLIMIT + 2)
+
+// The original implementation, from ointerest().
+static int64_t
+interest_loop(int64_t balance, long mobuls) {
+    if (balance > 0 && balance < BANKLIMIT) {
+        while ((mobuls-- > 0) && (balance < BANKLIMIT)) {
+            balance += (long) (balance / INTEREST_DIV);
+        }/* while */
+    }/* if */
+
+    return balance;
+}// interest_loop
+
+
+static long Checks = 0;
+
+static void
+check(int64_t balance, long mobuls, int64_t expected) {
+    int64_t got = bank_interest(balance, mobuls);
+    Checks++;
+    if (got == expected) { return; }
+
+    printf("MISMATCH: balance %lld after %ld mobuls: got %lld, expected %lld\n",
+           (long long)balance, mobuls, (long long)got, (long long)expected);
+    exit(1);
+}// check
+
+
+int
+main() {
+    // The final balance of each starting balance, the one before that
+    // and the number of mobuls the loop takes to get there, worked
+    // back from the top.  (Balances only go up, so the next one has
+    // always been done.)
+    size_t count = HIGH - LOW + 1;
+    int64_t *final = calloc(count, sizeof(int64_t));
+    int64_t *penult = calloc(count, sizeof(int64_t));
+    long *steps = calloc(count, sizeof(long));
+    if (!final || !penult || !steps) {
+        fprintf(stderr, "Out of memory.\n");
+        return 1;
+    }// if
+
+    for (int64_t bal = HIGH; bal >= LOW; bal--) {
+        int64_t next = interest_loop(bal, 1);
+        if (next == bal) {
+            final[bal - LOW] = penult[bal - LOW] = bal;
+            steps[bal - LOW] = 0;
+        } else if (next > HIGH || steps[next - LOW] == 0) {
+            final[bal - LOW] = next;
+            penult[bal - LOW] = bal;
+            steps[bal - LOW] = 1;
+        } else {
+            final[bal - LOW] = final[next - LOW];
+            penult[bal - LOW] = penult[next - LOW];
+            steps[bal - LOW] = steps[next - LOW] + 1;
+        }// if .. else
+    }// for
+
+    long longest = 0;
+    for (int64_t bal = LOW; bal <= HIGH; bal++) {
+        long n = steps[bal - LOW];
+        if (n > longest) { longest = n; }
+
+        // (1) Through the first rate change
+        int64_t rate = bal > 0 ? bal / INTEREST_DIV : 0;
+        long firstRun = rate ? (INTEREST_DIV + rate - 1) / rate + 2 : 2;
+        int64_t expected = bal;
+        for (long m = 0; m <= firstRun; m++) {
+            check(bal, m, expected);
+            expected = interest_loop(expected, 1);
+        }// for
+
+        // (2) Around the end
+        if (n > 0) {
+            check(bal, n - 1, penult[bal - LOW]);
+        }// if
+        check(bal, LONG_MAX, final[bal - LOW]);
+    }// for
+
+    // Every elapsed time for a spread of balances.
+    for (int64_t bal = 1; bal < BANKLIMIT; bal += 49999) {
+        int64_t expected = bal;
+        for (long m = 0; m <= longest + 1; m++) {
+            check(bal, m, expected);
+            expected = interest_loop(expected, 1);
+        }// for
+    }// for
+
+    printf("check_interest: OK, %ld checks, balances %d to %d, "
+           "longest run %ld mobuls\n", Checks, LOW, HIGH, longest);
+
+    free(final);
+    free(penult);
+    free(steps);
+    return 0;
+}// main
@@ -0,0 +1,151 @@
+#!/usr/bin/env perl
+
+# Performance regression gate.
+#
+# Runs the benchmark driver (bench_game) several times in a single
+# process, takes the median and the median absolute deviation (MAD)
+# of each benchmark's time per iteration and compares the medians
+# against a baseline JSON file.  If any hot path (monster movement,
+# field of view, saving, level generation) is slower than the
+# baseline by more than the threshold, prints a report and exits
+# with status 1.  Other benchmarks are reported but can't fail the
+# gate.  Nor can benchmarks that are only in the baseline or only in
+# the current run; they're listed so the baseline can be regenerated.
+#
+# The driver seeds its RNG so the work done is identical from run to
+# run, but times are only comparable on the same machine with the
+# same build settings; regenerate the baseline (--update) when either
+# changes.
+#
+# Usage: perf_gate.pl [--runs N] [--threshold PCT] [--update] \
+#                     <bench_game> <baseline.json>
+#
+# Only uses core Perl modules.
+
+use strict;
+use warnings;
+
+use JSON::PP;
+use Getopt::Long;
+
+# Benchmarks that gate the build.  (The per-depth level generation
+# times are too short to be steady; newcavelevel.all covers them.)
+my $HOT = qr/^(?:movemonst\.|fov\.|savegame\.|stash_game_state$|newcavelevel\.all$)/;
+
+my $runs = 5;
+my $threshold;          # Percent; defaults to the baseline's or 25
+my $update = 0;
+
+GetOptions('runs=i'      => \$runs,
+           'threshold=f' => \$threshold,
+           'update'      => \$update)
+    && @ARGV == 2
+    || die "usage: $0 [--runs N] [--threshold PCT] [--update] "
+         . "<bench_game> <baseline.json>\n";
+my ($driver, $baseline_file) = @ARGV;
+
+
+sub median {
+    my @s = sort { $a <=> $b } @_;
+    my $mid = int(@s / 2);
+    return @s % 2 ? $s[$mid] : ($s[$mid - 1] + $s[$mid]) / 2;
+}
+
+
+# Run the driver and collect the samples.
+my %samples;
+open(my $out, '-|', $driver, '-r', $runs) or die "Can't run $driver: $!\n";
+while (<$out>) {
+    push @{ $samples{$1} }, $2 if /^bench (\S+) .*\bus_per_iter=([\d.]+)/;
+}
+close($out) or die "$driver failed (status $?)\n";
+die "$driver produced no results\n" unless %samples;
+
+my %current;
+for my $name (keys %samples) {
+    my @s = @{ $samples{$name} };
+    my $med = median(@s);
+    $current{$name} = {
+        median_us   => sprintf("%.3f", $med) + 0,
+        mad_us      => sprintf("%.3f", median(map { abs($_ - $med) } @s)) + 0,
+        runs        => scalar @s,
+    };
+}
+
+
+my $json = JSON::PP->new->canonical->pretty;
+
+if ($update) {
+    open(my $fh, '>', $baseline_file) or die "Can't write $baseline_file: $!\n";
+    print $fh $json->encode({
+        threshold_pct   => $threshold // 25,
+        benchmarks      => \%current,
+    });
+    close($fh);
+    print "Wrote baseline for ", scalar(keys %current), " benchmarks to ",
+        "$baseline_file\n";
+    exit 0;
+}
+
+open(my $fh, '<', $baseline_file) or die "Can't read $baseline_file: $!\n";
+my $baseline = $json->decode(do { local $/; <$fh> });
+close($fh);
+
+$threshold //= $baseline->{threshold_pct} // 25;
+my $base = $baseline->{benchmarks};
+
+
+# Compare.  A benchmark has to be slower by more than the threshold
+# *and* by more than three times the combined MAD (i.e. the noise in
+# the two measurements) to count as a regression.
+my (@failures, @new, @missing);
+printf "%-24s %12s %12s %8s %7s  %s\n",
+    "benchmark", "baseline us", "current us", "change", "limit", "status";
+
+my %all = map { $_ => 1 } keys %current, keys %$base;
+for my $name (sort keys %all) {
+    my ($b, $c) = ($base->{$name}, $current{$name});
+    my $hot = $name =~ $HOT;
+
+    if (!$c) {
+        printf "%-24s %12.3f %12s %8s %7s  %s\n", $name, $b->{median_us},
+            "-", "", "", "missing";
+        push @missing, $name;
+        next;
+    }
+    if (!$b) {
+        printf "%-24s %12s %12.3f %8s %7s  %s\n", $name, "-",
+            $c->{median_us}, "", "", "new";
+        push @new, $name;
+        next;
+    }
+
+    my $change = ($c->{median_us} - $b->{median_us}) / $b->{median_us} * 100;
+    my $noise = 3 * ($c->{mad_us} + $b->{mad_us}) / $b->{median_us} * 100;
+    my $limit = $noise > $threshold ? $noise : $threshold;
+
+    my $status = "ok";
+    if ($change > $limit) {
+        $status = $hot ? "REGRESSED" : "slower";
+        push @failures, $name if $hot;
+    } elsif ($change < -$limit) {
+        $status = "faster";
+    }
+
+    printf "%-24s %12.3f %12.3f %+7.1f%% %6.1f%%  %s\n", $name,
+        $b->{median_us}, $c->{median_us}, $change, $limit, $status;
+}
+
+print "\n";
+print "Not in the baseline: ", join(", ", @new), "\n" if @new;
+print "Not run any more: ", join(", ", @missing), "\n" if @missing;
+print "(Regenerate the baseline with --update.)\n" if @new || @missing;
+
+if (@failures) {
+    print "FAILED: ", scalar(@failures), " hot path(s) regressed: ",
+        join(", ", @failures), "\n";
+    exit 1;
+}
+
+print "OK: no hot path regressed by more than $threshold% ($runs runs)\n";
+exit 0;
@@ -0,0 +1,208 @@
+// This file is part of ReLarn; Copyright (C) 1986 - 2023; GPLv2; NO WARRANTY!
+// See Copyright.txt, LICENSE.txt and AUTHORS.txt for terms.
+
+// Stress test for concurrent scoreboard access.  Forks several
+// writer processes calling newscore() and reader processes calling
+// write_scores() on a scratch scoreboard, and checks that every
+// entry a reader sees is intact, that entries are in score order and
+// that readers never see the board shrink.  Unix only.
+//
+// The scratch scoreboard is deleted afterward unless something
+// failed, in which case it's kept for a look.
+
+#define _XOPEN_SOURCE 700   // For nftw()
+
+#include "game_context.h"
+#include "score_file.h"
+#include "player.h"
+#include "os.h"
+#include "util.h"
+
+#include <ftw.h>
+#include <limits.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+
+#define WRITERS         4
+#define SCORES_EACH     1500
+#define READERS         4
+
+static char Root[] = "/tmp/relarn-stress-XXXXXX";
+
+
+// Add SCORES_EACH scores as writer 'id'.  Every field is derived
+// from the score so readers can check that the entry is intact.
+static void
+writer(int id) {
+    srandom(getpid());
+    snprintf(UU.name, sizeof(UU.name), "W%d", id);
+
+    for (int n = 0; n < SCORES_EACH; n++) {
+        long score = random() % 1000000;
+        char ending[40];
+        snprintf(ending, sizeof(ending), "e%ld.%d", score, id);
+
+        UU.level = score % 50;
+        UU.challenge = score % 10;
+
+        if (!newscore(score, score % 3 == 0, score % 16, ending, &UU)) {
+            fprintf(stderr, "writer %d: newscore() failed\n", id);
+            exit(1);
+        }// if
+    }// for
+
+    exit(0);
+}// writer
+
+
+// Export the board and check it.  Returns the number of entries or
+// -1 if something was wrong.
+static long
+check_board(int id) {
+    char path[200];
+    snprintf(path, sizeof(path), "%s/export-%d.tsv", Root, id);
+    if (!write_scores(path)) {
+        fprintf(stderr, "reader %d: write_scores() failed\n", id);
+        return -1;
+    }// if
+
+    FILE *fh = fopen(path, "r");
+    ENSURE_MSG(fh, "Can't read export.");
+
+    long count = 0, last = LONG_MAX;
+    char line[300];
+    while (fgets(line, sizeof(line), fh)) {
+        if (line[0] == '#') { continue; }
+
+        char who[40], gender[20], cclass[40], won[20], ending[100];
+        long score;
+        int skill, floor, exp;
+        int nf = sscanf(line, "%39[^\t]\t%19[^\t]\t%39[^\t]\t%ld\t%19[^\t]"
+                        "\t%d\t%d\t%d\t%99[^\t\n]",
+                        who, gender, cclass, &score, won, &skill, &floor,
+                        &exp, ending);
+
+        int writer_id = -1;
+        char expected[100] = "";
+        if (nf == 9 && sscanf(who, "W%d", &writer_id) == 1) {
+            snprintf(expected, sizeof(expected), "e%ld.%d", score, writer_id);
+        }
+
+        bool ok = nf == 9 &&
+            streq(ending, expected) &&
+            skill == score % 10 + 1 &&
+            floor == score % 16 &&
+            exp == score % 50 &&
+            streq(won, score % 3 == 0 ? "won" : "failed") &&
+            score <= last;
+
+        if (!ok) {
+            fprintf(stderr, "reader %d: bad entry: %s", id, line);
+            fclose(fh);
+            return -1;
+        }// if
+
+        last = score;
+        ++count;
+    }// while
+
+    fclose(fh);
+    return count;
+}// check_board
+
+
+// Check the board repeatedly until the writers are done (signalled
+// by 'donefile' existing), then once more.
+static void
+reader(int id, const char *donefile) {
+    long prev = 0;
+    int passes = 0;
+
+    for (bool last = false; !last; ++passes) {
+        last = access(donefile, F_OK) == 0;
+
+        long count = check_board(id);
+        if (count < 0) { exit(1); }
+        if (count < prev) {
+            fprintf(stderr, "reader %d: board shrank from %ld to %ld\n",
+                    id, prev, count);
+            exit(1);
+        }// if
+        prev = count;
+
+        get_taxes_owed();
+    }// for
+
+    printf("reader %d: %d passes, last saw %ld entries\n", id, passes, prev);
+    exit(prev == WRITERS * SCORES_EACH ? 0 : 1);
+}// reader
+
+
+static int
+remove_entry(const char *path, const struct stat *sb, int flag,
+             struct FTW *ftwbuf) {
+    return remove(path);
+}// remove_entry
+
+
+int
+main(int argc, char *argv[]) {
+    ENSURE_MSG(mkdtemp(Root), "Unable to create scratch directory.");
+
+    char path[200];
+    snprintf(path, sizeof(path), "%s/var", Root);
+    mkdir(path, 0700);
+    snprintf(path, sizeof(path), "%s/var/relarn", Root);
+    mkdir(path, 0700);
+
+    setenv("RELARN_INSTALL_ROOT", Root, 1);
+    setenv("HOME", Root, 1);
+
+    init_os(argv[0]);
+    ensureboard();
+
+    // The writers fill in UU, so they need a game context.  (The
+    // children inherit this one.)
+    gc_bind(gc_new());
+
+    char donefile[200];
+    snprintf(donefile, sizeof(donefile), "%s/done", Root);
+
+    uint64_t start = monotonic_usec();
+
+    pid_t readers[READERS], writers[WRITERS];
+    for (int n = 0; n < READERS; n++) {
+        if ((readers[n] = fork()) == 0) { reader(n, donefile); }
+    }
+    for (int n = 0; n < WRITERS; n++) {
+        if ((writers[n] = fork()) == 0) { writer(n); }
+    }
+
+    int failures = 0, status;
+    for (int n = 0; n < WRITERS; n++) {
+        waitpid(writers[n], &status, 0);
+        failures += !WIFEXITED(status) || WEXITSTATUS(status) != 0;
+    }// for
+
+    fclose(fopen(donefile, "w"));
+
+    for (int n = 0; n < READERS; n++) {
+        waitpid(readers[n], &status, 0);
+        failures += !WIFEXITED(status) || WEXITSTATUS(status) != 0;
+    }// for
+
+    printf("stress_scores: %d writers x %d scores, %d readers, "
+           "%.2f s, %d failure(s)\n",
+           WRITERS, SCORES_EACH, READERS, (monotonic_usec() - start) / 1e6,
+           failures);
+
+    if (failures) {
+        printf("stress_scores: scratch files kept in %s\n", Root);
+        return 1;
+    }// if
+
+    nftw(Root, remove_entry, 16, FTW_DEPTH | FTW_PHYS);
+    return 0;
+}// main
@@ -0,0 +1,129 @@
+// This file is part of ReLarn; Copyright (C) 1986 - 2023; GPLv2; NO WARRANTY!
+// See Copyright.txt, LICENSE.txt and AUTHORS.txt for terms.
+
+// Headless replacement for ui.c, for benchmarks.  Linked instead of
+// ui.o so that game code can run without a terminal and without
+// curses output skewing the timings.  Drawing does nothing and every
+// prompt returns the same answer as cancelling or pressing ESC would
+// unless an input function has been installed (see ui_headless.h).
+
+#include "ui_headless.h"
+
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+
+#define ESC '\033'
+
+static __thread headless_input_fn InputFn = NULL;
+static __thread void *InputArg = NULL;
+
+void
+headless_set_input(headless_input_fn fn, void *arg) {
+    InputFn = fn;
+    InputArg = arg;
+}// headless_set_input
+
+// Return the next key from the input function or ESC if there isn't
+// one.
+static char
+next_key(enum HEADLESS_INPUT what) {
+    return InputFn ? InputFn(what, InputArg) : ESC;
+}// next_key
+
+
+void init_ui() {}
+void teardown_ui() {}
+void sync_ui(bool force) {}
+void render_stats_end_turn(long turn) {}
+bool toggle_render_overlay() { return false; }
+
+char map_getch() { return next_key(HI_COMMAND); }
+
+void showstats(bool iswiz, bool force) {}
+void mapdraw(int x, int y, char symbol, enum MAPFLAGS flags, bool isFoV,
+             bool isTown) {}
+void show_indicators(bool force) {}
+
+void say(const char *fmt, ...) {}
+void billboard(bool center, const char *heading, ...) {}
+void scroll_back() {}
+void scroll_forward() {}
+void nap(int x) {}
+void headsup() {}
+
+
+// Errors are worth seeing, even here.
+void
+notify(const char *fmt, ...) {
+    va_list ap;
+    va_start(ap, fmt);
+    vfprintf(stderr, fmt, ap);
+    va_end(ap);
+}// notify
+
+
+char menu(const char *heading, const char* items) {
+    return next_key(HI_PROMPT);
+}
+
+void showpages(struct TextBuffer *tb) {}
+bool showpages_prompt(struct TextBuffer *tb, bool prompt) { return false; }
+bool pick_item(struct PickList *tb, const char *heading, int *id) {
+    return false;
+}
+int pick_multi(struct PickList *pl, const char *heading, int **ids,
+               bool multi) {
+    return 0;
+}
+
+bool get_player_type(char *name, size_t namesz, enum CHAR_CLASS *cclass,
+                     enum GENDER *gender, enum GENDER *spouse) {
+    return false;
+}
+
+char prompt(const char *question) { return next_key(HI_PROMPT); }
+bool confirm(const char *question) { return next_key(HI_CONFIRM) == 'y'; }
+bool stringPrompt(const char *question, char *result, size_t maxSize) {
+    if (maxSize > 0) { result[0] = 0; }
+    return false;
+}
+long numPrompt(const char *question, long defaultValue, long max) {
+    return defaultValue;
+}
+long numPromptAll(const char *question, long defaultValue, long min, long max,
+                  bool *success) {
+    *success = false;
+    return defaultValue;
+}
+void promptToContinue() {}
+
+char quickinv(const char *action, const char *candidates, bool dashForNone,
+              bool allowGold) {
+    if (!InputFn) { return 0; }
+
+    // Like the real one but an invalid key cancels instead of asking
+    // again.
+    char key = next_key(HI_ITEM);
+    if ((allowGold && key == '.') || (dashForNone && key == '-') ||
+        (key && strchr(candidates, key)))
+    {
+        return key;
+    }// if
+    return 0;
+}
+
+DIRECTION
+promptdir(bool allowCancel) {
+    switch (next_key(HI_DIRECTION)) {
+    case 'h': return DIR_WEST;
+    case 'l': return DIR_EAST;
+    case 'j': return DIR_SOUTH;
+    case 'k': return DIR_NORTH;
+    case 'u': return DIR_NORTHEAST;
+    case 'y': return DIR_NORTHWEST;
+    case 'n': return DIR_SOUTHEAST;
+    case 'b': return DIR_SOUTHWEST;
+    default:  return DIR_CANCEL;
+    }// switch
+}// promptdir
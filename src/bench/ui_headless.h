@@ -0,0 +1,32 @@
+// This file is part of ReLarn; Copyright (C) 1986 - 2023; GPLv2; NO WARRANTY!
+// See Copyright.txt, LICENSE.txt and AUTHORS.txt for terms.
+
+// Extensions to ui.h provided by the headless UI (ui_headless.c).
+//
+// By default the headless UI answers every request for input as if
+// the user had pressed ESC.  A program can instead install an input
+// function that supplies the keys, e.g. to let a bot play the game.
+// The input function is per-thread so each thread can drive its own
+// game.
+
+#ifndef HDR_GUARD_UI_HEADLESS_H
+#define HDR_GUARD_UI_HEADLESS_H
+
+#include "ui.h"
+
+// What the game is asking for
+enum HEADLESS_INPUT {
+    HI_COMMAND,         // A command at the map (map_getch())
+    HI_PROMPT,          // An answer to a question (prompt(), menu())
+    HI_CONFIRM,         // 'y' or anything else (confirm())
+    HI_DIRECTION,       // A direction key (promptdir())
+    HI_ITEM,            // An inventory letter (quickinv())
+};
+
+typedef char (*headless_input_fn)(enum HEADLESS_INPUT what, void *arg);
+
+// Install 'fn' as the current thread's source of keys; 'arg' is
+// passed to it.  NULL restores the default.
+void headless_set_input(headless_input_fn fn, void *arg);
+
+#endif
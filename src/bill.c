@@ -6,6 +6,7 @@
 #include "internal_assert.h"
 #include "stringbuilder.h"
 #include "text_template.h"
+#include "arena.h"
 #include "game.h"
 #include "settings.h"
 #include "os.h"
@@ -67,7 +68,9 @@ write_emails() {
     // It turns out that neomutt (and other clients?) use the date
     // in the separator line as the message date, so we put the
     // date here as well.
+    struct ArenaMark scope = arena_mark();
     char *sep = text_expand("From RELARN ${date}", &UU);
+    struct ArenaMark msgScope = arena_mark();
 
     for (int n = 0; n < num_templates; n++) {
         // Player always gets the first two in normal play; the rest
@@ -77,10 +80,11 @@ write_emails() {
         // Print mbox separator
         int count1 = fprintf(fh, "%s\n", sep);
 
-        // And print the message
+        // And print the message.  (Give back each one's space once
+        // it's written; they add up.)
         char *msg = text_expand(templates[n], &UU);
         int count2 = fprintf(fh, "%s\n", msg);
-        free(msg);
+        arena_release(msgScope);
 
         // Track if anything fails
         status = status && count1 >= 0 && count2 >= 0;
@@ -89,8 +93,7 @@ write_emails() {
     unlock_file(fh);
     fclose(fh);
 
-    free(sep);
-
+    arena_release(scope);
     return status;
 }// write_emails
 
@@ -11,6 +11,7 @@
 #include "game.h"
 #include "gender.h"
 #include "ui.h"
+#include "trace.h"
 
 #include <limits.h>
 
@@ -118,7 +119,7 @@ spelldamage(enum SPELL spell) {
     if (spell >= SPNUM)
         return;     /* no such spell */
 
-    if (UU.timestop) {
+    if (effect_left(EFF_TIMESTOP)) {
         say("It didn't seem to work.\n");
         return;
     }           /* not if time stopped */
@@ -138,7 +139,7 @@ spelldamage(enum SPELL spell) {
 
     case CPROT:
         say("You feel safer.\n");
-        UU.protectionTime += 250;
+        effect_add(EFF_PROTECTION, 250);
         return;
 
     case CMMISSILE: {    /* magic missile */
@@ -151,7 +152,7 @@ spelldamage(enum SPELL spell) {
 
     case CDEX:     /* dexterity     */
         say("You feel a little lighter on your feet.\n");
-        UU.dexCount += 400;
+        effect_add(EFF_DEXCOUNT, 400);
         return;
 
     case CSLEEP: {    /* sleep     */
@@ -166,7 +167,7 @@ spelldamage(enum SPELL spell) {
 
     case CCHARM:     /* charm monster */
         say("You feel %s.\n", pretty(UU.gender));
-        UU.charmcount += charisma() * 2;
+        effect_add(EFF_CHARM, charisma() * 2);
         return;
 
     case CSSPEAR:     /* sonic spear */
@@ -184,7 +185,7 @@ spelldamage(enum SPELL spell) {
 
     case CSTR:
         say("Everything feels a little lighter.\n");
-        UU.strcount += 150 + rnd(100);
+        effect_add(EFF_STRCOUNT, 150 + rnd(100));
         return;
 
     case CENLIGHTEN:
@@ -197,10 +198,10 @@ spelldamage(enum SPELL spell) {
         return;
 
     case CCBLIND:        /* cure blindness    */
-        say("%s\n", UU.blindCount  ?
+        say("%s\n", effect_left(EFF_BLIND)  ?
             "You can see again." :
             "Your eyes feel rested but nothing else has changed.");
-        UU.blindCount = 0;
+        effect_set(EFF_BLIND, 0);
         return;
 
     case CCREATEMON:
@@ -219,16 +220,16 @@ spelldamage(enum SPELL spell) {
 
     case CINV: {
         say("You %s yourself turning%s transparent.\n",
-            UU.blindCount ? "feel" : "see",
-            UU.invisibility ? " slightly more" : "");
+            effect_left(EFF_BLIND) ? "feel" : "see",
+            effect_left(EFF_INVISIBILITY) ? " slightly more" : "");
 
-        UU.invisibility += 12;
+        effect_add(EFF_INVISIBILITY, 12);
 
         // If they have the amulet of invisibility, then add more time.
         int idx = index_of_first(OAMULET);
         if (idx >= 0) {
             int extra = 1 + Invent[idx].iarg;
-            UU.invisibility += extra << 7;
+            effect_add(EFF_INVISIBILITY, extra << 7);
         }// if
 
         return;
@@ -251,12 +252,12 @@ spelldamage(enum SPELL spell) {
 
     case CCANCEL:      /* cancellation  */
         say("Colors fade for a brief moment.\n");
-        UU.cancellation += 5 + UU.level;
+        effect_add(EFF_CANCELLATION, 5 + UU.level);
         return;
 
     case CHASTE:        /* haste self    */
         say("The world seems to slow down.\n");
-        UU.hasteSelf += 7 + UU.level;
+        effect_add(EFF_HASTESELF, 7 + UU.level);
         return;
 
     case CCLOUD:        /* cloud kill */
@@ -292,11 +293,11 @@ spelldamage(enum SPELL spell) {
     }
 
     case CINVULN: {
-        bool new_globe = UU.globe == 0;
+        bool new_globe = effect_left(EFF_GLOBE) == 0;
         say("Your head hurts as %s transparent globe %s around you.\n",
             new_globe ? "a" : "the",
             new_globe ? "forms" : "strengthens");
-        UU.globe += 200;
+        effect_add(EFF_GLOBE, 200);
         loseint();  /* globe of invulnerability */
         return;
     }
@@ -325,23 +326,24 @@ spelldamage(enum SPELL spell) {
 
     case CSCAREMON: {        /* scare monster */
         say("You feel incredibly badass!\n");
-        UU.scaremonst += rnd(10) + UU.level;
+        effect_add(EFF_SCAREMONST, rnd(10) + UU.level);
 
         /* if have HANDofFEAR make last longer */
         if (has_a(OHANDofFEAR)) {
-            UU.scaremonst *= 3;
+            effect_set(EFF_SCAREMONST,
+                       3 * (int64_t)effect_left(EFF_SCAREMONST));
         }/* if */
         return;
     }
 
     case CHOLDMON:        /* hold monster */
         say("The cave becomes eerily quiet.\n");
-        UU.holdmonst += rnd(10) + UU.level;
+        effect_add(EFF_HOLDMONST, rnd(10) + UU.level);
         return;
 
     case CTIMESTOP:
         say("\"Time stand still...\"\n");
-        UU.timestop += rnd(20) + (UU.level << 1);
+        effect_add(EFF_TIMESTOP, rnd(20) + (UU.level << 1));
         return;     /* time stop */
 
     case CTELEPORT:        /* teleport */
@@ -400,7 +402,7 @@ spelldamage(enum SPELL spell) {
 
     case CWALLWALK:        /* walk through walls */
         say("You feel phase-modulated.\n");
-        UU.wtw += rnd(10) + 5;
+        effect_add(EFF_WTW, rnd(10) + 5);
         return;
 
     case CALTER_REALITY:        /* alter reality */
@@ -439,13 +441,56 @@ loseint() {
  */
 static int
 isconfuse() {
-    if (UU.confuse) {
+    if (effect_left(EFF_CONFUSE)) {
         say("You can't aim your magic!\n");
         headsup();
     }
-    return (UU.confuse);
+    return (effect_left(EFF_CONFUSE));
 }
 
+// Spell immunities, expanded from spell_immunities.h at compile time.
+// ImmuneMask[m] has bit s set if monster m is immune to spell s, and
+// ImmuneMsg[m][s] is then the index into ImmunityMsgs[] of what gets
+// said about it.
+#include "spell_immunities.h"
+
+enum IMMUNITY_MSG_ID {
+    IM_NONE,
+#define MSG(id, text) id,
+    SPELL_IMMUNITY_MESSAGES(MSG)
+#undef MSG
+};
+
+static const char *const ImmunityMsgs[] = {
+    NULL,
+#define MSG(id, text) text,
+    SPELL_IMMUNITY_MESSAGES(MSG)
+#undef MSG
+};
+
+// Listing a monster/spell pair twice is an error.
+#pragma GCC diagnostic push
+#pragma GCC diagnostic error "-Woverride-init"
+static const uint8_t ImmuneMsg[NUM_MONSTERS][SPNUM] = {
+#define IMM(unused, mon, spell, msg) [mon][spell] = msg,
+    SPELL_IMMUNITIES(IMM, 0)
+#undef IMM
+};
+#pragma GCC diagnostic pop
+
+_Static_assert(SPNUM <= 64, "Too many spells for ImmuneMask.");
+
+// Each monster's entry ORs together the bits of every list entry
+// that names it.
+static const uint64_t ImmuneMask[NUM_MONSTERS] = {
+#define IMM(this, mon, spell, msg) | ((mon) == (this) ? 1ull << (spell) : 0)
+#define MONSTER(id,sym,lv,ac,dmg,attack,int,gold,hp,exp,flags,longdesc) \
+    [id] = 0 SPELL_IMMUNITIES(IMM, id),
+#include "monster_list.h"
+#undef MONSTER
+#undef IMM
+};
+
 /*
  * Subroutine to return 1 if the spell can't affect the monster
  * otherwise returns 0. Enter with the spell number in 'spell', and
@@ -453,46 +498,15 @@ isconfuse() {
  */
 static int
 nospell(enum SPELL spell, int monst) {
-    static const char *spellEffects[LAST_MONSTER+1][SPNUM];
-    static bool spellEffectsInitialized = false;
-    const char *msg;
-
     /* bad spell or monst */
     ASSERT(spell < SPNUM && monst <= LAST_MONSTER && monst > 0 && spell >= 0);
 
-    /* The first time nospell is called, we initialize spellEffects
-     * from the data in spell_immunities.h. */
-    if (!spellEffectsInitialized) {
-        struct {
-            const char *msg;
-            struct {
-                enum MONSTER_ID mon;
-                enum SPELL spell;
-            } imm[120];
-        } mondesc[] = {
-#           include "spell_immunities.h"
-        };
-        int n, i;
-
-        for (n = 0; mondesc[n].msg; n++) {
-            for (i = 0; mondesc[n].imm[i].mon; i++) {
-                int mon   = mondesc[n].imm[i].mon;
-                int spell = mondesc[n].imm[i].spell;
-
-                ASSERT (mon <= LAST_MONSTER && spell < SPNUM);
-                spellEffects[mon][spell] = mondesc[n].msg;
-            }/* for */
-        }/* for */
-
-        spellEffectsInitialized = true;
-    }/* if */
-
-    msg = spellEffects[monst][spell];
-    if (!msg) {
+    if (!(ImmuneMask[monst] & (1ull << spell))) {
         return (0);
     }/* if */
 
-    say(msg, monname(monst));
+    ASSERT(ImmuneMsg[monst][spell] != IM_NONE);
+    say(ImmunityMsgs[ImmuneMsg[monst][spell]], monname(monst));
     say("\n");
     return (1);
 }/* nospell*/
@@ -507,8 +521,8 @@ nospell(enum SPELL spell, int monst) {
  * str, the # of milliseconds to delay between locations in delay, and the
  * character to represent the weapon in cshow.
  */
-void
-godirect(enum SPELL spnum, int dam, char *str, int delay, char cshow) {
+static void
+godirect_path(enum SPELL spnum, int dam, char *str, int delay, char cshow) {
     int8_t x, y;
     int8_t dx, dy;
 
@@ -528,15 +542,18 @@ godirect(enum SPELL spnum, int dam, char *str, int delay, char cshow) {
     x = UU.x;
     y = UU.y;
 
+    // Steps left before the bolt leaves the map.  Whatever changes x
+    // or y below must keep this up to date.
+    int left = ray_length(x, y, dx, dy);
+
     while (dam > 0) {
+        if (left-- == 0) {
+            break;  /* out of bounds */
+        }// if
+
         x += dx;
         y += dy;
 
-        if (!inbounds(x, y)) {
-            dam = 0;
-            break;  /* out of bounds */
-        }
-
         /* if energy hits player */
         if ((x == UU.x) && (y == UU.y)) {
             say("You are hit by your own magic!\n");
@@ -546,7 +563,7 @@ godirect(enum SPELL spnum, int dam, char *str, int delay, char cshow) {
         }
 
         /* if not blind show effect */
-        if (UU.blindCount == 0) {
+        if (effect_left(EFF_BLIND) == 0) {
             flash_at(x, y, cshow, delay);
         }/* if */
 
@@ -559,6 +576,7 @@ godirect(enum SPELL spnum, int dam, char *str, int delay, char cshow) {
                 /* cannot cast a missile spell at the demon king!! */
                 dx *= -1;
                 dy *= -1;
+                left = ray_length(x, y, dx, dy);
                 say("The %s returns your puny missile!\n", monname_mon(mon));
             } else {
                 if (nospell(spnum, mon.id)) {
@@ -572,15 +590,14 @@ godirect(enum SPELL spnum, int dam, char *str, int delay, char cshow) {
                 nap(1000);
                 x -= dx;
                 y -= dy;
+                left++;
             }// if .. else
 
         } else {
 
             /* If there's an object here, we may interact with it... */
 
-            //it = &at(x, y)->obj.type;
-            struct Object *it = &at(x, y)->obj;
-            switch (it->type) {
+            switch (at(x, y)->obj.type) {
             case OWALL:
                 say(str, "wall");
 
@@ -591,7 +608,7 @@ godirect(enum SPELL spnum, int dam, char *str, int delay, char cshow) {
                     x < MAXX - 1 && y < MAXY - 1 && x > 0 && y > 0)
                 {
                     say(" The wall crumbles.\n");
-                    *it = NULL_OBJ;
+                    set_obj_at(x, y, NULL_OBJ);
                 }// if
 
                 say("\n");
@@ -602,7 +619,7 @@ godirect(enum SPELL spnum, int dam, char *str, int delay, char cshow) {
                 say(str, "door");
                 if (dam >= 40) {
                     say(" The door is blasted apart.");
-                    *it = NULL_OBJ;
+                    set_obj_at(x, y, NULL_OBJ);
                 }
                 say("\n");
                 dam = 0;
@@ -616,7 +633,7 @@ godirect(enum SPELL spnum, int dam, char *str, int delay, char cshow) {
                         break;
                     }/* if */
                     say(" The statue crumbles.");
-                    *it = obj(OBOOK, getlevel());
+                    set_obj_at(x, y, obj(OBOOK, getlevel()));
                 }/* if */
                 say("\n");
                 dam = 0;
@@ -626,7 +643,7 @@ godirect(enum SPELL spnum, int dam, char *str, int delay, char cshow) {
                 say(str, "throne");
                 if (dam > 33) {
                     at(x, y)->mon = mk_mon(GNOMEKING);
-                    *it = obj(OTHRONE2, 0);
+                    set_obj_at(x, y, obj(OTHRONE2, 0));
                 }
                 say("\n");
                 dam = 0;
@@ -635,6 +652,7 @@ godirect(enum SPELL spnum, int dam, char *str, int delay, char cshow) {
             case OMIRROR:
                 dx *= -1;
                 dy *= -1;
+                left = ray_length(x, y, dx, dy);
                 break;
 
                 /* Most buildings just absorb the attack harmlessly */
@@ -655,6 +673,7 @@ godirect(enum SPELL spnum, int dam, char *str, int delay, char cshow) {
 
                 dx *= -1;
                 dy *= -1;
+                left = ray_length(x, y, dx, dy);
                 dam *= 2;
                 break;
 
@@ -673,12 +692,22 @@ godirect(enum SPELL spnum, int dam, char *str, int delay, char cshow) {
         }/* if .. else*/
 
         // The missile lights the way...
-        if (UU.blindCount == 0) {
+        if (effect_left(EFF_BLIND) == 0) {
             see_and_update_at(x, y);
         }// if
 
         dam -= 3 + (int) (UU.challenge >> 1);
     }// while
+}/* godirect_path*/
+
+
+// Fire the bolt; see godirect_path() for details.  The animation
+// can take a while so we trace it.
+void
+godirect(enum SPELL spnum, int dam, char *str, int delay, char cshow) {
+    trace_begin("godirect");
+    godirect_path(spnum, dam, str, delay, cshow);
+    trace_end("godirect");
 }/* godirect*/
 
 
@@ -743,7 +772,7 @@ makewall() {
     }// if
 
     // Okay, we can proceed
-    at(x, y)->obj = obj(OWALL, 0);
+    set_obj_at(x, y, obj(OWALL, 0));
     say("Rock appears out of thin air.\n");
 }/* makewall*/
 
@@ -762,7 +791,7 @@ vaporizerock() {
             case OWALL:
                 /* can't vpr below V2 */
                 if (getlevel() < VBOTTOM-2) {
-                    pt->obj = NULL_OBJ;
+                    set_obj_at(x, y, NULL_OBJ);
                 }/* if */
                 break;
 
@@ -770,12 +799,12 @@ vaporizerock() {
                 if (UU.challenge > 3 && rnd(60) < 30) {
                     break;
                 }/* if */
-                pt->obj = obj (OBOOK, getlevel());
+                set_obj_at(x, y, obj(OBOOK, getlevel()));
                 break;
 
             case OTHRONE:
                 pt->mon = mk_mon(GNOMEKING);
-                pt->obj = obj(OTHRONE2, 0);
+                set_obj_at(x, y, obj(OTHRONE2, 0));
                 break;
 
             case OALTAR:
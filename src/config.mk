@@ -6,6 +6,24 @@
 # this if you're developing or debugging.
 #ASSERT_CFLAGS = -DDISABLE_ASSERT=1
 
+# Comment out this line to compile out the per-turn profiler (see
+# profile.h).  It's cheap but not free.
+PROFILE_CFLAGS = -DTURN_PROFILE=1
+
+# Uncomment this line to count heap allocations by call site (see
+# allocstats.h).  It slows down every allocation, so it's only for
+# tracking down allocation churn and leaks.  Do a 'make clean' after
+# changing it.
+#ALLOC_STATS_CFLAGS = -DALLOC_STATS=1
+
+# Uncomment these lines to count the bytes sent to the terminal for
+# the render statistics (see curses_extensions_ncurses.c).  Every
+# write() in the program then goes through a wrapper, so it's only
+# for measuring display traffic.  Only works on linux-x86, where
+# ncurses is linked statically.  Do a 'make clean' after changing it.
+#TTY_BYTES_CFLAGS = -DTTY_WRITE_WRAPPED=1
+#TTY_BYTES_LDFLAGS = -Wl,--wrap=write
+
 # Set this to a PDCurses checkout with the sdl2 target built with
 # WIDE=Y (or pass it to make as an argument).
 #PDCURSES=../../relarn-pdcurses/
@@ -17,6 +17,7 @@ void setup_curses_extensions(void);
 void setup_unseen_area_colors(short lightpair, short darkpair);
 
 void show_notification_msg(const char *msg);
+long tty_bytes_written(void);
 //bool is_tty(void);    // Moved to ui.h
 
 #endif
@@ -9,6 +9,7 @@
 // (i.e. #ifdef's) we in the code.
 
 #include <stdlib.h>
+#include <unistd.h>
 #include <curses.h>
 
 // Sanity check; ensure we're using ncurses
@@ -45,3 +46,40 @@ show_notification_msg(const char *msg) {
 
 // ncurses is always tty-based
 bool is_tty() { return true; }
+
+
+// Count the bytes ncurses sends to the terminal.  When the build
+// links with '-Wl,--wrap=write' (TTY_BYTES_LDFLAGS in config.mk; it
+// needs ncurses linked statically), every call to write() inside
+// ncurses lands here first so we can tally up what goes to stdout.
+// This is used by the render statistics in ui.c to measure actual
+// (e.g. ssh) traffic.  Other threads (level builders, the
+// simulators' workers) write too, hence the atomic.
+#ifdef TTY_WRITE_WRAPPED
+
+#include <stdatomic.h>
+
+ssize_t __real_write(int fd, const void *buf, size_t count);
+
+static _Atomic long TtyBytes = 0;
+
+ssize_t
+__wrap_write(int fd, const void *buf, size_t count) {
+    ssize_t result = __real_write(fd, buf, count);
+    if (fd == STDOUT_FILENO && result > 0) {
+        atomic_fetch_add_explicit(&TtyBytes, result, memory_order_relaxed);
+    }
+    return result;
+}// __wrap_write
+
+long
+tty_bytes_written() {
+    return atomic_load_explicit(&TtyBytes, memory_order_relaxed);
+}// tty_bytes_written
+
+#else
+
+// Not available in this build.
+long tty_bytes_written() { return -1; }
+
+#endif
@@ -153,3 +153,6 @@ show_notification_msg(const char *msg) {
 
 // PDCurses is always GUI-based
 bool is_tty() { return false; }
+
+// There's no terminal, so there's nothing to count.
+long tty_bytes_written() { return -1; }
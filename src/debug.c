@@ -11,6 +11,8 @@
 #include "diag.h"
 #include "bill.h"
 #include "action.h"
+#include "profile.h"
+#include "allocstats.h"
 
 #include <limits.h>
 
@@ -42,6 +44,9 @@ enum DBG_CMD {
     DC_LEVELUP,
     DC_DIAG,
     DC_MAIL,
+    DC_RENDERSTATS,
+    DC_PROFILE,
+    DC_ALLOCSTATS,
     DC_NOTHING,
 };
 
@@ -63,7 +68,7 @@ db_makeobjs () {
          obj_id < OBJ_CONCRETE_COUNT;
          x += xi, y += yi, obj_id++) {
 
-        at(x, y)->obj = obj(obj_id, 0);
+        set_obj_at(x, y, obj(obj_id, 0));
 
         if (y >= MAXY - 1 && x == 0) {
             xi = 1;
@@ -105,9 +110,9 @@ gear_up() {
     int slots = inv_slots_free();
     int i;
 
-    if (slots < 1) Invent[0] = NULL_OBJ;
-    if (slots < 2) Invent[1] = NULL_OBJ;
-    if (slots < 3) Invent[2] = NULL_OBJ;
+    if (slots < 1) inv_set(0, NULL_OBJ);
+    if (slots < 2) inv_set(1, NULL_OBJ);
+    if (slots < 3) inv_set(2, NULL_OBJ);
 
     take(obj(OPROTRING,50), "");
     take(obj(OLANCE,25), "");
@@ -236,11 +241,11 @@ static void
 toggle_blindness() {
     const int BLIND_COUNT = 100;
 
-    if (UU.blindCount) {
-        UU.blindCount = 0;
+    if (effect_left(EFF_BLIND)) {
+        effect_set(EFF_BLIND, 0);
         say("Blindness removed.\n");
     } else {
-        UU.blindCount += BLIND_COUNT;
+        effect_add(EFF_BLIND, BLIND_COUNT);
         say("Added %d turns of blindness.\n", BLIND_COUNT);
     }/* if .. else*/
 }/* toggle_blindness*/
@@ -263,25 +268,49 @@ debug_teleport() {
 
 static void
 dbg_allbuffs() {
-    UU.stealth          += 200;
-    UU.undeadpro        += 200;
-    UU.spiritpro        += 200;
-    UU.charmcount       += 200;
-    UU.timestop         += 20;      // Complicates stuff so it's short
-    UU.holdmonst        += 200;
-    UU.giantstr         += 200;
-    UU.fireresistance   += 200;
-    UU.dexCount         += 200;
-    UU.strcount         += 200;
-    UU.scaremonst       += 200;
-    UU.hasteSelf        += 200;
-    UU.cancellation     += 200;
-    UU.invisibility     += 200;
-    UU.altpro           += 200;
-    UU.protectionTime   += 200;
-    UU.wtw              += 200;
+    effect_add(EFF_STEALTH,          200);
+    effect_add(EFF_UNDEADPRO,        200);
+    effect_add(EFF_SPIRITPRO,        200);
+    effect_add(EFF_CHARM,            200);
+    effect_add(EFF_TIMESTOP,         20);     // Complicates stuff so it's short
+    effect_add(EFF_HOLDMONST,        200);
+    effect_add(EFF_GIANTSTR,         200);
+    effect_add(EFF_FIRERESISTANCE,   200);
+    effect_add(EFF_DEXCOUNT,         200);
+    effect_add(EFF_STRCOUNT,         200);
+    effect_add(EFF_SCAREMONST,       200);
+    effect_add(EFF_HASTESELF,        200);
+    effect_add(EFF_CANCELLATION,     200);
+    effect_add(EFF_INVISIBILITY,     200);
+    effect_add(EFF_ALTPRO,           200);
+    effect_add(EFF_PROTECTION,       200);
+    effect_add(EFF_WTW,              200);
 }// dbg_allbuffs
 
+// Display a report (the turn profile or allocation statistics)
+// collected so far.
+static void
+show_report(void (*report)(struct StringBuilder *sb)) {
+    struct StringBuilder *text = sb_alloc();
+    report(text);
+
+    // The pager takes some characters as formatting (see addfmt() in
+    // ui.c) but these are all meant literally.
+    struct StringBuilder *sb = sb_alloc();
+    for (const char *c = sb_str(text); *c; c++) {
+        if (strchr("_|/\\", *c)) { sb_append_char(sb, '\\'); }
+        sb_append_char(sb, *c);
+    }// for
+    sb_free(text);
+
+    struct TextBuffer *tb = tb_malloc(INF_BUFFER, SCREEN_W);
+    tb_append(tb, sb_str(sb));
+    showpages(tb);
+
+    tb_free(tb);
+    sb_free(sb);
+}// show_report
+
 static enum DBG_CMD
 dbg_select() {
     struct PickList *picker;
@@ -310,6 +339,9 @@ dbg_select() {
         {DC_LEVELUP,    "Gain one level."},
         {DC_DIAG,       "Write out a diag file."},
         {DC_MAIL,       "Create the junk mail."},
+        {DC_RENDERSTATS,"Toggle render statistics (wizard mode only)."},
+        {DC_PROFILE,    "Show the turn profile."},
+        {DC_ALLOCSTATS, "Show heap allocation statistics."},
         {DC_NOTHING,    "Do nothing."},
         {0, NULL},
     };
@@ -412,6 +444,19 @@ void debugmenu() {
         if ( !write_emails() ) { say("Error creating junk mail.\n"); }
         break;
 
+    case DC_RENDERSTATS:
+        say("Render statistics %s.\n",
+            toggle_render_overlay() ? "enabled" : "disabled");
+        break;
+
+    case DC_PROFILE:
+        show_report(prof_report);
+        break;
+
+    case DC_ALLOCSTATS:
+        show_report(alloc_report);
+        break;
+
     default:
         return;
     }/* switch*/
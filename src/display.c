@@ -21,23 +21,21 @@
 #include "fov/fov.h"
 
 static void drawscreen(bool);
+static void drawcell(int x, int y, bool in_town);
 
 // Dirty flags for screen update.
-static bool FovChanged = true;
-static bool MapChanged = true;
+#define FovChanged  (GameCtx->fovChanged)
+#define MapChanged  (GameCtx->mapChanged)
+#define NumDirty    (GameCtx->numDirty)
 
 // The grid of squares visible right now
-static bool VisibleMap[MAXX][MAXY];
+#define VisibleMap  (GameCtx->visibleMap)
 
 enum UpdateMode {
     // Note: order is significant
     UM_NOMAP, UM_FOV, UM_FULLMAP, UM_REDRAW_ALL
 };
 
-struct FovRect {
-    int8_t left, right, top, bottom;
-    int8_t radius;
-};
 
 
 static void
@@ -64,11 +62,21 @@ update_display() {
                                            UM_NOMAP;
 
     // monster_detection enforces a full redraw
-    mode = UU.monster_detection > 0 ? UM_FULLMAP : mode;
+    mode = effect_left(EFF_MONSTER_DETECTION) > 0 ? UM_FULLMAP : mode;
+
+    // Single cells queued by see_and_update_at(); a full redraw gets
+    // these anyway.
+    if (mode < UM_FULLMAP) {
+        bool inTown = getlevel() == 0;
+        for (int n = 0; n < NumDirty; n++) {
+            drawcell(GameCtx->dirtyX[n], GameCtx->dirtyY[n], inTown);
+        }// for
+    }// if
 
     perform_update(mode);
 
     FovChanged = MapChanged = false;
+    NumDirty = 0;
 }/* update_display*/
 
 // Redraw the entire display, ignoring the dirty flag.
@@ -76,14 +84,23 @@ void
 redraw() {
     perform_update(UM_REDRAW_ALL);
     FovChanged = MapChanged = false;
+    NumDirty = 0;
 }// redraw
 
+// Update the player's memory of (x, y) and schedule it for redrawing.
+// Cells outside the field of view are queued individually (up to a
+// point) so that, e.g., a bolt crossing a dark room doesn't redraw
+// the whole map at every step.
 void
 see_and_update_at(int x, int y) {
     see_at(x, y);
 
     if (player_sees(x,y)) {
         FovChanged = true;
+    } else if (!MapChanged && NumDirty < MAX_DIRTY_CELLS) {
+        GameCtx->dirtyX[NumDirty] = x;
+        GameCtx->dirtyY[NumDirty] = y;
+        NumDirty++;
     } else {
         MapChanged = true;
     }// if .. else
@@ -98,25 +115,25 @@ force_full_update() {
  * now. */
 static char
 mimicmonst() {
-    static uint8_t mimicmonst = MIMIC;
-    static long changed_time = -1;
+    uint8_t *mimicmonst = &GameCtx->mimicMonst;
+    long *changed_time = &GameCtx->mimicChangedTime;
 
     /* If this is the first time this function has been called,
      * initialize changed_time.  Keeps mimics looking like mimics for
      * the first 10 mobuls.  (I'm not sure if that's a good idea, but
      * that's what the original code did. --CR)*/
-    if (changed_time < 0) {
-        changed_time = UU.gtime;
+    if (*changed_time < 0) {
+        *changed_time = UU.gtime;
     }/* if */
 
-    if (UU.gtime > changed_time + 10) {
+    if (UU.gtime > *changed_time + 10) {
         do {
-            mimicmonst = rnd(MAXCREATURE);
-        } while(mimicmonst == INVISIBLESTALKER);
-        changed_time = UU.gtime;
+            *mimicmonst = rnd(MAXCREATURE);
+        } while(*mimicmonst == INVISIBLESTALKER);
+        *changed_time = UU.gtime;
     }/* if */
 
-    return MonType[mimicmonst].mapchar;
+    return MonType[*mimicmonst].mapchar;
 }/* shuffle_mimic*/
 
 
@@ -128,9 +145,10 @@ drawcell(int x, int y, bool in_town) {
 
     /* Display the player if they're here. */
     if (x == UU.x && y == UU.y) {
-        char player = UU.blindCount > 0 ? ' ' : '@';
+        char player = effect_left(EFF_BLIND) > 0 ? ' ' : '@';
         mapdraw(x, y, player,
-                UU.invisibility ? MFL_PLAYER_INV : MFL_PLAYER, false, in_town);
+                effect_left(EFF_INVISIBILITY) ? MFL_PLAYER_INV : MFL_PLAYER,
+                false, in_town);
         return;
     }/* if */
 
@@ -140,7 +158,7 @@ drawcell(int x, int y, bool in_town) {
      * relevant potion), we display all monsters on the map,
      * regardless of whether it's in the FoV or a known location.  In
      * addition, this overrides monster abilities. */
-    if (UU.monster_detection > 0 && ismon(here.mon)) {
+    if (effect_left(EFF_MONSTER_DETECTION) > 0 && ismon(here.mon)) {
         mapdraw(x, y, monchar(here.mon.id), MFL_DEFAULT, in_fov, in_town);
         return;
     }// if
@@ -184,11 +202,11 @@ static struct FovRect
 get_vis_rect() {
     int radius = 2;
 
-    if (UU.blindCount) {
+    if (effect_left(EFF_BLIND)) {
         radius = 0;
     } else if (UU.enlightenment.time) {
         radius = UU.enlightenment.radius;
-    } else if (UU.awareness) {
+    } else if (effect_left(EFF_AWARENESS)) {
         radius = 5;
    } else if (getlevel() == 0) {
        radius = 100;
@@ -235,7 +253,7 @@ expand_vis_rect(struct FovRect fov) {
 // everything.
 static void
 drawscreen(bool all) {
-    static struct FovRect ofov = {0,0,0,0,0};   // Previous FovRect
+    struct FovRect *ofov = &GameCtx->ofov;      // Previous FovRect
 
     int lvl = getlevel();
     ASSERT(lvl >= 0);   // Fails if the map has not been initialized
@@ -247,12 +265,12 @@ drawscreen(bool all) {
     // If the FoV has shrunk, we need to draw the previous size at
     // least once more to update the areas that are no longer visible.
     // Otherwise, we stash the previous FoV for next time.
-    if (fov.radius < ofov.radius) {
-        struct FovRect ofov_copy = ofov;
-        ofov = fov;
+    if (fov.radius < ofov->radius) {
+        struct FovRect ofov_copy = *ofov;
+        *ofov = fov;
         fov = ofov_copy;
     } else {
-        ofov = fov;
+        *ofov = fov;
     }// if .. else
 
     // Draw the cells
@@ -293,16 +311,16 @@ fill_visible_map(bool value) {
 
 static void
 update_visible_map(struct FovRect fov_rect) {
-    static bool fovStructInitialized = false;
-    static fov_settings_type fovSettings;
+    // The settings cache per-radius data so each context has its own.
+    fov_settings_type *fovSettings = &GameCtx->fovSettings;
 
     // Initialize fovSettings on the first call
-    if (!fovStructInitialized) {
-        fov_settings_init(&fovSettings);
-        fov_settings_set_opacity_test_function(&fovSettings, fov_opaque_test);
-        fov_settings_set_apply_lighting_function(&fovSettings, fov_apply);
+    if (!GameCtx->fovSettingsInitialized) {
+        fov_settings_init(fovSettings);
+        fov_settings_set_opacity_test_function(fovSettings, fov_opaque_test);
+        fov_settings_set_apply_lighting_function(fovSettings, fov_apply);
 
-        fovStructInitialized = true;
+        GameCtx->fovSettingsInitialized = true;
     }// if
 
     // The town has full visibility, so this is a trivial case
@@ -324,7 +342,7 @@ update_visible_map(struct FovRect fov_rect) {
     }// if
 
     // Compute the visibility
-    fov_circle(&fovSettings, NULL, NULL, UU.x, UU.y, fov_rect.radius);
+    fov_circle(fovSettings, NULL, NULL, UU.x, UU.y, fov_rect.radius);
 }// update_visible_map
 
 
@@ -339,7 +357,7 @@ see_and_update_fov() {
     update_visible_map(fov_rect);
 
     // Update the map to include those points in the current FoV:
-    bool blindwtw = UU.blindCount > 0 && UU.wtw > 0;
+    bool blindwtw = effect_left(EFF_BLIND) > 0 && effect_left(EFF_WTW) > 0;
     for (int y = fov_rect.top; y <= fov_rect.bottom; y++) {
         for (int x = fov_rect.left; x <= fov_rect.right; x++) {
 
@@ -0,0 +1,278 @@
+// This file is part of ReLarn; Copyright (C) 1986 - 2023; GPLv2; NO WARRANTY!
+// See Copyright.txt, LICENSE.txt and AUTHORS.txt for terms.
+
+#include "effect.h"
+
+#include "internal_assert.h"
+#include "player.h"
+#include "map.h"
+#include "ui.h"
+
+#include <string.h>
+
+
+// Curse of itching: might take off the player's armor.
+static void
+itch() {
+    if ((UU.wear != -1 || UU.shield != -1) && rnd(100) < 50) {
+        UU.wear = UU.shield = -1;
+        say("The hysteria of itching forces you to remove your armor!\n");
+        headsup();
+    }// if
+}// itch
+
+// Curse of clumsiness: might drop the player's weapon, if there's
+// room on the floor.
+static void
+fumble() {
+    if (UU.wield != -1 && at(UU.x, UU.y)->obj.type == ONONE &&
+        rnd(100) < 33)
+    {
+        drop_object((int)UU.wield);
+    }// if
+}// fumble
+
+
+// Everything we need to know about each effect.
+static const struct EffectInfo {
+    const char *endMsg;         // Said when it runs out, unless NULL
+    enum OBJECT_ID pausedBy;    // Doesn't run down while this is carried
+    void (*everyTurn)(void);    // Called each turn it's active but the last
+    bool timeWarp;              // Affected by adjust_effect_timeouts()
+    bool neverPermanent;        // ...but can't be made permanent by it
+} Effects[EFF_COUNT] = {
+    [EFF_HERO]              = {.timeWarp = true},
+    [EFF_COKED]             = {0},
+    [EFF_ALTPRO]            = {.timeWarp = true},
+    [EFF_PROTECTION]        = {.timeWarp = true},
+    [EFF_DEXCOUNT]          = {.timeWarp = true},
+    [EFF_STRCOUNT]          = {.timeWarp = true},
+    [EFF_BLIND]             = {.endMsg = "The blindness lifts.\n"},
+    [EFF_CONFUSE]           = {.endMsg = "You regain your senses.\n"},
+    [EFF_GIANTSTR]          = {.timeWarp = true},
+    [EFF_CHARM]             = {.timeWarp = true},
+    [EFF_INVISIBILITY]      = {.timeWarp = true},
+    [EFF_CANCELLATION]      = {.timeWarp = true},
+    [EFF_WTW]               = {.timeWarp = true},
+    [EFF_HASTESELF]         = {.timeWarp = true},
+    [EFF_AGGRAVATE]         = {.timeWarp = true},
+    [EFF_SCAREMONST]        = {.timeWarp = true},
+    [EFF_STEALTH]           = {.timeWarp = true},
+    [EFF_HOLDMONST]         = {.timeWarp = true, .neverPermanent = true},
+    [EFF_HASTEMONST]        = {.timeWarp = true},
+    [EFF_FIRERESISTANCE]    = {.timeWarp = true},
+    [EFF_SPIRITPRO]         = {.timeWarp = true},
+    [EFF_UNDEADPRO]         = {.timeWarp = true},
+    [EFF_MONSTER_DETECTION] = {0},
+    [EFF_GLOBE]             = {.timeWarp = true},
+
+    // Posessing the Orb of Awareness both preserves the existing
+    // awareness count and ensures that you currently have Awareness.
+    [EFF_AWARENESS]         = {.pausedBy = OORB, .timeWarp = true},
+
+    [EFF_HALFDAM]           = {.endMsg = "You now feel better.\n",
+                               .timeWarp = true},
+    [EFF_SEEINVISIBLE]      = {.endMsg = "Your vision returns to normal.\n",
+                               .pausedBy = OAMULET, .timeWarp = true},
+    [EFF_ITCHING]           = {.endMsg = "The irritation subsides.\n",
+                               .everyTurn = itch, .timeWarp = true},
+    [EFF_CLUMSINESS]        = {.endMsg = "You now feel less awkward.\n",
+                               .everyTurn = fumble, .timeWarp = true},
+    [EFF_TIMESTOP]          = {0},
+};
+
+
+//
+// The heap.  Ties are broken by effect ID so that effects ending on
+// the same turn always go in the same order.
+//
+
+static bool
+heap_before(const struct EffectTable *table, int a, int b) {
+    uint8_t ea = table->heap[a], eb = table->heap[b];
+    int32_t diff = (int32_t)(table->expires[ea] - table->expires[eb]);
+    return diff < 0 || (diff == 0 && ea < eb);
+}// heap_before
+
+static void
+heap_swap(struct EffectTable *table, int a, int b) {
+    uint8_t tmp = table->heap[a];
+    table->heap[a] = table->heap[b];
+    table->heap[b] = tmp;
+
+    table->heapPos[table->heap[a]] = a + 1;
+    table->heapPos[table->heap[b]] = b + 1;
+}// heap_swap
+
+// Move the entry at 'pos' to where it belongs after its expiry time
+// has changed.
+static void
+heap_fix(struct EffectTable *table, int pos) {
+    while (pos > 0 && heap_before(table, pos, (pos - 1) / 2)) {
+        heap_swap(table, pos, (pos - 1) / 2);
+        pos = (pos - 1) / 2;
+    }// while
+
+    for (;;) {
+        int first = pos;
+        int kids[] = {2 * pos + 1, 2 * pos + 2};
+        for (int n = 0; n < 2; n++) {
+            if (kids[n] < table->heapSize &&
+                heap_before(table, kids[n], first))
+            {
+                first = kids[n];
+            }// if
+        }// for
+
+        if (first == pos) { break; }
+        heap_swap(table, pos, first);
+        pos = first;
+    }// for
+}// heap_fix
+
+static void
+heap_remove(struct EffectTable *table, enum EFFECT eff) {
+    int pos = table->heapPos[eff] - 1;
+    ASSERT(pos >= 0);
+
+    table->heapPos[eff] = 0;
+    if (--table->heapSize == pos) { return; }
+
+    table->heap[pos] = table->heap[table->heapSize];
+    table->heapPos[table->heap[pos]] = pos + 1;
+    heap_fix(table, pos);
+}// heap_remove
+
+
+// Give 'eff' 'turns' turns left, clamped to what fits in an int32_t;
+// zero (or less) ends it silently.
+static void
+table_set(struct EffectTable *table, enum EFFECT eff, int64_t turns) {
+    ASSERT(eff >= 0 && eff < EFF_COUNT);
+
+    if (turns <= 0) {
+        if (table->heapPos[eff]) { heap_remove(table, eff); }
+        return;
+    }// if
+
+    if (turns > INT32_MAX) { turns = INT32_MAX; }
+    table->expires[eff] = table->clock + (uint32_t)turns;
+
+    if (!table->heapPos[eff]) {
+        table->heap[table->heapSize] = eff;
+        table->heapPos[eff] = ++table->heapSize;
+    }// if
+    heap_fix(table, table->heapPos[eff] - 1);
+}// table_set
+
+
+// Set 'table' (which need not be initialized) to have effect n last
+// for turns[n] turns.  Used to convert old saves.
+void
+effect_table_init(struct EffectTable *table, const int32_t turns[EFF_COUNT]) {
+    memset(table, 0, sizeof(*table));
+    for (int eff = 0; eff < EFF_COUNT; eff++) {
+        table_set(table, eff, turns[eff]);
+    }// for
+}// effect_table_init
+
+
+void
+effect_set(enum EFFECT eff, int64_t turns) {
+    table_set(&UU.effects, eff, turns);
+}// effect_set
+
+void
+effect_add(enum EFFECT eff, int64_t turns) {
+    effect_set(eff, (int64_t)effect_left(eff) + turns);
+}// effect_add
+
+
+// Advance the effects by one turn: run down everything that isn't
+// paused, end whatever runs out and do the per-turn stuff for the
+// rest.  Called by regen().
+void
+effect_tick() {
+    struct EffectTable *table = &UU.effects;
+
+    uint32_t ticking = 0;
+    for (int eff = EFF_FIRST_EVERY_TURN; eff <= EFF_LAST_EVERY_TURN; eff++) {
+        if (!table->heapPos[eff]) { continue; }
+
+        // Pausing pushes the end back by one turn, every turn.  (An
+        // effect that already has the most turns possible loses one.)
+        const struct EffectInfo *info = &Effects[eff];
+        if (info->pausedBy != ONONE && has_a(info->pausedBy) &&
+            effect_left(eff) < INT32_MAX)
+        {
+            table->expires[eff]++;
+            heap_fix(table, table->heapPos[eff] - 1);
+        }// if
+
+        if (info->everyTurn) { ticking |= 1u << eff; }
+    }// for
+
+    table->clock++;
+
+    uint32_t ending = 0;
+    while (table->heapSize > 0 &&
+           (int32_t)(table->expires[table->heap[0]] - table->clock) <= 0)
+    {
+        ending |= 1u << table->heap[0];
+        heap_remove(table, table->heap[0]);
+    }// while
+
+    // Dispatch in effect order so the messages come out as they
+    // always have.
+    uint32_t todo = ending | ticking;
+    for (int eff = 0; todo; eff++, todo >>= 1) {
+        if (!(todo & 1)) { continue; }
+
+        if (!(ending & (1u << eff))) {
+            Effects[eff].everyTurn();
+        } else if (Effects[eff].endMsg) {
+            say(Effects[eff].endMsg);
+            headsup();
+        }// if .. else
+    }// for
+}// effect_tick
+
+
+// Add 'time' (which may be negative) to each active player stat in
+// UU, truncating to 1 if the result would go negative.  Used for
+// stuff like scrolls of Time Warp or taking a course at U of Larn.
+//
+// As a special case, a true value for make_permanent (and time == 0)
+// makes all active effects permanent.
+void
+adjust_effect_timeouts(int32_t time, bool make_permanent) {
+
+    // Ensure the caller didn't accidently set make_permanent to true.
+    ASSERT(!make_permanent || time == 0);
+
+    for (int eff = 0; eff < EFF_COUNT; eff++) {
+        const struct EffectInfo *info = &Effects[eff];
+        int32_t left = effect_left(eff);
+
+        // We only affect active stats
+        if (!info->timeWarp || left == 0) { continue; }
+
+        // We make stats permanent by setting them to very high values
+        // which can't run out in the life of the game.  This is
+        // around 10 million mobuls.  (I used to use INT32_MAX but
+        // this caused the scroll of timewarp to sometimes overflow
+        // the counts and lose permanent stats.)
+        if (make_permanent) {
+            if (!info->neverPermanent) { effect_set(eff, INT32_MAX/2); }
+            continue;
+        }// if
+
+        // We offset by one because regen() will do the final
+        // iteration.  If the update took the result negative, just
+        // set it to 1 and let the call to regen() finish it off.
+        int64_t turns = (int64_t)left - (time - 1);
+        effect_set(eff, turns < 1 ? 1 : turns);
+    }// for
+
+    regen();
+}// adjust_effect_timeouts
@@ -0,0 +1,91 @@
+// This file is part of ReLarn; Copyright (C) 1986 - 2023; GPLv2; NO WARRANTY!
+// See Copyright.txt, LICENSE.txt and AUTHORS.txt for terms.
+
+// Timed effects on the player (blindness, haste, protection, etc.).
+//
+// Each effect counts down the turns it has left and ends when that
+// reaches zero.  Rather than decrementing every counter every turn,
+// the table records the time on its own clock at which each active
+// effect ends and keeps them in a min-heap by that time, so a turn
+// only does work for the effects ending in it (plus the handful that
+// do something every turn; see effect.c).
+//
+// The clock ticks once per call to regen(), not with UU.gtime; the
+// latter runs at half speed while hasted but effects don't.
+//
+// The table lives in struct Player (as UU.effects) and is saved with
+// it.  Use the functions below (and effect_left() in player.h) rather
+// than poking at it.
+
+#ifndef HDR_GUARD_EFFECT_H
+#define HDR_GUARD_EFFECT_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// The effects, in the order regen() has always handled them (which
+// is the order their end-of-effect messages appear in).  Effects
+// that need attention every turn they are active (see effect.c) must
+// be in the range EFF_FIRST_EVERY_TURN .. EFF_LAST_EVERY_TURN.
+enum EFFECT {
+    EFF_HERO,
+    EFF_COKED,
+    EFF_ALTPRO,                 // Protection granted by an altar
+    EFF_PROTECTION,
+    EFF_DEXCOUNT,
+    EFF_STRCOUNT,
+    EFF_BLIND,
+    EFF_CONFUSE,
+    EFF_GIANTSTR,
+    EFF_CHARM,
+    EFF_INVISIBILITY,
+    EFF_CANCELLATION,
+    EFF_WTW,                    // Walk through walls
+    EFF_HASTESELF,
+    EFF_AGGRAVATE,
+    EFF_SCAREMONST,
+    EFF_STEALTH,
+    EFF_HOLDMONST,
+    EFF_HASTEMONST,
+    EFF_FIRERESISTANCE,
+    EFF_SPIRITPRO,
+    EFF_UNDEADPRO,
+    EFF_MONSTER_DETECTION,
+    EFF_GLOBE,                  // Invulnerable Globe (aka Invulnerability)
+    EFF_AWARENESS,
+    EFF_HALFDAM,                // Curse: halves your damage
+    EFF_SEEINVISIBLE,
+    EFF_ITCHING,                // Curse: can't wear armor
+    EFF_CLUMSINESS,             // Curse: chance of dropping stuff
+    EFF_TIMESTOP,               // Handled by regen() itself
+
+    EFF_COUNT,
+
+    EFF_FIRST_EVERY_TURN = EFF_AWARENESS,
+    EFF_LAST_EVERY_TURN = EFF_CLUMSINESS,
+};
+
+// The table.  An effect is active iff it is in the heap.  Times are
+// compared by difference so the clock may wrap.
+struct EffectTable {
+    uint32_t clock;                 // Ticks so far
+    uint32_t expires[EFF_COUNT];    // When each active effect ends
+    uint8_t heap[EFF_COUNT];        // Active effects, soonest first
+    uint8_t heapPos[EFF_COUNT];     // 1 + index into heap[]; 0 if inactive
+    uint8_t heapSize;
+};
+
+void effect_set(enum EFFECT eff, int64_t turns);
+void effect_add(enum EFFECT eff, int64_t turns);
+void effect_tick(void);
+void effect_table_init(struct EffectTable *table,
+                       const int32_t turns[EFF_COUNT]);
+void adjust_effect_timeouts(int32_t time, bool make_permanent);
+
+static inline int32_t
+effect_table_left(const struct EffectTable *table, enum EFFECT eff) {
+    if (!table->heapPos[eff]) { return 0; }
+    return (int32_t)(table->expires[eff] - table->clock);
+}// effect_table_left
+
+#endif
@@ -21,6 +21,10 @@
 #include "player.h"
 #include "ui.h"
 #include "savegame.h"
+#include "profile.h"
+#include "pregen.h"
+#include "arena.h"
+#include "allocstats.h"
 
 #define AUTOSAVE_INTERVAL 100       // TODO: make this user-configurable
 
@@ -117,35 +121,61 @@ onemove(DIRECTION dir) {
     bool running = (dir != DIR_CANCEL && dir != DIR_STAY);
     bool missedTurn = (dir == DIR_STAY);    // Paralysis, etc.
 
+    // Anything taken from the arena during the turn is done with by
+    // the end of it.  (Turns can nest, e.g. when running, so this is
+    // a scope rather than a reset.)
+    struct ArenaMark turnScope = arena_mark();
+
+    // Close out the display statistics and profile of the previous
+    // turn.
+    render_stats_end_turn(UU.gtime);
+    prof_next_turn(getlevel());
+    alloc_next_turn();
+
     /* Update field of view and show changes. */
+    prof_begin(PP_FOV);
     see_and_update_fov();
+    prof_end(PP_FOV);
+
+    prof_begin(PP_DISPLAY);
     update_display();
+    prof_end(PP_DISPLAY);
 
     /* Do the action.  If 'dir' is a legitimate direction, attempt to
      * move in that direction.  Otherwise, this is an interactive move
      * and we call play_turn() to fetch a command from the user and
      * then do what it says. */
     bool keepRunning = false;
+    prof_begin(PP_ACTION);
     if (running) {
         moveplayer(dir, &keepRunning);
     } else if (!missedTurn) {
         play_turn();
     }/* if .. else*/
+    prof_end(PP_ACTION);
 
     /* regenerate hp and spells */
+    prof_begin(PP_REGEN);
     regen();
+    prof_end(PP_REGEN);
 
     // Update player stat modifications due to carried/worn stuff.
+    prof_begin(PP_RECALC);
     recalc();
+    prof_end(PP_RECALC);
 
     /* Create new monsters if appropriate. */
+    prof_begin(PP_RANDMONST);
     randmonst();
+    prof_end(PP_RANDMONST);
 
     /* Deal with any object the player may step on.  If the player is
      * running, this is a good reason to stop. */
     if (!missedTurn) {
         bool foundSomething;
+        prof_begin(PP_LOOK);
         foundSomething = lookforobject();
+        prof_end(PP_LOOK);
 
         if (foundSomething) {
             recalc();       // Recalculate in case this changes a stat
@@ -155,15 +185,19 @@ onemove(DIRECTION dir) {
              * move.  This way, the player regains control while still on
              * the thing.*/
             if (running) {
+                arena_release(turnScope);
                 return false;
             }// if
         }// if
     }/* if */
 
     /* Move the monsters. */
-    if (UU.hastemonst) { movemonst(); }
+    prof_begin(PP_MOVEMONST);
+    if (effect_left(EFF_HASTEMONST)) { movemonst(); }
     movemonst();
+    prof_end(PP_MOVEMONST);
 
+    arena_release(turnScope);
     return keepRunning;
 }/* onemove*/
 
@@ -176,11 +210,17 @@ onemove(DIRECTION dir) {
  */
 static void
 play_turn () {
-    int key;
+    bool done;
 
+    // Commands that don't take a turn (e.g. looking at the inventory)
+    // can be repeated indefinitely, so each gets its own arena scope.
     do {
-        key = map_getch();
-    } while (!player_action(key));
+        int key = map_getch();
+
+        struct ArenaMark cmdScope = arena_mark();
+        done = player_action(key);
+        arena_release(cmdScope);
+    } while (!done);
 }/* play_turn */
 
 
@@ -311,20 +351,20 @@ player_action(char key) {
         break; /* wear armor   */
 
     case 'r':
-        if (UU.blindCount) {
+        if (effect_left(EFF_BLIND)) {
             say("You can't read anything when you're blind!\n");
-        } else if (UU.timestop==0)
+        } else if (effect_left(EFF_TIMESTOP)==0)
             readscr();
         break; /* to read a scroll */
 
     case 'q':
-        if (UU.timestop == 0) {
+        if (effect_left(EFF_TIMESTOP) == 0) {
             quaff();
         }// if
         break; /* quaff a potion */
 
     case 'd':
-        if (UU.timestop==0) {
+        if (effect_left(EFF_TIMESTOP)==0) {
             dropobj();
         }
         break; /* to drop an object */
@@ -338,7 +378,7 @@ player_action(char key) {
         break;
 
     case 'e':
-        if (UU.timestop==0) {
+        if (effect_left(EFF_TIMESTOP)==0) {
             eatcookie();
         }
         break; /* to eat a fortune cookie */
@@ -424,6 +464,8 @@ player_action(char key) {
 // Assumes UI is active.
 void
 save_and_quit() {
+    if (GameCtx->endGame) { GameCtx->endGame(-1); }
+
     enum SAVE_STATUS ss = save_game();
     if (!ss_success(ss)) {
         say("Error saving game! Not quitting!\n");
@@ -480,6 +522,11 @@ post_restore_processing() {
 // won't print the message.
 void
 graceful_exit(const char *msg) {
+    if (GameCtx && GameCtx->endGame) { GameCtx->endGame(-1); }
+
+    // Don't leave levels half-built while we exit.
+    if (GameCtx) { pregen_discard(GameCtx); }
+
     teardown_ui();
     if (msg) {
         printf("%s\n", msg);
@@ -554,13 +601,14 @@ unrecoverable(int cause) {
 }// unrecoverable
 
 
-// Return the textual description of each cause of death
-static const char *
+// Return the textual description of each cause of death.  (The
+// result may be overwritten by the next call in the same thread.)
+const char *
 cause_desc(int cause) {
     ASSERT(cause >= 0);
 
     if (cause < MAXCREATURE) {
-        static char result[80];
+        static __thread char result[80];
 
         const char* mname = MonType[cause].name;
         snprintf(result, sizeof (result), "were killed by %s %s.",
@@ -619,6 +667,12 @@ game_over_probably(unsigned cause) {
         }// if
     }// if
 
+    // Hand off to the context's owner if it wants to end the game
+    // itself.
+    if (GameCtx->endGame) {
+        GameCtx->endGame(cause);
+    }// if
+
     // Let the user read the final message before continuing.  (Not
     // necessary for the winner because there's just been a big
     // presentation about the potion working.)
@@ -717,6 +771,7 @@ game_over_probably(unsigned cause) {
     }// if
 
     delete_save_files();
+    pregen_discard(GameCtx);
 
     printf("GAME OVER\n");
 
@@ -18,6 +18,8 @@ enum GAME_ENDING {
 #define ENDING(id, name) id,
 #   include "game_endings.h"
 #undef ENDING
+
+    DD_COUNT                        // One past the last ending
 };
 
 
@@ -30,6 +32,7 @@ long compute_score(bool won);
 void save_and_quit(void);
 long compute_taxes_owed(const struct Player *);
 void game_over_probably(unsigned cause);
+const char *cause_desc(int cause);
 void post_restore_processing(void);
 void emergency_save(void);
 void cancel_emergency_save(void);
@@ -0,0 +1,63 @@
+// This file is part of ReLarn; Copyright (C) 1986 - 2023; GPLv2; NO WARRANTY!
+// See Copyright.txt, LICENSE.txt and AUTHORS.txt for terms.
+
+#include "game_context.h"
+
+#include "store.h"
+#include "pregen.h"
+
+#include <stdlib.h>
+
+
+__thread struct GameContext *GameCtx = NULL;
+
+
+// Create a new context in the state a freshly-started program would
+// be in, i.e. with the store stocked (as initstore() does) but no
+// player or map yet.
+struct GameContext *
+gc_new() {
+    struct GameContext *ctx = xcalloc(1, sizeof(struct GameContext));
+
+    ctx->world.levelNum = -1;
+    ctx->lastlevel = (uint8_t)-1;
+    ctx->prevlookX = ctx->prevlookY = ctx->prevlookLvl = -1;
+    ctx->prevObjType = ONONE;
+    ctx->fovChanged = ctx->mapChanged = true;
+    ctx->mimicMonst = MIMIC;
+    ctx->mimicChangedTime = -1;
+
+    struct GameContext *prev = GameCtx;
+    GameCtx = ctx;
+    initstore();
+    GameCtx = prev;
+
+    return ctx;
+}// gc_new
+
+
+// Free a context created by gc_new().  It must not be bound to the
+// current thread (or any other).
+void
+gc_free(struct GameContext *ctx) {
+    if (!ctx) { return; }
+
+    ASSERT(ctx != GameCtx);
+
+    pregen_discard(ctx);
+    if (ctx->fovSettingsInitialized) {
+        fov_settings_free(&ctx->fovSettings);
+    }// if
+    free(ctx->currentSave);
+    free(ctx);
+}// gc_free
+
+
+// Make 'ctx' the current thread's context and return the previous
+// one.  Either may be NULL (i.e. no context).
+struct GameContext *
+gc_bind(struct GameContext *ctx) {
+    struct GameContext *prev = GameCtx;
+    GameCtx = ctx;
+    return prev;
+}// gc_bind
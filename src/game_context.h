@@ -0,0 +1,163 @@
+// This file is part of ReLarn; Copyright (C) 1986 - 2023; GPLv2; NO WARRANTY!
+// See Copyright.txt, LICENSE.txt and AUTHORS.txt for terms.
+
+// The game context: all of the state belonging to a single game.
+//
+// Everything that changes as a game is played (the player, their
+// inventory, the dungeon, the store's stock, the stashed save and
+// the assorted bits of bookkeeping various modules keep between
+// turns) lives in a struct GameContext.  The engine works on the
+// context bound to the current thread by gc_bind(); the familiar
+// names (UU, Invent, ShopInvent, etc.) are macros that refer to its
+// fields, so existing code doesn't need to pass it around.
+//
+// Nothing is bound at startup: a program creates a context per game
+// with gc_new() and binds it with gc_bind() in the thread that plays
+// it before touching the engine.  A normal, single-game program just
+// does this once at the start of main().  Several games can be played
+// at once in different threads, or one after the other in the same
+// thread by rebinding.
+//
+// Per-process state (settings, the UI, the profiler and the read-only
+// tables loaded at startup) is *not* part of the context.
+
+// player.h includes this file once struct Player is defined (its
+// inline functions need UU), so go through it.
+#include "player.h"
+
+#ifndef HDR_GUARD_GAME_CONTEXT_H
+#define HDR_GUARD_GAME_CONTEXT_H
+
+#include "map.h"
+#include "store.h"
+
+#include "fov/fov.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+struct SaveGame;
+struct Pregen;
+
+// The most cells outside the field of view see_and_update_at() will
+// queue for redrawing before falling back to redrawing the map.
+#define MAX_DIRTY_CELLS 16
+
+// Rectangle containing the player's field of view
+struct FovRect {
+    int8_t left, right, top, bottom;
+    int8_t radius;
+};
+
+// Totals over the inventory by object type.  These are kept up to
+// date by inv_set() and friends so that has_a() and the like don't
+// need to search the inventory.
+struct InvTotals {
+    uint8_t count[OBJ_COUNT];           // Number carried
+    int32_t mod[OBJ_COUNT];             // Their combined carry modifier
+    uint32_t generation;                // Bumped on every change
+};
+
+// What recalc()'s result depends on.  If none of it has changed
+// since the last call, the stat mods are still right.
+struct RecalcKey {
+    bool valid;
+    uint32_t invGeneration;
+    int8_t wear, shield;
+    uint8_t effects;                    // One bit per active effect
+};
+
+// The empty floor of the current level (interior cells with no object
+// or monster), for placing things at random.  See take_free_cell().
+struct FreeCells {
+    bool live;                          // Kept up to date between calls
+    int count;
+    uint16_t cells[(MAXX - 2) * (MAXY - 2)];    // x * MAXY + y, unordered
+    int16_t slot[MAXX * MAXY];          // Index into cells[] or -1
+};
+
+// Where the objects on a level are, by type: for each type, a list
+// of the cells holding one, linked through next[] and prev[].  Cells
+// are numbered 1 + x * MAXY + y so that 0 can end a list.  See
+// set_obj_at().
+struct ObjIndex {
+    bool valid;                         // Else rebuild from the map
+    uint16_t head[OBJ_COUNT];           // First cell of each type or 0
+    uint16_t next[MAXX * MAXY + 1];
+    uint16_t prev[MAXX * MAXY + 1];
+};
+
+struct GameContext {
+    // player.c
+    struct Player uu;
+    struct Object invent[IVENSIZE];     // Change only via inv_set() et al.
+    struct InvTotals invTotals;
+    struct RecalcKey recalcKey;
+
+    // map.c
+    struct World world;
+    struct FreeCells freeCells;
+    struct ObjIndex objIndex[NLEVELS];
+
+    // pregen.c: building levels (see pregen.h)
+    uint64_t levelSeed;                 // Per-level streams' base; 0 if unset
+    struct Pregen *pregen;              // Levels under way; NULL if none
+    bool building;                      // This context builds a level
+    char buildNotes[240];               // What to say() when it's done
+
+    // store.c
+    struct StoreItem shopInvent[OBJ_COUNT];
+    unsigned shopInventSz;
+
+    // savegame.c
+    struct SaveGame *currentSave;       // Allocated on first stash
+    volatile bool stashedGameExists;
+    volatile bool stashOperationInProgress;
+
+    // movem.c: the last monster the player hit
+    uint8_t lasthx, lasthy;
+    uint8_t lastlevel;                  // lasthx,lasthy invalid unless current
+
+    // look.c: the last square looked at
+    int prevlookX, prevlookY, prevlookLvl;
+    uint8_t prevObjType;
+
+    // display.c
+    bool fovChanged, mapChanged;        // Dirty flags for screen update
+    uint8_t dirtyX[MAX_DIRTY_CELLS];    // Cells outside the FoV to redraw
+    uint8_t dirtyY[MAX_DIRTY_CELLS];    // (if mapChanged isn't set)
+    int numDirty;
+    bool visibleMap[MAXX][MAXY];        // The squares visible right now
+    struct FovRect ofov;                // Previous FoV rectangle
+    uint8_t mimicMonst;                 // What mimics look like right now
+    long mimicChangedTime;              // When mimicMonst last changed
+    bool fovSettingsInitialized;
+    fov_settings_type fovSettings;      // Caches per-radius data
+
+    // If set, this is called in place of the usual end of the game
+    // (ending screen, scoreboard, exit()) with the cause of death
+    // (a monster ID or GAME_ENDING) or -1 if the player quit or
+    // saved.  It must not return.  Used by relarn-sim.
+    void (*endGame)(int cause);
+
+    // If set, the game doesn't look up the player's past games on the
+    // scoreboard, so they start out owing no taxes.  Used by relarn-sim.
+    bool noScoreboard;
+};
+
+// The context the current thread is playing.  Use gc_bind() to
+// change it.
+extern __thread struct GameContext *GameCtx;
+
+struct GameContext *gc_new(void);
+void gc_free(struct GameContext *ctx);
+struct GameContext *gc_bind(struct GameContext *ctx);
+
+// The public parts of the context, under their traditional names.
+#define UU              (GameCtx->uu)
+// Invent is read-only; use inv_set() et al. (player.h) to change it.
+#define Invent          ((const struct Object *)GameCtx->invent)
+#define ShopInvent      (GameCtx->shopInvent)
+#define ShopInventSz    (GameCtx->shopInventSz)
+
+#endif
@@ -16,17 +16,17 @@ load_doc (const char *filename) {
     char line[82];
     struct TextBuffer *tb;
 
-    tb = tb_malloc (INF_BUFFER, sizeof(line));
-
     fh = fopen (filename, "r");
     if (!fh) {
         return NULL;
     }/* if */
 
+    tb = tb_malloc (INF_BUFFER, sizeof(line));
     while (fgets(line, sizeof(line), fh)) {
         tb_appendline(tb, line);
     }/* while */
 
+    fclose (fh);
     return tb;
 }/* load_doc */
 
@@ -55,8 +55,10 @@ static void ocaveexit(void);
 
 // The last square looked at; we use this to keep the "you see a..."
 // prompt from coming up if you've already seen it.
-static int prevlook_x = -1, prevlook_y = -1, prevlook_lvl = -1;
-static uint8_t prev_obj_type = ONONE;
+#define prevlook_x      (GameCtx->prevlookX)
+#define prevlook_y      (GameCtx->prevlookY)
+#define prevlook_lvl    (GameCtx->prevlookLvl)
+#define prev_obj_type   (GameCtx->prevObjType)
 
 // Test if we've already seen this location
 static bool
@@ -102,7 +104,7 @@ lookforobject() {
     }
 
     /* can't find objects is time is stopped*/
-    if (UU.timestop) { return false; }
+    if (effect_left(EFF_TIMESTOP)) { return false; }
 
     thing = at(UU.x, UU.y)->obj;
     if (isnone(thing) || thing.type == OWALL) { return false; }
@@ -300,7 +302,7 @@ otrapdoor() {
 
     if (invisible) {
         if (rnd(17) < 13) return;
-        at(UU.x, UU.y)->obj = obj(OTRAPDOOR, 0);
+        set_obj_at(UU.x, UU.y, obj(OTRAPDOOR, 0));
         see_at(UU.x, UU.y);
     }/* if */
 
@@ -330,7 +332,7 @@ otrapdoor() {
 
 static void
 opointytraps() {
-    struct Object *atThing;
+    const struct Object *atThing;
     bool invisible, isDart;
     const char *arrow;
 
@@ -343,7 +345,7 @@ opointytraps() {
     /* If the trap is undiscovered, roll to see if it was tripped. */
     if (invisible) {
         if (rnd(17) < 13) return;
-        at(UU.x, UU.y)->obj = obj(isDart ? ODARTRAP : OTRAPARROW, 0);
+        set_obj_at(UU.x, UU.y, obj(isDart ? ODARTRAP : OTRAPARROW, 0));
     }/* if */
 
     say("You are hit by %s %s!\n", an(arrow), arrow);
@@ -483,7 +485,7 @@ ocloseddoor() {
         switch(thing.iarg) {
         case DT_AGGRAVATE:
             say("The door handle squeaks loudly.\n");
-            UU.aggravate += rnd(400);
+            effect_add(EFF_AGGRAVATE, rnd(400));
             break;
 
         case DT_SHOCK:
@@ -507,7 +509,7 @@ ocloseddoor() {
     }/* if */
 
     udelobj();
-    at(UU.x, UU.y)->obj = obj(OOPENDOOR, 0);
+    set_obj_at(UU.x, UU.y, obj(OOPENDOOR, 0));
 }/* ocloseddoor*/
 
 
@@ -521,8 +523,8 @@ ospeed() {
     if (opt == 'g') {
         say("snort!\nOhwowmanlikethingstotallyseemtoslowdown!\n");
 
-        UU.hasteSelf += 200 + UU.level;
-        UU.halfdam += 300 + rnd(200);
+        effect_add(EFF_HASTESELF, 200 + UU.level);
+        effect_add(EFF_HALFDAM, 300 + rnd(200));
 
         intelligence_adjust(-2);
         wisdom_adjust(-2);
@@ -549,15 +551,15 @@ ohash() {
 
     if (opt == 'g') {
         say("smoke!\nWOW! You feel stooooooned...\n");
-        UU.hastemonst += rnd(75)+25;
+        effect_add(EFF_HASTEMONST, rnd(75)+25);
 
         intelligence_adjust(2);
         wisdom_adjust(2);
         constitution_adjust(-2);
         dexterity_adjust(-2);
 
-        UU.halfdam += 300 + rnd(200);
-        UU.clumsiness += rnd(1800) + 200;
+        effect_add(EFF_HALFDAM, 300 + rnd(200));
+        effect_add(EFF_CLUMSINESS, rnd(1800) + 200);
         udelobj();
     } else if (opt == 't') {
         say("take.\n");
@@ -579,11 +581,11 @@ oacid() {
         say("eat!\n");
         say("You are now frying your ass off!\n");
 
-        UU.confuse += 30 + rnd(10);
+        effect_add(EFF_CONFUSE, 30 + rnd(10));
         wisdom_adjust(2);
         intelligence_adjust(2);
-        UU.awareness += 1500;
-        UU.aggravate += 1500;
+        effect_add(EFF_AWARENESS, 1500);
+        effect_add(EFF_AGGRAVATE, 1500);
 
         heal_monsters();
 
@@ -608,8 +610,8 @@ oshrooms() {
     if (opt == 'g') {
         say("eat!\n");
         say("Things start to get real spacey...\n");
-        UU.hastemonst   += rnd(75) + 25;
-        UU.confuse      += 30+rnd(10);
+        effect_add(EFF_HASTEMONST, rnd(75) + 25);
+        effect_add(EFF_CONFUSE, 30+rnd(10));
         wisdom_adjust(2);
         charisma_adjust(2);
         udelobj();
@@ -638,7 +640,7 @@ ocoke() {
         dexterity_adjust(-2);
         constitution_adjust(-2);
         charisma_adjust(3);
-        UU.coked += 10;
+        effect_add(EFF_COKED, 10);
 
         udelobj();
     } else if (opt == 't') {
@@ -734,7 +736,7 @@ osimple() {
 
 static void
 oteleport_trap() {
-    struct Object *atThing;
+    const struct Object *atThing;
 
     atThing = &at(UU.x, UU.y)->obj;
 
@@ -742,7 +744,7 @@ oteleport_trap() {
      * player hasn't set it off. */
     if (atThing->type == OIVTELETRAP) {
         if (rnd(11)<6) return;  /* If it wasn't set off... */
-        at(UU.x, UU.y)->obj.type = OTELEPORTER;
+        set_obj_at(UU.x, UU.y, obj(OTELEPORTER, atThing->iarg));
         see_at(UU.x, UU.y);
     }/* if */
 
@@ -936,7 +938,7 @@ ogold() {
     say("You find %d gold piece%s.\n",i, i==1 ? "": "s");
     UU.gold += i;
 
-    at(UU.x, UU.y)->obj = NULL_OBJ;
+    set_obj_at(UU.x, UU.y, NULL_OBJ);
 }/* ogold*/
 
 
@@ -1147,19 +1149,16 @@ quaffpotion(struct Object pot) {
     case OPGOLDDET:
         say("You feel greedy...\n");
         nap(2000);
-        for (int y=0; y<MAXY; y++) {
-            for (int x=0; x<MAXX; x++) {
-                if (at(x, y)->obj.type == OGOLDPILE) {
-                    see_and_update_at(x, y);
-                }
-            }/* for */
-        }/* for */
+        int cur = 0, x, y;
+        while (next_obj_of(OGOLDPILE, &cur, &x, &y)) {
+            see_and_update_at(x, y);
+        }/* while */
         update_display();
         return;
 
     case OPMONSTDET:
         say("Your senses reach out, seeking danger.\n");
-        UU.monster_detection += rnd(20) + 10;
+        effect_add(EFF_MONSTER_DETECTION, rnd(20) + 10);
         update_display();
         return;
 
@@ -1178,20 +1177,20 @@ quaffpotion(struct Object pot) {
 
     case OPBLINDNESS:
         say("You can't see anything!\n");
-        UU.blindCount += 500;  /* dang, that's a long time. */
+        effect_add(EFF_BLIND, 500);  /* dang, that's a long time. */
         force_full_update();
         update_display();
         return;
 
     case OPCONFUSION:
         say("You feel confused.\n");
-        UU.confuse += 20 + rnd(9);
+        effect_add(EFF_CONFUSE, 20 + rnd(9));
         return;
 
     case OPHEROISM:
         say("WOW!  You feel fantastic!\n");
         add_to_base_stats(1);    // You get one permanent boost!
-        UU.hero += 250;
+        effect_add(EFF_HERO, 250);
         break;
 
     case OPSTURDINESS:
@@ -1202,26 +1201,25 @@ quaffpotion(struct Object pot) {
     case OPGIANTSTR:
         say("You now have incredible bulging muscles!\n");
         strength_adjust(1);     // You get one permanent boost.
-        UU.giantstr += 700;
+        effect_add(EFF_GIANTSTR, 700);
         break;
 
     case OPFIRERESIST:
         say("You feel a chill run up your spine!\n");
-        UU.fireresistance += 1000;
+        effect_add(EFF_FIRERESISTANCE, 1000);
         break;
 
     case OPTREASURE:
         say("You feel greedy...\n");
         nap(2000);
-        for (int y = 0; y<MAXY; y++) {
-            for (int x = 0; x<MAXX; x++) {
-                int k = at(x, y)->obj.type;
-                if (k == ODIAMOND || k == ORUBY || k == OEMERALD ||
-                    k == OSAPPHIRE || k == OLARNEYE || k == OGOLDPILE)
-                {
-                    see_and_update_at(x, y);
-                }/* if */
-            }/* for */
+        static const uint8_t treasures[] = {
+            ODIAMOND, ORUBY, OEMERALD, OSAPPHIRE, OLARNEYE, OGOLDPILE
+        };
+        for (size_t i = 0; i < sizeof(treasures)/sizeof(treasures[0]); i++) {
+            int cur = 0, x, y;
+            while (next_obj_of(treasures[i], &cur, &x, &y)) {
+                see_and_update_at(x, y);
+            }/* while */
         }/* for */
         update_display();
         return;
@@ -1238,12 +1236,12 @@ quaffpotion(struct Object pot) {
 
     case OPPOISON:
         say("You feel a sickness engulf you!\n");
-        UU.halfdam += 200 + rnd(200);
+        effect_add(EFF_HALFDAM, 200 + rnd(200));
         return;
 
     case OPSEEINVIS:
         say("You feel your vision sharpen.\n");
-        UU.seeinvisible += rnd(1000)+400;
+        effect_add(EFF_SEEINVISIBLE, rnd(1000)+400);
         return;
     };
 
@@ -1262,7 +1260,7 @@ oscroll() {
 
     char prmsg[100];
     snprintf(prmsg, sizeof(prmsg), "Do you %s(t) take it or (n) do nothing?",
-             UU.blindCount == 0 ? "(g) read it, " : "");
+             effect_left(EFF_BLIND) == 0 ? "(g) read it, " : "");
 
     switch(prompt(prmsg)) {
     case 'n':
@@ -1302,7 +1300,7 @@ static void
 ohear() {
     say("You have been heard!\n");
     defense_adjust(2);  // Two of the points are permanent.
-    UU.altpro += 800;   /* protection field */
+    effect_add(EFF_ALTPRO, 800);   /* protection field */
 }/* ohear*/
 
 
@@ -1377,14 +1375,14 @@ oaltar() {
                    "tiny offering!\n");
             udelobj();
             createmonster(DEMONPRINCE);
-            UU.aggravate += 1500;
+            effect_add(EFF_AGGRAVATE, 1500);
             return;
         }/* if */
 
         UU.gold -= amt;
         if (amt < (UU.gold+amt)/10 || (amt < rnd(50))) {
             createmonster(makemonst(getlevel()+2));
-            UU.aggravate += 500;
+            effect_add(EFF_AGGRAVATE, 500);
             return;
         }/* if */
 
@@ -1408,7 +1406,7 @@ oaltar() {
         say(" desecrate\n");
         if (rnd(100)<60) {
             createmonster(makemonst(getlevel()+3)+8);
-            UU.aggravate += 2500;
+            effect_add(EFF_AGGRAVATE, 2500);
         } else if(rnd(100)<5) {
             raiselevel();
         } else if (rnd(101)<30) {
@@ -1423,7 +1421,7 @@ oaltar() {
         ignore();
         if (rnd(100)<30) {
             createmonster(makemonst(getlevel()+2));
-            UU.aggravate += rnd(450);
+            effect_add(EFF_AGGRAVATE, rnd(450));
         }
         return;
     }/* switch*/
@@ -1463,11 +1461,11 @@ othrone() {
             for (i=0; i<rnd(4); i++) {
                 creategem(); /*gems pop off the throne*/
             }
-            at(UU.x, UU.y)->obj = obj(ODEADTHRONE, 0);
+            set_obj_at(UU.x, UU.y, obj(ODEADTHRONE, 0));
         }
         else if (gnome && roll < 40) {
             createmonster(GNOMEKING);
-            at(UU.x, UU.y)->obj = obj(OTHRONE2, 0);
+            set_obj_at(UU.x, UU.y, obj(OTHRONE2, 0));
         }
         else {
             say("Nothing happens.\n");
@@ -1481,7 +1479,7 @@ othrone() {
         }
         else if (gnome && roll < 30) {
             createmonster(GNOMEKING);
-            at(UU.x, UU.y)->obj = obj(OTHRONE2, 0);
+            set_obj_at(UU.x, UU.y, obj(OTHRONE2, 0));
         }
         else if (roll < teleMin) {
             say("Zaaaappp!  You've been teleported!\n\n");
@@ -1520,25 +1518,25 @@ ochest() {
             losehp(i, DDCHEST);
             switch(rnd(10)) {
             case 1:
-                UU.itching+= rnd(1000)+100;
+                effect_add(EFF_ITCHING, rnd(1000)+100);
                 say("You feel an irritation spread over your skin!\n");
                 headsup();
                 break;
 
             case 2:
-                UU.clumsiness+= rnd(1600)+200;
+                effect_add(EFF_CLUMSINESS, rnd(1600)+200);
                 say("You begin to lose hand-eye co-ordination!\n");
                 headsup();
                 break;
 
             case 3:
-                UU.halfdam+= rnd(1600)+200;
+                effect_add(EFF_HALFDAM, rnd(1600)+200);
                 say("You suddenly feel sick and BARF all over your "
                        "shoes!\n");
                 headsup();
                 break;
             };
-            at(UU.x, UU.y)->obj = NULL_OBJ;
+            set_obj_at(UU.x, UU.y, NULL_OBJ);
             if (rnd(100) < 69) {
                 creategem(); /* gems from the chest */
             }
@@ -1593,7 +1591,7 @@ ofountain() {
                     "You lose %d hit point%s!\n", (long)x, x==1?"":"s");
             losehp(x, DDBADWATER);
         } else if (x<14) {
-            UU.halfdam += 200+rnd(200);
+            effect_add(EFF_HALFDAM, 200+rnd(200));
             say("The water makes you vomit.\n");
         } else if (x<17) {
             quaffpotion(obj(OPGIANTSTR, 0)); /* giant strength */
@@ -1608,7 +1606,7 @@ ofountain() {
         if (rnd(12)<3) {
             say("The fountains bubbling slowly quietens.\n");
             /* dead fountain */
-            at(UU.x, UU.y)->obj = obj(ODEADFOUNTAIN, 0);
+            set_obj_at(UU.x, UU.y, obj(ODEADFOUNTAIN, 0));
         }
         break;
 
@@ -1839,7 +1837,7 @@ obook() {
     char ptext[120];
     snprintf (ptext, sizeof(ptext),
               "Do you %s(t) take it, or (n) do nothing? ",
-              UU.blindCount ? "" : "(g) read it, ");
+              effect_left(EFF_BLIND) ? "" : "(g) read it, ");
 
     switch(prompt(ptext)) {
     case 'n':
@@ -17,6 +17,9 @@
 #include "os.h"
 #include "settings.h"
 #include "version_info.h"
+#include "profile.h"
+#include "allocstats.h"
+#include "trace.h"
 
 
 static bool only_show_scores = false;
@@ -36,6 +39,7 @@ print_help_and_exit() {
         "  -f <fontpath>    path to the font to use (SDL only).",
         "  -p <size>        size of the font to use (SDL only).",
         "  -w <filename>    write scores to a file ('-' for stdout)",
+        "  -t <tracefile>   record a Chrome trace of the session",
         NULL
     };
 
@@ -52,7 +56,7 @@ print_help_and_exit() {
 
 static void
 parse_args(int argc, char *argv[]) {
-    const char *optstring = "bsivhro:f:p:w:";
+    const char *optstring = "bsivhro:f:p:w:t:";
 
     while (true) {
         int i = getopt(argc, argv, optstring);
@@ -89,6 +93,11 @@ parse_args(int argc, char *argv[]) {
                     sizeof(GameSettings.fontPath));
             break;
 
+        case 't':
+            zstrncpy(GameSettings.traceFile, optarg,
+                     sizeof(GameSettings.traceFile));
+            break;
+
         case 'p': {
             int sz = atoi(optarg);
             if (sz <= 0) {
@@ -155,17 +164,27 @@ main (int argc, char *argv[]) {
     /* Initialize the global options struct. */
     initopts();
 
-    /* Initialize store datastructs. */
-    initstore();
+    /* Create the game context.  (This also initializes the store.) */
+    gc_bind(gc_new());
 
     // Initialize the randomizer seed
-    srandom(get_random_seed());
+    seed_rng(get_random_seed());
 
     /* Read the settings file, then parse the argument list (in that
      * order so the command-line can override defaults). */
     readopts(cfgfile_path());
     parse_args(argc, argv);
 
+    // Start the session trace if requested.
+    if (GameSettings.traceFile[0]) {
+        if (!trace_start(GameSettings.traceFile)) {
+            printf("Unable to create trace file '%s'\n",
+                   GameSettings.traceFile);
+            exit(1);
+        }// if
+        atexit(trace_stop);
+    }// if
+
     // Handle the '-s' or '-i' options.
     if (only_show_scores) {
         display_scores_and_quit();
@@ -207,6 +226,11 @@ main (int argc, char *argv[]) {
     force_full_update();
     update_display();   /*  show the initial dungeon */
 
+    // Write out the turn profile and allocation statistics (if
+    // requested) however we exit.
+    atexit(prof_write_file);
+    atexit(alloc_write_file);
+
     // Save during unexpected exits.  (Call cancel_emergency_save() to
     // disable this before a normal exit.)
     atexit(emergency_save);
@@ -14,13 +14,19 @@
 #include "version_info.h"
 #include "ui.h"
 #include "savegame.h"
+#include "trace.h"
+#include "pregen.h"
+#include "arena.h"
 
 #include "map.h"
 
 #include <errno.h>
+#include <stdarg.h>
+#include <string.h>
 
 
 static void newcavelevel (void);
+static void start_neighbours(void);
 static void makemaze(int lev);
 static bool cannedlevel(int lev);
 static void treasureroom(int lv);
@@ -34,8 +40,8 @@ static void sethp(bool firstVisit);
 static void checkban(void);
 static void eat(int xx, int yy);
 
-// State of the game:
-struct World W = {-1};
+// State of the game (in the game context):
+#define W (GameCtx->world)
 
 
 /* Return the current level. -1 means the map hasn't been created yet. */
@@ -97,7 +103,12 @@ get_level_copy_at(int index, struct Level *lev) {
 // This is used when loading saved games and nowhere else.
 void
 restore_global_world_from(const struct World *aWholeNewWorld) {
+    pregen_discard(GameCtx);
     W = *aWholeNewWorld;
+    for (int n = 0; n < NLEVELS; n++) {
+        GameCtx->objIndex[n].valid = false;
+    }// for
+    GameCtx->levelSeed = 0;
 }// restore_global_world_from
 
 // Copy W to *worldCopy.  This should only ever be used as part of
@@ -121,7 +132,7 @@ getlevelname() {
 /* destroy object at present location */
 void
 udelobj() {
-    at(UU.x, UU.y)->obj = NULL_OBJ;
+    set_obj_at(UU.x, UU.y, NULL_OBJ);
     see_and_update_fov();
 }/* udelobj*/
 
@@ -184,6 +195,7 @@ deduce_level_knowledge(int newlevel, int oldlevel) {
 
 void
 setlevel(int newlevel, bool identify) {
+    trace_begin("setlevel");
 
     // Set the 'known' flags if appropriate
     if (identify) {
@@ -197,14 +209,20 @@ setlevel(int newlevel, bool identify) {
 
     /* restore the new level if it exists. */
     if (lev()->exists) {
+        free_cells_begin();
         sethp(false);
+        free_cells_end();
+        positionplayer();
         checkban();
-        return;
-    }/* if */
+    } else {
+        /* Otherwise, force the creation of the current level. */
+        newcavelevel();
+    }/* if .. else */
 
-    /* Otherwise, force the creation of the current level. */
-    newcavelevel();
+    // Get a head start on wherever the player goes next.
+    start_neighbours();
 
+    trace_end("setlevel");
 }/* setlevel*/
 
 
@@ -254,32 +272,127 @@ remove_stolen(struct Level *lev) {
 
 /*                     Map creation                       */
 
-/* Create the current cave level.  Must not already exist. */
+// Start building the levels the player can walk to from here (by
+// stairs, volcano shaft or trap door) that don't exist yet.  See
+// pregen.h.
+static void
+start_neighbours() {
+    int lvl = getlevel();
+    int near[2] = {lvl - 1, lvl + 1};
+    if (lvl == 0) {
+        near[0] = 1;
+        near[1] = VTOP;
+    }// if
+
+    for (int n = 0; n < 2; n++) {
+        int nl = near[n];
+        bool sameBranch = lvl == 0 || (nl <= DBOTTOM) == (lvl <= DBOTTOM);
+        if (nl > 0 && nl <= VBOTTOM && sameBranch && !W.levels[nl].exists) {
+            pregen_start(nl);
+        }// if
+    }// for
+}// start_neighbours
+
+
+/* Create the current cave level.  Must not already exist.  The level
+ * itself is built by pregen_get(), which may already have done it in
+ * the background; we just move it into the world and do the parts
+ * that depend on the player. */
 static void
 newcavelevel () {
     ASSERT(!lev()->exists);
+    trace_begin("newcavelevel");
+
+    int lvl = getlevel();
+    struct GameContext *built = pregen_get(lvl);
+
+    // The level is new but the player may already know where it is.
+    bool known = lev()->known;
+    W.levels[lvl] = built->world.levels[lvl];
+    GameCtx->objIndex[lvl].valid = false;
+    lev()->known = known;
+
+    // Building it may have created unique items and elevators.
+    memcpy(UU.created, built->uu.created, sizeof(UU.created));
+    UU.has_up_elevator = built->uu.has_up_elevator;
+    UU.has_down_elevator = built->uu.has_down_elevator;
+
+    if (built->buildNotes[0]) {
+        say("%s", built->buildNotes);
+    }// if
+    pregen_release(built);
+
+    positionplayer();
+
+    if (lvl == 0) {
+        force_full_update();
+    }/* if */
+
+    checkban(); /* wipe out any banished monsters */
+
+    trace_end("newcavelevel");
+}/* newcavelevel */
+
+
+// Build the current level from scratch.  This is the part of
+// newcavelevel() that doesn't depend on the player's whereabouts; it
+// is only ever run by pregen.c, in a context of its own (see
+// pregen.h).
+void
+generate_level() {
+    ASSERT(GameCtx->building && !lev()->exists);
 
     /* Create the maze; either fetch it from a data file or generate
      * it. */
     int lvl = getlevel();
-    if (lvl == 0 || !cannedlevel(lvl)) {
+    bool canned = false;
+    if (lvl != 0) {
+        trace_begin("cannedlevel");
+        canned = cannedlevel(lvl);
+        trace_end("cannedlevel");
+    }// if
+
+    if (!canned) {
+        trace_begin("makemaze");
         makemaze(lvl);
+        trace_end("makemaze");
     }// if
 
     // Forget everything
     set_reveal(false);
 
-    makeobject(getlevel());
+    free_cells_begin();
+    makeobject(lvl);
     lev()->exists = true;   /* first time here */
     sethp(true);
+    free_cells_end();
 
-    if (getlevel() == 0) {
+    if (lvl == 0) {
         set_reveal(true);
-        force_full_update();
     }/* if */
+}// generate_level
 
-    checkban(); /* wipe out any banished monsters */
-}/* newcavelevel */
+
+// Say something about the level being built.  If this is happening
+// in a builder's context (see generate_level()), we keep it to be
+// said when the level is handed over instead.
+static void
+build_say(const char *fmt, ...) {
+    char buf[160];
+    va_list ap;
+    va_start(ap, fmt);
+    vsnprintf(buf, sizeof(buf), fmt, ap);
+    va_end(ap);
+
+    if (!GameCtx->building) {
+        say("%s", buf);
+        return;
+    }// if
+
+    size_t len = strlen(GameCtx->buildNotes);
+    snprintf(GameCtx->buildNotes + len, sizeof(GameCtx->buildNotes) - len,
+             "%s", buf);
+}// build_say
 
 
 /*
@@ -299,7 +412,7 @@ makemaze (int lev) {
         struct Object wallish = lev == 0 ? NULL_OBJ : obj(OWALL, 0);
         for (int i=0; i<MAXY; i++) {
             for (int j=0; j<MAXX; j++) {
-                at(j, i)->obj = wallish;
+                set_obj_at(j, i, wallish);
             }/* for */
         }/* for */
     }
@@ -330,7 +443,7 @@ makemaze (int lev) {
             }
             for (int i = mxl; i < mxh; i++) {
                 for (int j = myl; j < myh; j++) {
-                    at(i, j)->obj = NULL_OBJ;
+                    set_obj_at(i, j, NULL_OBJ);
                     if (z) { at(i, j)->mon = mk_mon(z); }
                 }/* for */
             }/* for */
@@ -340,7 +453,7 @@ makemaze (int lev) {
     if (lev!=DBOTTOM && lev!=VBOTTOM) {
         my = rnd(MAXY-2);
         for (int i = 1; i < MAXX-1; i++) {
-            at(i, my)->obj = NULL_OBJ;
+            set_obj_at(i, my, NULL_OBJ);
         }
     }
 
@@ -363,7 +476,8 @@ remake_map_keeping_contents() {
     } *save;
     int sc = 0;         /* # items saved */
 
-    save = xmalloc(sizeof(struct isave) * MAXX * MAXY * 2);
+    struct ArenaMark scope = arena_mark();
+    save = arena_alloc(sizeof(struct isave) * MAXX * MAXY * 2);
 
     /* save all items and monsters and fill the level with walls */
     for (int y = 0; y < MAXY; y++) {
@@ -383,7 +497,7 @@ remake_map_keeping_contents() {
                 ++sc;
             }/* if */
 
-            pt->obj = obj(OWALL, 0);
+            set_obj_at(x, y, obj(OWALL, 0));
             pt->mon = NULL_MON;
             forget_at(x, y);
         }/* for */
@@ -394,41 +508,35 @@ remake_map_keeping_contents() {
 
     /* Create the exit if this is level 1. */
     if (getlevel() == 1) {
-        at(CAVE_EXIT_X, CAVE_EXIT_Y)->obj = obj(OEXIT, 0);
+        set_obj_at(CAVE_EXIT_X, CAVE_EXIT_Y, obj(OEXIT, 0));
     }
 
     for (int j = rnd(MAXY - 2), i = 1; i < MAXX - 1; i++) {
-        at(i, j)->obj = obj(ONONE, 0);
+        set_obj_at(i, j, obj(ONONE, 0));
     }
 
-    /* put objects back in level */
-    for (; sc >= 0;  --sc) {
-        int tries = 100;
-        int x = 1, y = 1;
-
-        if (save[sc].type == ITEM) {
-            while (--tries > 0 && at(x, y)->obj.type) {
-                x = rnd(MAXX - 1);
-                y = rnd(MAXY - 1);
-            }/* while */
-
-            if (tries) {
-                at(x, y)->obj = save[sc].i.o;
-            }/* if */
-        } else {    /* put monsters back in */
-            while (--tries > 0 && (at(x, y)->obj.type == OWALL
-                                      || at(x, y)->mon.id)) {
-                x = rnd(MAXX - 1);
-                y = rnd(MAXY - 1);
-            }/* while */
-
-            if (tries) {
-                at(x, y)->mon = save[sc].i.m;
+    /* put objects back in level, then the monsters; whatever doesn't
+     * fit is lost */
+    free_cells_begin();
+    for (int pass = ITEM; pass <= MONSTER; pass++) {
+        for (int n = 0; n < sc; n++) {
+            int x, y;
+            if (save[n].type != pass ||
+                !take_free_cell(&x, &y, pass == MONSTER))
+            {
+                continue;
             }/* if */
-        }/* if .. else*/
+
+            if (pass == ITEM) {
+                set_obj_at(x, y, save[n].i.o);
+            } else {
+                at(x, y)->mon = save[n].i.m;
+            }/* if .. else*/
+        }/* for */
     }/* for */
+    free_cells_end();
 
-    free((char *) save);
+    arena_release(scope);
 }// remake_map_keeping_contents
 
 
@@ -446,32 +554,32 @@ eat (int xx, int yy) {
             if (xx <= 2) break; /*  west    */
             if ((at(xx-1, yy)->obj.type!=OWALL) || (at(xx-2, yy)->obj.type!=OWALL))
                 break;
-            at(xx-1, yy)->obj = NULL_OBJ;
-            at(xx-2, yy)->obj = NULL_OBJ;
+            set_obj_at(xx-1, yy, NULL_OBJ);
+            set_obj_at(xx-2, yy, NULL_OBJ);
             eat(xx-2,yy);
             break;
         case 2:
             if (xx >= MAXX-3) break;  /*    east    */
             if ((at(xx+1, yy)->obj.type!=OWALL) || (at(xx+2, yy)->obj.type!=OWALL))
                 break;
-            at(xx+1, yy)->obj = NULL_OBJ;
-            at(xx+2, yy)->obj = NULL_OBJ;
+            set_obj_at(xx+1, yy, NULL_OBJ);
+            set_obj_at(xx+2, yy, NULL_OBJ);
             eat(xx+2,yy);
             break;
         case 3:
             if (yy <= 2) break; /*  south   */
             if ((at(xx, yy-1)->obj.type!=OWALL) || (at(xx, yy-2)->obj.type!=OWALL))
                 break;
-            at(xx, yy-1)->obj = NULL_OBJ;
-            at(xx, yy-2)->obj = NULL_OBJ;
+            set_obj_at(xx, yy-1, NULL_OBJ);
+            set_obj_at(xx, yy-2, NULL_OBJ);
             eat(xx,yy-2);
             break;
         case 4:
             if (yy >= MAXY-3 ) break;   /*north */
             if ((at(xx, yy+1)->obj.type!=OWALL) || (at(xx, yy+2)->obj.type!=OWALL))
                 break;
-            at(xx, yy+1)->obj = NULL_OBJ;
-            at(xx, yy+2)->obj = NULL_OBJ;
+            set_obj_at(xx, yy+1, NULL_OBJ);
+            set_obj_at(xx, yy+2, NULL_OBJ);
             eat(xx,yy+2);
             break;
         };
@@ -522,7 +630,7 @@ cannedlevel(int lev) {
         // refusing to start if the file is missing; then make this a
         // fatal error.  But for now, a subtle error message is
         // easiest.
-        say("%s",
+        build_say("%s",
             UU.wizardMode                   ?
             "Error opening levels file!\n"  :
             "You feel vague existential unease.\n");
@@ -540,14 +648,14 @@ cannedlevel(int lev) {
         int idx = rund(20);
         fseek(fp, (long)(idx * ((MAXX * MAXY)+MAXY+1)), 0);
         if (UU.wizardMode) {
-            say("Loading canned level %d.\n", idx);
+            build_say("Loading canned level %d.\n", idx);
         }
     }
 
     for (int y = 0; y < MAXY; y++) {
         if ((row = fgets(buf, 128, fp)) == (char *)NULL) {
             if (UU.wizardMode) {
-                say("IO error when reading map: %s\n", strerror(errno));
+                build_say("IO error when reading map: %s\n", strerror(errno));
             }
             fclose(fp);
             return false;
@@ -584,7 +692,7 @@ cannedlevel(int lev) {
                 nob = newobject(lev+1);
                 break;
             };
-            at(x, y)->obj = nob;
+            set_obj_at(x, y, nob);
             at(x, y)->mon = mk_mon(mit);
         }// for
     }// for
@@ -627,16 +735,16 @@ troom(int lv, int xsize, int ysize, int tx, int ty, enum DOORTRAP_RISK dtr) {
 
     for (j=ty-1; j<=ty+ysize; j++)
         for (i=tx-1; i<=tx+xsize; i++)  /* clear out space for room */
-            at(i, j)->obj = NULL_OBJ;
+            set_obj_at(i, j, NULL_OBJ);
     for (j=ty; j<ty+ysize; j++)
         /* now put in the walls */
         for (i=tx; i<tx+xsize; i++) {
-            at(i, j)->obj = obj(OWALL, 0);
+            set_obj_at(i, j, obj(OWALL, 0));
             at(i, j)->mon = NULL_MON;
         }
     for (j=ty+1; j<ty+ysize-1; j++)
         for (i=tx+1; i<tx+xsize-1; i++) /* now clear out interior */
-            at(i, j)->obj = NULL_OBJ;
+            set_obj_at(i, j, NULL_OBJ);
 
     /* locate the door on the treasure room */
     switch(rnd(2))  {
@@ -644,13 +752,13 @@ troom(int lv, int xsize, int ysize, int tx, int ty, enum DOORTRAP_RISK dtr) {
         i = tx + rund (xsize);
         j = ty + (ysize-1) * rund(2);
 
-        at(i, j)->obj = door(dtr);  /* on horizontal walls */
+        set_obj_at(i, j, door(dtr));  /* on horizontal walls */
         break;
     case 2:
         i = tx + (xsize-1)*rund(2);
         j = ty + rund (ysize);
 
-        at(i, j)->obj = door(dtr); /* on vertical walls */
+        set_obj_at(i, j, door(dtr)); /* on vertical walls */
         break;
     }
 
@@ -689,7 +797,7 @@ makestairs(int lev) {
 
     /* Make the cave exit if this is level 1 */
     if (lev == 1) {
-        at(CAVE_EXIT_X, CAVE_EXIT_Y)->obj = obj(OEXIT, 0);
+        set_obj_at(CAVE_EXIT_X, CAVE_EXIT_Y, obj(OEXIT, 0));
     }/* if */
 
     /* stairs down everywhere except V1 and V2 */
@@ -889,27 +997,13 @@ froom(int n, int itm, int arg) {
 
 /*
  *  subroutine to put an object into an empty room
- *  uses a random walk
  */
 static void
 fillroom (struct Object obj) {
-    int x,y;
-
-    x=rnd(MAXX-2);
-    y=rnd(MAXY-2);
-    while (at(x, y)->obj.type) {
-        x += rnd(3)-2;
-        y += rnd(3)-2;
-        if (x > MAXX-2)
-            x=1;
-        if (x < 1)
-            x=MAXX-2;
-        if (y > MAXY-2)
-            y=1;
-        if (y < 1)
-            y=MAXY-2;
-    }
-    at(x, y)->obj = obj;
+    int x, y;
+    if (take_free_cell(&x, &y, false)) {
+        set_obj_at(x, y, obj);
+    }/* if */
 }/* fillroom */
 
 
@@ -948,7 +1042,7 @@ sethp (bool firstVisit) {
         i=getlevel()-10;
         for (j=1;j<=i;j++)
             if (fillmonst(DEMONLORD1+rund(7))==-1)
-                j--;
+                break;      /* no room */
     }
     /*
     ** level V1 gets 1 demon prince
@@ -961,9 +1055,8 @@ sethp (bool firstVisit) {
         i=getlevel()-DBOTTOM;
         for (j=1;j<=i;j++)
             if (fillmonst(DEMONPRINCE)==-1)
-                j--;
+                break;      /* no room */
     }
-    positionplayer();
 }/* sethp */
 
 
@@ -984,27 +1077,223 @@ checkban () {
 }/* checkban */
 
 
-/* Search the current map for the coordinates of an object with type
- * 'type'.  Coordinates are stored at *x, *y and true is returned on
- * success.  If nothing is found, returns false and does not modify *x
- * or *y. */
+//
+// Empty floor
+//
+// Things placed at random go on a cell picked uniformly from the
+// empty floor, i.e. the interior cells with no object or monster.
+// Rather than probing at random (which can take forever on a crowded
+// level, or give up when it needn't), we collect those cells into a
+// set we can pick from and remove from in O(1).
+//
+// Building the set means scanning the map, so code that places a lot
+// of things at once (e.g. level creation) brackets it with
+// free_cells_begin() and free_cells_end(); in between, the set is
+// kept and take_free_cell() updates it.  Otherwise, each call builds
+// it anew.  Code that writes to the map directly doesn't update the
+// set, so each cell is checked again when it's picked.
+//
+
+#define FC (GameCtx->freeCells)
+
+static bool
+is_free_cell(const struct MapSquare *here) {
+    return here->obj.type == ONONE && here->mon.id == NOMONST;
+}// is_free_cell
+
+static void
+free_cells_scan() {
+    const struct Level *lv = lev();
+
+    memset(FC.slot, -1, sizeof(FC.slot));
+    FC.count = 0;
+    for (int x = 1; x < MAXX - 1; x++) {
+        for (int y = 1; y < MAXY - 1; y++) {
+            if (is_free_cell(&lv->map[x][y])) {
+                FC.slot[x * MAXY + y] = FC.count;
+                FC.cells[FC.count++] = x * MAXY + y;
+            }// if
+        }// for
+    }// for
+}// free_cells_scan
+
+static void
+free_cells_swap(int a, int b) {
+    uint16_t tmp = FC.cells[a];
+    FC.cells[a] = FC.cells[b];
+    FC.cells[b] = tmp;
+
+    FC.slot[FC.cells[a]] = a;
+    FC.slot[FC.cells[b]] = b;
+}// free_cells_swap
+
+static void
+free_cells_remove(int slot) {
+    free_cells_swap(slot, FC.count - 1);
+    FC.slot[FC.cells[FC.count - 1]] = -1;
+    FC.count--;
+}// free_cells_remove
+
+
+// Build the set of empty cells on the current level and keep it up
+// to date until free_cells_end().
+void
+free_cells_begin() {
+    free_cells_scan();
+    FC.live = true;
+}// free_cells_begin
+
+void
+free_cells_end() {
+    FC.live = false;
+}// free_cells_end
+
+
+// Pick an empty cell on the current level at random and store it in
+// *x, *y.  If 'forMonster' is true, the player's position is also
+// ruled out.  The cell is removed from the set, so the caller must
+// put something there.  Returns false if there is no such cell.
+bool
+take_free_cell(int *x, int *y, bool forMonster) {
+    if (!FC.live) { free_cells_scan(); }
+
+    for (;;) {
+        // Move the player's cell (if present) out of reach.
+        int count = FC.count;
+        int player = inbounds(UU.x, UU.y) ? FC.slot[UU.x * MAXY + UU.y] : -1;
+        if (forMonster && player >= 0) {
+            free_cells_swap(player, --count);
+        }// if
+
+        if (count == 0) { return false; }
+
+        int slot = rund(count);
+        int cx = FC.cells[slot] / MAXY, cy = FC.cells[slot] % MAXY;
+        free_cells_remove(slot);
+
+        if (is_free_cell(at(cx, cy))) {
+            *x = cx;
+            *y = cy;
+            return true;
+        }// if
+    }// for
+}// take_free_cell
+
+
+//
+// Object index
+//
+// For each level, the cells holding each type of object (apart from
+// ONONE), so that findobj() needn't search the map and code that
+// wants, say, every gold pile can go straight to them.  set_obj_at()
+// keeps the current level's index up to date, so all changes to the
+// objects on the map must go through it.
+//
+// Code that replaces a whole level at once (installing a newly built
+// one, restoring a saved game) marks its index invalid instead, and
+// it's rebuilt from the map the next time it's needed.  The saved
+// game doesn't include it.
+//
+
+#define OI (GameCtx->objIndex[W.levelNum])
+
+static inline int
+cell_id(int x, int y) {
+    return 1 + x * MAXY + y;
+}// cell_id
+
+static void
+index_add(struct ObjIndex *oi, uint8_t type, int cell) {
+    int first = oi->head[type];
+    oi->next[cell] = first;
+    oi->prev[cell] = 0;
+    if (first) { oi->prev[first] = cell; }
+    oi->head[type] = cell;
+}// index_add
+
+static void
+index_remove(struct ObjIndex *oi, uint8_t type, int cell) {
+    int next = oi->next[cell], prev = oi->prev[cell];
+    if (prev) { oi->next[prev] = next; } else { oi->head[type] = next; }
+    if (next) { oi->prev[next] = prev; }
+}// index_remove
+
+// Return the current level's index, building it first if need be.
+static const struct ObjIndex *
+obj_index() {
+    struct ObjIndex *oi = &OI;
+    if (oi->valid) { return oi; }
+
+    memset(oi->head, 0, sizeof(oi->head));
+
+    // Add the cells last to first so that each list starts in the
+    // order the map used to be searched (by row, then column).
+    const struct Level *lv = lev();
+    for (int y = MAXY - 1; y >= 0; y--) {
+        for (int x = MAXX - 1; x >= 0; x--) {
+            uint8_t type = lv->map[x][y].obj.type;
+            if (type != ONONE) { index_add(oi, type, cell_id(x, y)); }
+        }// for
+    }// for
+
+    oi->valid = true;
+    return oi;
+}// obj_index
+
+
+// Put 'thing' at x, y on the current level in place of whatever was
+// there.
+void
+set_obj_at(int x, int y, struct Object thing) {
+    struct MapSquare *here = at(x, y);
+    struct ObjIndex *oi = &OI;
+
+    uint8_t was = here->obj.type;
+    if (oi->valid && was != thing.type) {
+        int cell = cell_id(x, y);
+        if (was != ONONE) { index_remove(oi, was, cell); }
+        if (thing.type != ONONE) { index_add(oi, thing.type, cell); }
+    }// if
+
+    here->obj = thing;
+}// set_obj_at
+
+
+/* Find an object of type 'type' on the current map.  Coordinates are
+ * stored at *x, *y and true is returned on success.  If there's none,
+ * returns false and does not modify *x or *y. */
 bool
 findobj(uint8_t type, int8_t *x, int8_t *y) {
-    int8_t ix, iy;
-    for (iy=0; iy < MAXY; iy++) {
-        for (ix = 0; ix < MAXX; ix++) {
-            if (at(ix, iy)->obj.type == type) {
-                *x = ix;
-                *y = iy;
-                return true;
-            }/* if */
-        }/* for */
-    }/* for */
+    ASSERT(type < OBJ_COUNT && type != ONONE);
+
+    int cell = obj_index()->head[type];
+    if (!cell) { return false; }
 
-    return false;
+    *x = (cell - 1) / MAXY;
+    *y = (cell - 1) % MAXY;
+    return true;
 }/* findobj*/
 
 
+// Step through the objects of type 'type' on the current level.  Set
+// *cursor to 0 to start; each call stores the next one's position at
+// *x, *y and returns true until there are no more.  The map mustn't
+// be changed along the way.
+bool
+next_obj_of(uint8_t type, int *cursor, int *x, int *y) {
+    ASSERT(type < OBJ_COUNT && type != ONONE);
+
+    const struct ObjIndex *oi = obj_index();
+    int cell = *cursor ? oi->next[*cursor] : oi->head[type];
+    if (!cell) { return false; }
+
+    *cursor = cell;
+    *x = (cell - 1) / MAXY;
+    *y = (cell - 1) % MAXY;
+    return true;
+}// next_obj_of
+
+
 /* Check x,y if it is safe to place either a new item or
  * monster. `itm` or `monst` determine which.  At least one must be
  * true. */
@@ -1108,9 +1397,9 @@ createitem(int baseX, int baseY, struct Object item) {
     int x = 0, y = 0;
     int radius = point_near(baseX, baseY, &x, &y, true, false);
     if (radius >= 0) {
-        at(x, y)->obj = item;
+        set_obj_at(x, y, item);
     } else {
-        say("You seen an object begin to form, then disappear.\n");
+        build_say("You seen an object begin to form, then disappear.\n");
     }// if
 }/* createitem*/
 
@@ -48,8 +48,8 @@ struct Level {
     unsigned numStolen;
 };
 
-// The game world state.  (Note: the main instance is private to
-// map.c)
+// The game world state.  (Note: the main instance is in the game
+// context but only map.c should touch it.)
 struct World {
     int levelNum;                       // Current level (-1 for none)
     struct Level levels[NLEVELS];       // The levels
@@ -66,12 +66,18 @@ bool known_at(int x, int y);
 int getlevel(void);
 const char *getlevelname(void);
 void setlevel(int newlevel, bool identify);
+void generate_level(void);
 bool savegame_to_file(FILE *fh);
 bool restore_from_file(FILE *fh, bool *wrongFileVersion);
 void init_cells(void);
 void add_to_stolen(struct Object thing);
 struct Object remove_stolen(struct Level *lev);
+void set_obj_at(int x, int y, struct Object thing);
 bool findobj(uint8_t type, int8_t *x, int8_t *y);
+bool next_obj_of(uint8_t type, int *cursor, int *x, int *y);
+void free_cells_begin(void);
+void free_cells_end(void);
+bool take_free_cell(int *x, int *y, bool forMonster);
 void remake_map_keeping_contents(void);
 void createitem(int x, int y, struct Object item);
 void create_rnd_item(int x, int y, int lev);
@@ -101,4 +107,14 @@ static inline bool inbounds(int x, int y) {
     return x >= 0 && x < MAXX && y >= 0 && y < MAXY;
 }
 
+// Return the number of steps that can be taken from (x, y) in
+// direction (dx, dy) (each -1, 0 or 1) before leaving the map.  This
+// lets code that walks in a straight line count down instead of
+// checking the bounds at each step.
+static inline int ray_length(int x, int y, int dx, int dy) {
+    int nx = dx > 0 ? MAXX - 1 - x  : dx < 0 ? x : MAXX;
+    int ny = dy > 0 ? MAXY - 1 - y  : dy < 0 ? y : MAXX;
+    return nx < ny ? nx : ny;
+}
+
 #endif
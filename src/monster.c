@@ -52,7 +52,7 @@ avoidspits(struct Monster mon) {
 bool
 cantsee(struct Monster mon) {
     return (isdemon(mon) && !UU.hasTheEyeOfLarn) ||
-        (!UU.seeinvisible && (monflags(mon) & FL_INVISIBLE));
+        (!effect_left(EFF_SEEINVISIBLE) && (monflags(mon) & FL_INVISIBLE));
 }/* return */
 
 
@@ -140,7 +140,7 @@ monname_at(int x, int y) {
 const char *
 monname(uint8_t id) {
     ASSERT(id <= LAST_MONSTER);
-    return UU.blindCount ? "monster" : MonType[id].name;
+    return effect_left(EFF_BLIND) ? "monster" : MonType[id].name;
 }// monname
 
 
@@ -156,7 +156,7 @@ void
 hit_mon_melee(int x, int y) {
     int damag;
 
-    if (UU.timestop) { return; }     /* not if time stopped */
+    if (effect_left(EFF_TIMESTOP)) { return; }     /* not if time stopped */
 
     if (!inbounds(x, y)) { return; } // This should be an assert.
 
@@ -194,10 +194,10 @@ hit_mon_melee(int x, int y) {
         if ( (canrust(wld) && wld.iarg > RUST_MIN) || wld.iarg > 0) {
             say("Your weapon is dulled by the %s.\n", mname);
             headsup();
-            --Invent[UU.wield].iarg;
+            inv_adjust_iarg(UU.wield, -1);
         } else if (canrust(wld) && Invent[UU.wield].iarg <= RUST_MIN) {
             say("Your weapon disintegrates!\n");
-            Invent[UU.wield] = obj(ONONE, 0);
+            inv_set(UU.wield, obj(ONONE, 0));
             UU.wield = -1;
             didhit = false; /* Didn't hit after all... */
         }/* if */
@@ -267,7 +267,7 @@ hitm(int x, int y, int amt, bool is_melee) {
     const char *mname = monname(mon_id);
 
     /* if half damage curse adjust damage points */
-    if (UU.halfdam) { amt >>= 1; }
+    if (effect_left(EFF_HALFDAM)) { amt >>= 1; }
     if (amt <= 0) { amt2 = amt = 1; }
 
     // Mark this monster as being angry
@@ -275,7 +275,7 @@ hitm(int x, int y, int amt, bool is_melee) {
 
     /* make sure hitting monst breaks stealth condition */
     at(x, y)->mon.awake = 1;
-    UU.holdmonst = 0;   /* hit a monster breaks hold monster spell */
+    effect_set(EFF_HOLDMONST, 0); /* hit a monster breaks hold monster spell */
 
     /* if a dragon and orb(s) of dragon slaying  */
     if (has_a(OORBOFDRAGON) && isdragon(*monst)) {
@@ -358,14 +358,14 @@ hitplayer (const int x, const int y) {
     }
 
     if (mster < DEMONLORD1)
-        if (UU.invisibility && rnd(33)<20) {
+        if (effect_left(EFF_INVISIBILITY) && rnd(33)<20) {
             say("The %s misses wildly!\n",mname);
             return;
         }
 
     // If the player has Charm Monster and the monster isn't immune,
     // the monster may be charmed out of the attack.
-    if (UU.charmcount               &&
+    if (effect_left(EFF_CHARM)               &&
         mster < DEMONLORD1          &&
         mster != PLATINUMDRAGON     &&
         rnd(30) + 5*MonType[mster].level - charisma() < 30)
@@ -383,7 +383,7 @@ hitplayer (const int x, const int y) {
     /* demon lords/prince/god of hellfire damage is reduced if wielding
        Slayer */
     if (mster >= DEMONLORD1)
-        if (Invent[UU.wield].type==OSLAYER)
+        if (wielding(OSLAYER))
             dam=(int) (1 - (0.1 * rnd(5)) * dam);
 
     /* spirit naga's and poltergeist's damage is halved if scarab of
@@ -391,14 +391,14 @@ hitplayer (const int x, const int y) {
     if (
         (mster == POLTERGEIST || mster == SPIRITNAGA )
         &&
-        (has_a(OSPIRITSCARAB) || UU.spiritpro)
+        (has_a(OSPIRITSCARAB) || effect_left(EFF_SPIRITPRO))
         )
     {
         dam = (int) dam/2;
     }
 
     /*  halved if undead and cube of undead control */
-    if (has_a(OCUBE_of_UNDEAD) || UU.undeadpro)
+    if (has_a(OCUBE_of_UNDEAD) || effect_left(EFF_UNDEADPRO))
         if ((mster ==VAMPIRE) || (mster ==WRAITH) || (mster ==ZOMBIE))
             dam = (int) dam/2;
 
@@ -545,7 +545,7 @@ spattack(enum SP_ATTACK attack, const int xx, const int yy) {
     /*
      * cancel only works 5% of time for demon prince and god
      */
-    if (UU.cancellation) {
+    if (effect_left(EFF_CANCELLATION)) {
         if (monst >= DEMONPRINCE) {
             if (rnd(100) >= 95)
                 return false;
@@ -566,7 +566,7 @@ spattack(enum SP_ATTACK attack, const int xx, const int yy) {
 
     /* if have cube of undead control,  wraiths and vampires do nothing */
     if ((monst == WRAITH) || (monst == VAMPIRE))
-        if (has_a(OCUBE_of_UNDEAD) || (UU.undeadpro))
+        if (has_a(OCUBE_of_UNDEAD) || (effect_left(EFF_UNDEADPRO)))
             return false;
 
     char *p = NULL;
@@ -586,7 +586,7 @@ spattack(enum SP_ATTACK attack, const int xx, const int yy) {
         if (!is_lesser_attack) i = rnd(20) + 25 - defense();
 
         say ("The %s breathes fire at you!\n", mname);
-        if (UU.fireresistance) {
+        if (effect_left(EFF_FIRERESISTANCE)) {
             if (rnd(15) != 7) {
                 say ("The %s's flame doesn't faze you!\n", mname);
             } else {
@@ -683,10 +683,8 @@ spattack(enum SP_ATTACK attack, const int xx, const int yy) {
                 continue;
             }/* if */
 
-            Invent[index].iarg -= 3;
-            if (Invent[index].iarg < 0) {
-                Invent[index].iarg = 0;
-            }/* if */
+            target.iarg = max(0, target.iarg - 3);
+            inv_set(index, target);
 
             say("The %s hits you with a spell of disenchantment! \n",
                     mname);
@@ -707,7 +705,7 @@ spattack(enum SP_ATTACK attack, const int xx, const int yy) {
         return false;
 
     case SA_CONFUSE:
-        UU.confuse += 10 + rnd(10);
+        effect_add(EFF_CONFUSE, 10 + rnd(10));
         say ("The %s has confused you.\n", mname);
         headsup();
         break;
@@ -786,7 +784,7 @@ rustattack(const char *monster) {
     /* Rust the thing if possible. A 0 maxrust means it's rustproof.*/
     maxrust = -Types[ Invent[rustable].type ].maxrust;
     if (maxrust < 0 && Invent[rustable].iarg > maxrust) {
-        --Invent[rustable].iarg;
+        inv_adjust_iarg(rustable, -1);
         rusted = true;
     }/* if */
 
@@ -885,7 +883,7 @@ randmonst () {
     int level;
 
     /*  don't make monsters if time is stopped  */
-    if (UU.timestop)
+    if (effect_left(EFF_TIMESTOP))
         return;
 
     level = getlevel();
@@ -900,21 +898,15 @@ randmonst () {
 }/* randmonst */
 
 
-// Place monster with ID `what` at a suitable location on the current map.  Return
+// Place monster with ID `what` at a random empty spot on the current
+// map.  Return 0 on success or -1 if there's no room.
 int
 fillmonst (int what) {
+    int x, y;
+    if (!take_free_cell(&x, &y, true)) {
+        return -1; /* creation failure */
+    }// if
 
-    /* max # of creation attempts */
-    for (int trys = 10; trys > 0; --trys) {
-        int x = rnd(MAXX-2);
-        int y = rnd(MAXY-2);
-        if (at(x, y)->obj.type == 0 && at(x, y)->mon.id == 0 &&
-            (UU.x != x || UU.y != y))
-        {
-            at(x, y)->mon = mk_mon(what);
-            return 0;
-        }// if
-    }// for
-
-    return -1; /* creation failure */
+    at(x, y)->mon = mk_mon(what);
+    return 0;
 }/* fillmonst */
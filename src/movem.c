@@ -32,8 +32,9 @@ static void clearmoved(int8_t mvtop, int8_t mvbot, int8_t mvleft, int8_t mvright
    monster to it.
 
  */
-static uint8_t lasthx = 0, lasthy = 0;
-static uint8_t lastlevel = -1; /* coords invalid unless lastlevel==curr lvl */
+#define lasthx      (GameCtx->lasthx)
+#define lasthy      (GameCtx->lasthy)
+#define lastlevel   (GameCtx->lastlevel) /* coords invalid unless lastlevel==curr lvl */
 
 void
 lasthit(uint8_t x, uint8_t y) {
@@ -65,16 +66,17 @@ movemonst() {
     int8_t mvtop, mvbot, mvleft, mvright, distance;
 
     /* no action if time is stopped */
-    if (UU.timestop) return;
+    if (effect_left(EFF_TIMESTOP)) return;
 
     /* Skip alterate turns if the user is fast. */
-    if (UU.hasteSelf && (UU.hasteSelf & 1) == 0)  return;
+    int32_t haste = effect_left(EFF_HASTESELF);
+    if (haste && (haste & 1) == 0)  return;
 
     /* move the spheres of annihilation if any */
     updatespheres(&UU.spherelist);
 
     /* no action if monsters are held */
-    if (UU.holdmonst) return;
+    if (effect_left(EFF_HOLDMONST)) return;
 
     /* determine window of monsters to move */
     setmovewin(&mvtop, &mvbot, &mvleft, &mvright, &distance);
@@ -92,7 +94,9 @@ movemonst() {
 
             /* Move the monster unless it's sleeping, player is
              * stealthed and non-aggraviting. */
-            if (at(x, y)->mon.awake || UU.aggravate || !UU.stealth) {
+            if (at(x, y)->mon.awake || effect_left(EFF_AGGRAVATE) ||
+                !effect_left(EFF_STEALTH))
+            {
                 movemt(x, y, mvleft, mvright, mvtop, mvbot, distance);
             }
         }/* for */
@@ -110,8 +114,8 @@ static void
 setmovewin(int8_t *top, int8_t *bot, int8_t *left, int8_t *right, int8_t *distance) {
 
     // Aggravation increases the window size
-    const uint8_t xdiff = UU.aggravate ? 10 : 5;
-    const uint8_t ydiff = UU.aggravate ? 3  : 5;
+    const uint8_t xdiff = effect_left(EFF_AGGRAVATE) ? 10 : 5;
+    const uint8_t ydiff = effect_left(EFF_AGGRAVATE) ? 3  : 5;
 
     // Set the window
     *top       = UU.y - ydiff;
@@ -120,7 +124,7 @@ setmovewin(int8_t *top, int8_t *bot, int8_t *left, int8_t *right, int8_t *distan
     *right     = UU.x + xdiff + 1;
 
     // Set the distance
-    *distance = UU.aggravate ? 40 : 17;
+    *distance = effect_left(EFF_AGGRAVATE) ? 40 : 17;
 
     /* Constrain the window to the map. */
     clip(left, top);
@@ -153,7 +157,7 @@ movescared(int x, int y) {
     /* Determine if the monster is scared. */
     int fearlvl = (int)has_a(OHANDofFEAR);
     if (fearlvl && rnd(10) > 4)     fearlvl = 0;
-    if (fearlvl && UU.scaremonst)   fearlvl += 1;
+    if (fearlvl && effect_left(EFF_SCAREMONST))   fearlvl += 1;
     if (mon_id > DEMONLORD1 || mon_id == PLATINUMDRAGON) {
         fearlvl = (fearlvl == 1) ? 0 : (rnd(10) > 5);
     }/* if */
@@ -508,7 +512,7 @@ checkleprechaun(int xdest, int ydest) {
     if (mon.id != LEPRECHAUN) return;
     if (isshiny(dob) && lev()->numStolen < (2*MAX_STOLEN)/3) {
         add_to_stolen(dob);
-        at(xdest, ydest)->obj = NULL_OBJ;
+        set_obj_at(xdest, ydest, NULL_OBJ);
     }/* if */
 }/* checkleprechaun*/
 
@@ -557,7 +561,7 @@ checkpointy(int xdest, int ydest) {
     at(xdest, ydest)->mon = new_mon;
 
     /* Print the message. */
-    if (!UU.blindCount) {
+    if (!effect_left(EFF_BLIND)) {
         say(what, who, monname_mon(mon));
     }/* if */
 }/* checkpointy*/
@@ -582,7 +586,7 @@ checkzapper(int xdest, int ydest) {
         return;
     }/* if .. else*/
 
-    if (!UU.blindCount) {
+    if (!effect_left(EFF_BLIND)) {
         say(what, monname_mon(mon));
     }/* if */
 }/* checkzapper*/
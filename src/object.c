@@ -49,7 +49,7 @@ banksellvalue(struct Object obj) {
  * call to objname(). */
 const char *
 longobjname (struct Object obj) {
-    static char desc[80];
+    static __thread char desc[80];
 
     ASSERT (obj.type < OBJ_COUNT);
 
@@ -184,7 +184,7 @@ read_scroll(struct Object scr) {
         return;
 
     case OSAGGMONST:
-        UU.aggravate+=800;
+        effect_add(EFF_AGGRAVATE, 800);
         return;
 
     case OSTIMEWARP:
@@ -211,11 +211,11 @@ read_scroll(struct Object scr) {
         return;
 
     case OSAWARENESS:
-        UU.awareness += 1800;
+        effect_add(EFF_AWARENESS, 1800);
         return;
 
     case OSHASTEMONST:
-        UU.hastemonst += rnd(55)+12;
+        effect_add(EFF_HASTEMONST, rnd(55)+12);
         say("You feel nervous.\n");
         return;
 
@@ -225,15 +225,15 @@ read_scroll(struct Object scr) {
         return;
 
     case OSSPIRITPROT:
-        UU.spiritpro += 300 + rnd(200);
+        effect_add(EFF_SPIRITPRO, 300 + rnd(200));
         return;
 
     case OSUNDEADPROT:
-        UU.undeadpro += 300 + rnd(200);
+        effect_add(EFF_UNDEADPRO, 300 + rnd(200));
         return;
 
     case OSSTEALTH:
-        UU.stealth += 250 + rnd(250);
+        effect_add(EFF_STEALTH, 250 + rnd(250));
         return;
 
     case OSMAGICMAP:
@@ -245,7 +245,7 @@ read_scroll(struct Object scr) {
         return;
 
     case OSHOLDMONST:
-        UU.holdmonst += 30;
+        effect_add(EFF_HOLDMONST, 30);
         return;
 
     case OSGEMPERFECT:
@@ -258,7 +258,7 @@ read_scroll(struct Object scr) {
             j *= 2;
             if (j <= 0 && Invent[i].iarg)
                 j=2550;
-            Invent[i].iarg = j;
+            inv_adjust_iarg(i, j - Invent[i].iarg);
         }
         break;
 
@@ -295,33 +295,28 @@ read_scroll(struct Object scr) {
  */
 void
 removecurse () {
-    int i;
-    static int32_t *curse[] = {
-        &UU.blindCount, &UU.confuse, &UU.aggravate, &UU.hastemonst,
-        &UU.itching, &UU.clumsiness, &UU.halfdam,
-        NULL
+    static const enum EFFECT curse[] = {
+        EFF_BLIND, EFF_CONFUSE, EFF_AGGRAVATE, EFF_HASTEMONST,
+        EFF_ITCHING, EFF_CLUMSINESS, EFF_HALFDAM,
     };
 
-    for (i=0; curse[i]; i++) {
-        if (*(curse[i])) {
-            *(curse[i]) = 1;
+    for (size_t i = 0; i < sizeof(curse)/sizeof(curse[0]); i++) {
+        if (effect_left(curse[i])) {
+            effect_set(curse[i], 1);
         }/* if */
     }/* for */
 }/* removecurse */
 
 static void
 extendspells () {
-    int i;
-    static int32_t *exten[] = {
-        &UU.protectionTime, &UU.dexCount, &UU.strcount, &UU.charmcount,
-        &UU.invisibility, &UU.cancellation, &UU.hasteSelf, &UU.globe,
-        &UU.scaremonst, &UU.holdmonst, &UU.timestop,
-
-        NULL
+    static const enum EFFECT exten[] = {
+        EFF_PROTECTION, EFF_DEXCOUNT, EFF_STRCOUNT, EFF_CHARM,
+        EFF_INVISIBILITY, EFF_CANCELLATION, EFF_HASTESELF, EFF_GLOBE,
+        EFF_SCAREMONST, EFF_HOLDMONST, EFF_TIMESTOP,
     };
 
-    for (i=0; exten[i]; i++) {
-        *(exten[i]) <<= 1;
+    for (size_t i = 0; i < sizeof(exten)/sizeof(exten[0]); i++) {
+        effect_set(exten[i], 2 * (int64_t)effect_left(exten[i]));
     }/* for */
 }/* extendspells */
 
@@ -367,7 +362,7 @@ ignore() {
 void
 closedoor() {
     /* can't find objects is time is stopped*/
-    if (UU.timestop)  return;
+    if (effect_left(EFF_TIMESTOP))  return;
 
     int i = at(UU.x, UU.y)->obj.type;
     if (i != OOPENDOOR) {
@@ -377,7 +372,7 @@ closedoor() {
     
     say("The door closes.\n");
     udelobj();
-    at(UU.x, UU.y)->obj = obj(OCLOSEDDOOR, 0);
+    set_obj_at(UU.x, UU.y, obj(OCLOSEDDOOR, 0));
     cancel_look(); /* So we won't be asked to open it */
 }/* closedoor*/
 
@@ -563,7 +558,7 @@ void
 show_cookie() {
     char *read, *ftext;
 
-    if (UU.blindCount) {
+    if (effect_left(EFF_BLIND)) {
         read = ".\nUnfortunately being blind, you can't read it.";
         ftext = "";
     } else {
@@ -11,6 +11,7 @@
 #include "player.h"
 #include "savegame.h"
 #include "game.h"
+#include "trace.h"
 
 #ifdef __WIN32__
 #   include "os_windows.h"
@@ -32,7 +33,9 @@
 //
 // Names of various game files
 //
-#define SCORENAME       "Relarn-scoreboard"
+#define SCORENAME       "Relarn-scoreboard"     // Old text format
+#define SCOREDATA       "Relarn-scores.dat"
+#define SCOREINDEX      "Relarn-scores.idx"
 #define HELPNAME        "Uhelp"
 #define INTRONAME       "Uintro"
 #define LEVELSNAME      "Umaps"
@@ -287,6 +290,18 @@ scoreboard_path() {
     return make_path(path, sizeof(path), PATHS.inst_root, PATHS.var, SCORENAME);
 }// scoreboard_path
 
+const char *
+scoredata_path() {
+    static char path[MAXPATHLEN];
+    return make_path(path, sizeof(path), PATHS.inst_root, PATHS.var, SCOREDATA);
+}// scoredata_path
+
+const char *
+scoreindex_path() {
+    static char path[MAXPATHLEN];
+    return make_path(path, sizeof(path), PATHS.inst_root, PATHS.var, SCOREINDEX);
+}// scoreindex_path
+
 
 
 const char *
@@ -399,14 +414,18 @@ save_game() {
         return SS_FAILED;
     }
 
+    trace_begin("save_game");
+
     bool moveSuccess = rotate_save();
 
     FILE *fh = fopen(sp, "wb");
-    if (!fh) { return SS_FAILED; }
-
-    int status = save_stashed_game_to_file(fh);
+    int status = 0;
+    if (fh) {
+        status = save_stashed_game_to_file(fh);
+        fclose(fh);
+    }// if
 
-    fclose(fh);
+    trace_end("save_game");
 
     if (!status) {
         return SS_FAILED;
@@ -496,7 +515,24 @@ lock_file(FILE *fh) {
 }// lock_file
 
 
-// Unlock a file previously locked iwth lock_file().
+// Like lock_file() but obtains a shared lock, so any number of
+// readers can hold it at once but a lock_file() caller will wait for
+// all of them (and vice versa).  'fh' need only be open for reading.
+bool
+lock_file_shared(FILE *fh) {
+    int status = os_lockf_shared(fileno(fh));
+
+    if (status != 0) {
+        notify("Error obtaining file lock: %s\n", strerror(errno));
+        return false;
+    }
+
+    return true;
+}// lock_file_shared
+
+
+// Unlock a file previously locked iwth lock_file() or
+// lock_file_shared().
 void
 unlock_file(FILE *fh) {
     int fnum = fileno(fh);
@@ -9,6 +9,7 @@
 #ifndef HDR_GUARD_OS_H
 #define HDR_GUARD_OS_H
 
+#include <pthread.h>
 #include <stdbool.h>
 #include <stdio.h>
 
@@ -40,7 +41,9 @@ const char *intro_path(void);
 const char *help_path(void);
 const char *icon_path(void);
 const char *font_path(void);
-const char *scoreboard_path(void);
+const char *scoreboard_path(void);     // Old text-format scoreboard
+const char *scoredata_path(void);
+const char *scoreindex_path(void);
 
 
 void init_os(const char *binpath);
@@ -53,6 +56,7 @@ bool rotate_save(void);
 void delete_save_files(void);
 
 bool lock_file(FILE *fh);
+bool lock_file_shared(FILE *fh);
 void unlock_file(FILE *fh);
 
 unsigned long get_random_seed(void);
@@ -60,6 +64,8 @@ unsigned long get_random_seed(void);
 int os_setenv(const char *name, const char *value, int overwrite);
 int os_unsetenv(const char *name);
 
+int os_start_thread(pthread_t *thread, void *(*start)(void *), void *arg);
+
 
 static inline bool ss_success(enum SAVE_STATUS ss) {
     return ss == SS_SUCCESS || ss == SS_RENAME_FAILED || ss == SS_USED_BACKUP;
@@ -8,6 +8,7 @@
 #include "constants.h"
 #include "internal_assert.h"
 
+#include <pthread.h>
 #include <signal.h>
 #include <unistd.h>
 
@@ -69,6 +70,22 @@ setup_signals() {
     signal(SIGHUP, exit_by_signal);
 }// setup_signals
 
+// Like pthread_create() except that the new thread starts with all
+// signals blocked.  The signals caught above must be handled by the
+// thread playing the game, since the emergency save at exit only
+// sees the game context bound to the thread that calls exit().
+int
+os_start_thread(pthread_t *thread, void *(*start)(void *), void *arg) {
+    sigset_t all, old;
+    sigfillset(&all);
+    pthread_sigmask(SIG_SETMASK, &all, &old);
+
+    int status = pthread_create(thread, NULL, start, arg);
+
+    pthread_sigmask(SIG_SETMASK, &old, NULL);
+    return status;
+}// os_start_thread
+
 
 int
 os_setenv(const char *name, const char *value, int overwrite){
@@ -8,6 +8,7 @@
 
 #include <sys/stat.h>
 #include <unistd.h>
+#include <fcntl.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
@@ -38,6 +39,15 @@ static inline void os_get_user_id(char *uid, size_t uid_size) {
 // closing respectively.
 static inline int os_lockf(int fnum) { return lockf(fnum, F_LOCK, 0); }
 static inline int os_unlockf(int fnum) { return lockf(fnum, F_ULOCK, 0); }
+
+// Shared (read) lock from the current position to the end of the
+// file.  Unlike os_lockf(), 'fnum' only needs to be open for reading.
+// Released by os_unlockf().
+static inline int os_lockf_shared(int fnum) {
+    struct flock fl = { .l_type = F_RDLCK, .l_whence = SEEK_CUR,
+                        .l_start = 0, .l_len = 0 };
+    return fcntl(fnum, F_SETLKW, &fl);
+}
 static inline int os_unlink(const char *filename) { return unlink(filename); }
 static inline bool os_win_debug(void) { return false; }
 
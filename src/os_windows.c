@@ -55,6 +55,13 @@ os_lockf(int fnum) {
     return _locking(fnum, _LK_LOCK, LOCK_FILE_RANGE);
 }
 
+// _locking() has no shared mode so readers just get an exclusive
+// lock.
+int
+os_lockf_shared(int fnum) {
+    return os_lockf(fnum);
+}
+
 int
 os_unlockf(int fnum) {
     // Locking happens at the current file position, so we need to
@@ -94,6 +101,12 @@ os_unsetenv(const char *name) {
     return os_setenv(name, "", 1);
 }// unsetenv
 
+// No signals to keep away from the new thread here (see os_unix.c).
+int
+os_start_thread(pthread_t *thread, void *(*start)(void *), void *arg) {
+    return pthread_create(thread, NULL, start, arg);
+}// os_start_thread
+
 // Get the Documents folder (or equivalent) from the environment.
 const char*
 cfg_root() {
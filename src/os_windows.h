@@ -36,6 +36,7 @@ void os_get_user_id(char *uid, size_t uid_size);
 int os_mkdir(const char *path, unsigned mode);
 int os_lockf(int fnum);
 int os_unlockf(int fnum);
+int os_lockf_shared(int fnum);
 int os_setenv(const char *name, const char *value, int overwrite);
 int os_unsetenv(const char *name);
 const char* cfg_root(void);
@@ -17,13 +17,6 @@
 #include <limits.h>
 
 
-// The global player state object.
-struct Player UU;
-
-/* Global player inventory. */
-struct Object Invent[IVENSIZE];
-
-
 // Various offsets for the stat mods performed by recalc()
 enum STAT_MODS {
     // Carried
@@ -53,6 +46,9 @@ enum STAT_MODS {
 static void item_loss_action(struct Object thing);
 static void item_gain_action (struct Object thing);
 
+// Private parts of the game context
+#define InvTotals       (GameCtx->invTotals)
+
 
 /* Return a (read-only) string describing the character class given by
  * 'cc'. */
@@ -117,8 +113,8 @@ init_cc_specific (enum CHAR_CLASS cc) {
         constitution_init(16);   /* constitution */
         dexterity_init(6);   /* dexterity */
         charisma_init(4);    /* charisma */
-        Invent[0] = random_potion();
-        Invent[1] = random_potion();
+        inv_set(0, random_potion());
+        inv_set(1, random_potion());
         break;
 
     case CCWIZARD:
@@ -132,9 +128,9 @@ init_cc_specific (enum CHAR_CLASS cc) {
         constitution_init(6);    /* constitution */
         dexterity_init(6);   /* dexterity */
         charisma_init(8);    /* charisma */
-        Invent[0] = obj(OPTREASURE, 0); /* potion of treasure detection */
-        Invent[1] = random_scroll();
-        Invent[2] = random_scroll();
+        inv_set(0, obj(OPTREASURE, 0)); /* potion of treasure detection */
+        inv_set(1, random_scroll());
+        inv_set(2, random_scroll());
         break;
 
     case CCKLINGON:
@@ -147,8 +143,8 @@ init_cc_specific (enum CHAR_CLASS cc) {
         constitution_init(12);   /* constitution */
         dexterity_init(8);   /* dexterity */
         charisma_init(3);    /* charisma */
-        Invent[0] = obj(OSTUDLEATHER, 0);
-        Invent[1] = random_potion();
+        inv_set(0, obj(OSTUDLEATHER, 0));
+        inv_set(1, random_potion());
         UU.wear = 0;
         break;
 
@@ -163,8 +159,8 @@ init_cc_specific (enum CHAR_CLASS cc) {
         constitution_init(8);    /* constitution */
         dexterity_init(8);   /* dexterity */
         charisma_init(14);   /* charisma */
-        Invent[0] = obj(OLEATHER, 0);
-        Invent[1] = random_scroll();
+        inv_set(0, obj(OLEATHER, 0));
+        inv_set(1, random_scroll());
         UU.wear=0;
         break;
 
@@ -179,9 +175,9 @@ init_cc_specific (enum CHAR_CLASS cc) {
         dexterity_init(14);  /* dexterity */
         charisma_init(6);    /* charisma */
 
-        Invent[0] = obj (OLEATHER, 0);
-        Invent[1] = obj (ODAGGER, 0);
-        Invent[2] = obj (OSSTEALTH, 0);  /* stealth */
+        inv_set(0, obj (OLEATHER, 0));
+        inv_set(1, obj (ODAGGER, 0));
+        inv_set(2, obj (OSSTEALTH, 0));  /* stealth */
 
         UU.wear=0;
         UU.wield=1;
@@ -199,8 +195,8 @@ init_cc_specific (enum CHAR_CLASS cc) {
         dexterity_init(12);  /* dexterity */
         charisma_init(12);   /* charisma */
 
-        Invent[0] = obj(OLEATHER, 0);
-        Invent[1] = obj(ODAGGER, 0);
+        inv_set(0, obj(OLEATHER, 0));
+        inv_set(1, obj(ODAGGER, 0));
 
         UU.wear=0;
         UU.wield=1;
@@ -217,7 +213,7 @@ init_cc_specific (enum CHAR_CLASS cc) {
         dexterity_init(4);   /* dexterity */
         charisma_init(4);    /* charisma */
 
-        Invent[0] = obj(OSPEAR, 0);
+        inv_set(0, obj(OSPEAR, 0));
 
         UU.wield=0;
         break;
@@ -231,7 +227,7 @@ init_cc_specific (enum CHAR_CLASS cc) {
         constitution_init(3);    /* constitution */
         dexterity_init(3);   /* dexterity */
         charisma_init(3);    /* charisma */
-        Invent[0] = obj(OLANCE, 0);
+        inv_set(0, obj(OLANCE, 0));
 
         UU.wield=0;
         break;
@@ -266,7 +262,7 @@ init_new_player (enum CHAR_CLASS cc,
     UU.shield = UU.wear = UU.wield = -1;
 
     for (n = 0; n < IVENSIZE; n++) {
-        Invent[n] = obj(ONONE, 0);
+        inv_set(n, obj(ONONE, 0));
     }/* for */
 
     init_cc_specific(cc);
@@ -278,7 +274,7 @@ init_new_player (enum CHAR_CLASS cc,
     UU.gtime = 0;    /*  time clock starts at zero   */
 
     // If the player previously won a game, they will owe taxes
-    UU.outstanding_taxes = get_taxes_owed();
+    UU.outstanding_taxes = GameCtx->noScoreboard ? 0 : get_taxes_owed();
 
     // Identify everything that's known by default.
     for (int n = 0; n < OBJ_COUNT; n++) {
@@ -296,6 +292,8 @@ init_new_player (enum CHAR_CLASS cc,
 // a negative value if it's not present.
 int
 index_of_first(enum OBJECT_ID type) {
+    if (type != ONONE && !InvTotals.count[type]) { return -1; }
+
     for (int n = 0; n < IVENSIZE; n++) {
         if (Invent[n].type == type) {
             return n;
@@ -307,7 +305,8 @@ index_of_first(enum OBJECT_ID type) {
 
 bool
 has_a(enum OBJECT_ID type) {
-    return index_of_first(type) >= 0;
+    ASSERT(type > ONONE && type < OBJ_COUNT);
+    return InvTotals.count[type] > 0;
 }/* has_a*/
 
 
@@ -432,7 +431,7 @@ moveplayer (DIRECTION dir, bool* success) {
         return false;
     }/* if */
 
-    if (UU.confuse && UU.level < rnd(30) && dir != DIR_STAY) {
+    if (effect_left(EFF_CONFUSE) && UU.level < rnd(30) && dir != DIR_STAY) {
         // If confused, any dir.
         dir = randdir();
     }/* if */
@@ -448,14 +447,14 @@ moveplayer (DIRECTION dir, bool* success) {
     uint8_t thing = at(new_x, new_y)->obj.type;
 
     /*  hit a wall (or closed door while time has stopped) */
-    if ((thing == OWALL && UU.wtw == 0) ||
-        (UU.timestop != 0 && thing == OCLOSEDDOOR))
+    if ((thing == OWALL && effect_left(EFF_WTW) == 0) ||
+        (effect_left(EFF_TIMESTOP) != 0 && thing == OCLOSEDDOOR))
     {
         bool foundit = false;
 
         /* If blind and the destination is unknown, reveal it but
          * spend a turn doing it. */
-        if (UU.blindCount > 0 && !known_at(new_x, new_y)) {
+        if (effect_left(EFF_BLIND) > 0 && !known_at(new_x, new_y)) {
             see_and_update_at(new_x, new_y);
             foundit = true;
         }/* if */
@@ -500,37 +499,24 @@ statfor(int slot) {
 }/* statfor*/
 
 
-/* Return the modification value provided by carrying an object of
- * type 'oid'.  This defaults to 1 + its iarg with a couple of special
- * cases.  It is up to the caller to add the result to the correct
- * stat. */
+/* Return the modification value provided by carrying 'obj'.  This
+ * defaults to 1 + its iarg with a couple of special cases. */
 static int
-carrymod(enum OBJECT_ID oid) {
-    int mod = 0;
-    int n;
-
-    for (n = 0; n < IVENSIZE; n++) {
-        struct Object obj = Invent[n];
-
-        if (obj.type != oid) continue;
-
-        /* Special case 1: */
-        if (oid == OBELT) {
-            mod += 2 + obj.iarg*2;
-            continue;
-        }/* if */
-
-        /* Special case 2: */
-        if (oid == ORINGOFEXTRA) {
-            mod += 5 * (obj.iarg + 1);
-            continue;
-        }/* if */
-
-        /* Default behaviour. */
-        mod += Types[oid].mod + obj.iarg;
-    }/* for */
+item_carrymod(struct Object obj) {
+    switch (obj.type) {
+    case ONONE:         return 0;
+    case OBELT:         return 2 + obj.iarg*2;
+    case ORINGOFEXTRA:  return 5 * (obj.iarg + 1);
+    default:            return Types[obj.type].mod + obj.iarg;
+    }// switch
+}// item_carrymod
 
-    return mod;
+/* Return the modification value provided by carrying all objects of
+ * type 'oid'.  It is up to the caller to add the result to the
+ * correct stat. */
+static int
+carrymod(enum OBJECT_ID oid) {
+    return InvTotals.mod[oid];
 }/* carrymod */
 
 static void
@@ -602,52 +588,71 @@ recalc_carry(struct Object obj) {
 // effects.
 static void
 recalc_effects() {
-    if (UU.coked) {
+    if (effect_left(EFF_COKED)) {
         adjust_all_stat_mods(SM_COKED);
     }// if
 
-    if (UU.dexCount) {
+    if (effect_left(EFF_DEXCOUNT)) {
         dexterity_adjust_mod(SM_DEX);
     }// if
 
-    if (UU.hero) {
+    if (effect_left(EFF_HERO)) {
         adjust_all_stat_mods(SM_HEROISM);
     }// if
 
-    if (UU.strcount) {
+    if (effect_left(EFF_STRCOUNT)) {
         strength_adjust_mod(SM_STRENGTH);
     }// if
 
-    if (UU.giantstr) {
+    if (effect_left(EFF_GIANTSTR)) {
         strength_adjust_mod(SM_GIANTSTR);
     }// if
 
-    if (UU.protectionTime) {
+    if (effect_left(EFF_PROTECTION)) {
         defense_adjust_mod(SM_PROTECT);
     }// if
 
-    if (UU.globe) {
+    if (effect_left(EFF_GLOBE)) {
         defense_adjust_mod(SM_INVULN);
     }// if
 
-    if (UU.altpro) {
+    if (effect_left(EFF_ALTPRO)) {
         defense_adjust_mod(SM_ALTPRO);
     }// if
 
 }// recalc_effects
 
 
+// Return the current state of everything recalc() depends on.  The
+// effects here must match those tested by recalc_effects().
+static struct RecalcKey
+recalc_key() {
+    uint8_t effects =
+        (!!effect_left(EFF_COKED)             << 0) |
+        (!!effect_left(EFF_DEXCOUNT)          << 1) |
+        (!!effect_left(EFF_HERO)              << 2) |
+        (!!effect_left(EFF_STRCOUNT)          << 3) |
+        (!!effect_left(EFF_GIANTSTR)          << 4) |
+        (!!effect_left(EFF_PROTECTION)        << 5) |
+        (!!effect_left(EFF_GLOBE)             << 6) |
+        (!!effect_left(EFF_ALTPRO)            << 7);
+
+    return (struct RecalcKey) {
+        .valid = true,
+        .invGeneration = InvTotals.generation,
+        .wear = UU.wear,
+        .shield = UU.shield,
+        .effects = effects,
+    };
+}// recalc_key
+
+
 // recalc() function to recalculate the armor class, weapon class,
 // etc. of the player.
 //
 // This should be called *after* regen() in the turn.
 void
 recalc () {
-    reset_stats();
-
-    // Defense from weapons and armor.
-    defense_adjust_mod(statfor(UU.wear)+statfor(UU.shield)+carrymod(OPROTRING));
-
     // Check for the Eye.  This isn't strictly necessary but it
     // reinforces the principal that Invent is the single point of
     // truth for these sorts of checks.  It also minimizes the damage
@@ -655,6 +660,24 @@ recalc () {
     // in a way that bypasses item_gain/loss_action().
     UU.hasTheEyeOfLarn = has_a(OLARNEYE);
 
+    // The mods only change when the inventory, the worn armor or the
+    // set of active effects does, which is seldom; most turns, we can
+    // keep the last result.
+    struct RecalcKey key = recalc_key();
+    struct RecalcKey *last = &GameCtx->recalcKey;
+    if (last->valid && last->invGeneration == key.invGeneration &&
+        last->wear == key.wear && last->shield == key.shield &&
+        last->effects == key.effects)
+    {
+        return;
+    }// if
+    *last = key;
+
+    reset_stats();
+
+    // Defense from weapons and armor.
+    defense_adjust_mod(statfor(UU.wear)+statfor(UU.shield)+carrymod(OPROTRING));
+
     // Other carried
     for (int n = 0; n < IVENSIZE; n++) {
         recalc_carry(Invent[n]);
@@ -722,14 +745,14 @@ item_gain_action (struct Object thing) {
         // We have to bump awareness right now because recalc() has
         // already been called and we want this to take effect
         // immediately.
-        UU.awareness++;
+        effect_add(EFF_AWARENESS, 1);
         break;
 
     case OLARNEYE:
         // Set it now because recalc has already been called.
         UU.hasTheEyeOfLarn = true;
 
-        if (UU.blindCount == 0) {
+        if (effect_left(EFF_BLIND) == 0) {
             say("Your sight fades for a moment...\n");
             nap(1000);
             say("Your sight returns, and everything looks crystal-clear!\n");
@@ -751,7 +774,7 @@ item_loss_action (struct Object obj) {
         // we're checking anyway.
         UU.hasTheEyeOfLarn = false;
 
-        if (!UU.blindCount) {
+        if (!effect_left(EFF_BLIND)) {
             say("Your sight fades for a moment...\n");
             nap(1000);
             say("Your sight returns but everything looks dull and faded.\n");
@@ -760,6 +783,57 @@ item_loss_action (struct Object obj) {
 }/* item_loss_action */
 
 
+// Add (sign > 0) or remove (sign < 0) 'obj' from the inventory
+// totals.
+static void
+inv_tally(struct Object obj, int sign) {
+    if (!obj.type) { return; }
+
+    InvTotals.count[obj.type] += sign;
+    InvTotals.mod[obj.type] += sign * item_carrymod(obj);
+}// inv_tally
+
+
+// Put 'obj' (which may be NULL_OBJ) in inventory slot 'slot',
+// replacing whatever was there.  This is a plain assignment; any
+// consequences of gaining or losing the item are the caller's job.
+void
+inv_set(int slot, struct Object obj) {
+    ASSERT(slot >= 0 && slot < IVENSIZE);
+
+    inv_tally(Invent[slot], -1);
+    GameCtx->invent[slot] = obj;
+    inv_tally(obj, 1);
+
+    InvTotals.generation++;
+}// inv_set
+
+
+// Add 'delta' to the iarg (enchantment, etc.) of the item in 'slot'.
+void
+inv_adjust_iarg(int slot, int delta) {
+    struct Object obj = Invent[slot];
+    obj.iarg += delta;
+    inv_set(slot, obj);
+}// inv_adjust_iarg
+
+
+// Replace the entire inventory with 'items', e.g. when restoring a
+// saved game.
+void
+inv_set_all(const struct Object items[IVENSIZE]) {
+    memcpy(GameCtx->invent, items, sizeof(GameCtx->invent));
+
+    memset(InvTotals.count, 0, sizeof(InvTotals.count));
+    memset(InvTotals.mod, 0, sizeof(InvTotals.mod));
+    for (int n = 0; n < IVENSIZE; n++) {
+        inv_tally(items[n], 1);
+    }// for
+
+    InvTotals.generation++;
+}// inv_set_all
+
+
 /* Put 'thing' in player's inventory.  If inventory is full, display
  * 'ifullMsg' unless it's NULL or empty, in which case it desplays a
  * default message.  Returns true on success, false on failure. */
@@ -771,7 +845,7 @@ take (struct Object thing, const char *ifullMsg) {
     int i = 0;
     for (i = 0; i < limit; i++) {
         if (Invent[i].type==0) {
-            Invent[i] = thing;
+            inv_set(i, thing);
             foundslot = true;
             break;
         }/* if */
@@ -807,7 +881,7 @@ inventremove(int index) {
 
     item_loss_action(obj);
 
-    Invent[index] = NULL_OBJ;
+    inv_set(index, NULL_OBJ);
 
     return obj;
 }/* inventremove*/
@@ -845,7 +919,7 @@ drop_object (int k) {
 
     obj = inventremove(k);
     if (!pitflag) {
-        at(UU.x, UU.y)->obj = obj;
+        set_obj_at(UU.x, UU.y, obj);
     } else {
         say("It disappears down the pit.\n");
     }/* if .. else*/
@@ -859,14 +933,14 @@ drop_object (int k) {
 
 void
 drop_gold (int64_t amount) {
-    struct Object *o;
+    const struct Object *o;
     int64_t dropamt = amount;
 
     o = &at(UU.x, UU.y)->obj;
 
     if (o->type == OGOLDPILE) {
         dropamt += o->iarg;
-        *o = NULL_OBJ;
+        set_obj_at(UU.x, UU.y, NULL_OBJ);
     }/* if */
 
     if (o->type && o->type != OPIT) {
@@ -891,8 +965,7 @@ drop_gold (int64_t amount) {
 
     say("You drop %ld gold piece%s.\n", dropamt, (dropamt==1) ? "" :"s");
 
-    o->type = OGOLDPILE;
-    o->iarg = dropamt;
+    set_obj_at(UU.x, UU.y, obj(OGOLDPILE, dropamt));
 
     cancel_look();
 
@@ -930,10 +1003,10 @@ enchantarmor (enum ENCH_HOW how) {
     /*
      *  Enchant it and check for destruction at >= +10.
      */
-    Invent[which].iarg++;
+    inv_adjust_iarg(which, 1);
     if (Invent[which].iarg >= 10) {
         if (how == ENCH_ALTAR) {
-            Invent[which].iarg--;
+            inv_adjust_iarg(which, -1);
             say("Your %s glows briefly.\n", objname(Invent[which]));
             return;
         }
@@ -941,7 +1014,7 @@ enchantarmor (enum ENCH_HOW how) {
             ASSERT(how == ENCH_SCROLL);
             say("Your %s vibrates violently and crumbles into dust!\n",
                     objname(Invent[which]));
-            Invent[which] = NULL_OBJ;
+            inv_set(which, NULL_OBJ);
             *whichSlot = -1;
             item_loss_action(Invent[which]); /* Surely not? */
             return;
@@ -968,7 +1041,7 @@ enchweapon (int how) {
     wieldedObj = Invent[UU.wield];
     wieldedType = wieldedObj.type;
     if (!isscroll(wieldedObj) && !ispotion(wieldedObj)) {
-        Invent[UU.wield].iarg++;
+        inv_adjust_iarg(UU.wield, 1);
 
         // Enchanting the relevant artifact will also boost a stat.
         if (wieldedType == OCLEVERRING)     { intelligence_adjust(1); }
@@ -977,15 +1050,14 @@ enchweapon (int how) {
 
         if (Invent[UU.wield].iarg >= 10 && rnd(10) <= 9) {
             if (how==ENCH_ALTAR) {
-                Invent[UU.wield].iarg--;
+                inv_adjust_iarg(UU.wield, -1);
                 say("Your weapon glows a little.\n");
             }
             else {
                 say("Your weapon vibrates violently and crumbles into "
                        "dust!\n");
                 wieldedType=UU.wield;
-                Invent[wieldedType].type = 0;
-                Invent[wieldedType].iarg=0;
+                inv_set(wieldedType, NULL_OBJ);
                 item_loss_action(wieldedObj);
                 UU.wield = -1;
             }
@@ -1058,7 +1130,7 @@ stealsomething (int x, int y) {
 
     add_to_stolen (Invent[index]);
 
-    Invent[index] = NULL_OBJ;
+    inv_set(index, NULL_OBJ);
 
     return true;
 }/* stealsomething */
@@ -1142,78 +1214,22 @@ graduated() {
 
 
 
-// Add 'time' (which may be negative) to each active player stat in
-// UU, truncating to 1 if the result would go negative.  Used for
-// stuff like scrolls of Time Warp or taking a course at U of Larn.
-//
-// As a special case, a true value for make_permanent (and time == 0)
-// makes all active effects permanent.
-void
-adjust_effect_timeouts(int32_t time, bool make_permanent) {
-    static int32_t *time_change[] = {
-        &UU.hasteSelf, &UU.hero, &UU.altpro, &UU.protectionTime,
-        &UU.dexCount, &UU.strcount, &UU.giantstr, &UU.charmcount,
-        &UU.invisibility, &UU.cancellation, &UU.hasteSelf,
-        &UU.aggravate, &UU.scaremonst, &UU.stealth, &UU.awareness,
-        &UU.holdmonst, &UU.hastemonst, &UU.fireresistance, &UU.globe,
-        &UU.spiritpro, &UU.undeadpro, &UU.halfdam, &UU.seeinvisible,
-        &UU.itching, &UU.clumsiness, &UU.wtw,
-
-        NULL};
-
-    // Ensure the caller didn't accidently set make_permanent to true.
-    ASSERT(!make_permanent || time == 0);
-
-    for (int j = 0; time_change[j]; j++) { /* adjust time related parameters */
-        // We only affect active stats
-        if (*time_change[j] == 0) { continue; }
-
-        // Permanence doesn't affect holdmonster.
-        if (make_permanent && time_change[j] == &UU.holdmonst) {
-            continue;
-        }
-
-        // We make stats permanent by setting them to very high values
-        // which can't run out in the life of the game.  This is
-        // around 10 million mobuls.  (I used to use INT32_MAX but
-        // this caused the scroll of timewarp to sometimes overflow
-        // the counts and lose permanent stats.)
-        if (make_permanent) {
-            *time_change[j] = INT32_MAX/2;
-            continue;
-        }// if
-
-        // We offset by one because regen() will do the final
-        // iteration.
-        *time_change[j] -= (time - 1);
-
-        // If the update took the result negative, just set it to 1
-        // and let the call to regen() finish it off.
-        if (*time_change[j] < 1) {
-            *time_change[j] = 1;
-            continue;
-        }
-    }/* for */
-
-    regen();
-}/* adjust_effect_timeouts*/
-
-
-
 // Update time-based things (e.g. regenerate hitpoints and spells or
 // decrease temporary effects like walk-through-walls or blindness.)
 //
 // This is expected to be called *before* recalc().
 void
 regen() {
-#   define DECR(n) if(n) { --n; }
-
-    if (UU.timestop)  {
-        if(--UU.timestop <= 0) return;
-    }   /* for stop time spell */
+    // Timestop runs down along with the other effects (in
+    // effect_tick()) except that the turn it ends does nothing else.
+    int32_t stopped = effect_left(EFF_TIMESTOP);
+    if (stopped == 1) {
+        effect_set(EFF_TIMESTOP, 0);
+        return;
+    }// if
 
     // Advance time.  hasteSelf halves it but timestop stops it completely.
-    if (UU.timestop == 0 && UU.hasteSelf % 2 == 0) {
+    if (stopped == 0 && effect_left(EFF_HASTESELF) % 2 == 0) {
         UU.gtime++;
     }
 
@@ -1235,88 +1251,10 @@ regen() {
         UU.spells++;
     }
 
-    DECR(UU.hero);
-    DECR(UU.coked);
-    DECR(UU.altpro);
-
-    DECR(UU.protectionTime);
-    DECR(UU.dexCount);
-    DECR(UU.strcount);
-
-    if (UU.blindCount)
-        if (--UU.blindCount<=0) {
-            say("The blindness lifts.\n");
-            headsup();
-        }
-    if (UU.confuse)
-        if (--UU.confuse<=0) {
-            say("You regain your senses.\n");
-            headsup();
-        }
-
-    DECR(UU.giantstr);
-
-    DECR(UU.charmcount);
-    DECR(UU.invisibility);
-    DECR(UU.cancellation);
-    DECR(UU.wtw);
-    DECR(UU.hasteSelf);
-    DECR(UU.aggravate);
-    DECR(UU.scaremonst);
-    DECR(UU.stealth);
-    DECR(UU.holdmonst);
-    DECR(UU.hastemonst);
-    DECR(UU.fireresistance);
-    DECR(UU.spiritpro);
-    DECR(UU.undeadpro);
-    DECR(UU.enlightenment.time);
-    DECR(UU.monster_detection);
-
-    DECR(UU.globe);
-
-    // Posessing the Orb of Awareness both preserves the existing
-    // awareness count and ensures that you currently have Awareness.
-    if (!has_a(OORB)) {
-        DECR(UU.awareness);
-    }
-
-    if (UU.halfdam)
-        if (--UU.halfdam<=0)  {
-            say("You now feel better.\n");
-            headsup();
-        }
-
-    if (UU.seeinvisible && !has_a(OAMULET) ) {
-        if (--UU.seeinvisible <= 0) {
-            say("Your vision returns to normal.\n");
-            headsup();
-        }
-    }
+    // Run down the timed effects.
+    effect_tick();
 
-    if (UU.itching) {
-        if (UU.itching > 1 &&(UU.wear != -1 || UU.shield != -1)&& rnd(100)<50){
-            UU.wear = UU.shield = -1;
-            say("The hysteria of itching forces you to remove your armor!\n");
-            headsup();
-        }
-
-        if (--UU.itching<=0) {
-            say("The irritation subsides.\n");
-            headsup();
-        }
-    }
-    if (UU.clumsiness) {
-        if (UU.wield != -1)
-            if (UU.clumsiness>1)
-                if (at(UU.x, UU.y)->obj.type==0)/* if nothing there */
-                    if (rnd(100)<33) /* drop your weapon */
-                        drop_object((int)UU.wield);
-        if (--UU.clumsiness<=0) {
-            say("You now feel less awkward.\n");
-            headsup();
-        }
-    }
-#   undef DECR
+    if (UU.enlightenment.time) { --UU.enlightenment.time; }
 }/* regen*/
 
 
@@ -1449,23 +1387,23 @@ raiseexperience (int points) {
         /* if we changed levels */
         switch ((int)UU.level) {
         case 94:    /* earth guardian */
-            UU.wtw = INT32_MAX;
+            effect_set(EFF_WTW, INT32_MAX);
             break;
         case 95:    /* air guardian */
-            UU.invisibility = INT32_MAX;
+            effect_set(EFF_INVISIBILITY, INT32_MAX);
             break;
         case 96:    /* fire guardian */
-            UU.fireresistance = INT32_MAX;
+            effect_set(EFF_FIRERESISTANCE, INT32_MAX);
             break;
         case 97:    /* water guardian */
-            UU.cancellation = INT32_MAX;
+            effect_set(EFF_CANCELLATION, INT32_MAX);
             break;
         case 98:    /* time guardian */
-            UU.hasteSelf = INT32_MAX;
+            effect_set(EFF_HASTESELF, INT32_MAX);
             break;
         case 99:    /* ethereal guardian */
-            UU.stealth = INT32_MAX;
-            UU.spiritpro = INT32_MAX;
+            effect_set(EFF_STEALTH, INT32_MAX);
+            effect_set(EFF_SPIRITPRO, INT32_MAX);
             break;
         case 100:
             say("You are now The Creator!\n");
@@ -2,7 +2,8 @@
 // See Copyright.txt, LICENSE.txt and AUTHORS.txt for terms.
 
 // Module for maintaining and managing the player state.  The player
-// is stored in a global variable called 'UU'.
+// is stored in the game context and is referred to as 'UU' (see
+// game_context.h).
 
 #ifndef HDR_GUARD_PLAYER_H
 #define HDR_GUARD_PLAYER_H
@@ -18,6 +19,7 @@
 #include "cast.h"
 #include "monster.h"
 #include "char_ids.h"
+#include "effect.h"
 
 
 #define PLAYERNAME_MAX 40
@@ -80,37 +82,8 @@ struct Player {
     int8_t wield;
     int8_t shield;
 
-    // Timed effects
-    int32_t protectionTime;
-    int32_t dexCount;
-    int32_t strcount;
-    int32_t blindCount;         // if blind
-    int32_t confuse;            // if confused
-    int32_t altpro;             // Protection granted by an altar
-    int32_t hero;               // if hero
-    int32_t charmcount;
-    int32_t invisibility;       // if invisible
-    int32_t cancellation;       // if cancel cast
-    int32_t hasteSelf;          // if hasted
-    int32_t aggravate;
-    int32_t globe;              // Invulnerable Globe (aka Invulnerability)
-    int32_t scaremonst;         // if scare cast
-    int32_t awareness;          // if awareness cast (or otherwise in effect)
-    int32_t holdmonst;
-    int32_t timestop;
-    int32_t hastemonst;
-    int32_t spiritpro;
-    int32_t undeadpro;
-    int32_t giantstr;           // if giant strength
-    int32_t fireresistance;
-    int32_t stealth;
-    int32_t seeinvisible;
-    int32_t monster_detection;
-    int32_t wtw;                // walk through walls
-    int32_t itching;            // Curse: can't wear armor
-    int32_t clumsiness;         // Curse: chance of dropping stuff
-    int32_t halfdam;            // Curse: halves your damage
-    int32_t coked;              // timer for being coked out
+    // Timed effects (blindness, haste, etc.); see effect.h
+    struct EffectTable effects;
 
     struct EnlStat {            // Enlightenment; stored with radius
         uint8_t radius;
@@ -153,8 +126,10 @@ struct Player {
 enum ENCH_HOW {ENCH_SCROLL, ENCH_ALTAR};
 
 #define IVENSIZE  26                    // max size of inventory
-extern struct Player UU;                // global player object
-extern struct Object Invent[IVENSIZE];  // global player inventory
+
+// The player object (UU) and inventory (Invent) are part of the game
+// context.
+#include "game_context.h"
 
 const char *ccname(enum CHAR_CLASS cc);
 enum CHAR_CLASS ccvalue(const char *name);
@@ -166,6 +141,9 @@ int index_of_first(enum OBJECT_ID type);
 
 void drop_gold (int64_t amount);
 struct Object inventremove(int index);
+void inv_set(int slot, struct Object obj);
+void inv_adjust_iarg(int slot, int delta);
+void inv_set_all(const struct Object items[IVENSIZE]);
 
 void raiselevel(void);
 void loselevel(void);
@@ -191,7 +169,6 @@ bool stealsomething(int x, int y);
 bool emptyhanded(void);
 int packweight(void);
 bool moveplayer(DIRECTION dir, bool* success);
-void adjust_effect_timeouts(int32_t time, bool make_permanent);
 void raise_min(uint16_t min);
 void add_to_base_stats(int val);
 
@@ -218,6 +195,11 @@ static inline void moveplayer_back() {
     UU.y = UU.prev_y;
 }// moveplayer_back
 
+// Return the number of turns 'eff' has left; 0 if it's not active.
+static inline int32_t effect_left(enum EFFECT eff) {
+    return effect_table_left(&UU.effects, eff);
+}// effect_left
+
 static inline void enlighten(uint8_t radius, uint8_t time) {
     UU.enlightenment = (struct EnlStat) {radius, time};
 }
@@ -0,0 +1,300 @@
+// This file is part of ReLarn; Copyright (C) 1986 - 2023; GPLv2; NO WARRANTY!
+// See Copyright.txt, LICENSE.txt and AUTHORS.txt for terms.
+
+#include "pregen.h"
+
+#include "game_context.h"
+#include "internal_assert.h"
+#include "os.h"
+#include "trace.h"
+#include "util.h"
+
+#include <pthread.h>
+#include <string.h>
+
+// The most levels we build at once, i.e. the ones above and below.
+#define MAX_PREGEN 2
+
+// The parts of the player that a new level depends on.  (See
+// generate_level(); this has to be kept in step with it.)
+struct BuildInputs {
+    uint16_t challenge;
+    bool wizardMode;
+    bool has_up_elevator, has_down_elevator;
+    bool created[OBJ_COUNT];
+    bool banished[NUM_MONSTERS];
+};
+
+// A level under way
+struct Build {
+    int level;                          // -1 if this one is unused
+    bool running;                       // 'thread' hasn't been joined
+    pthread_t thread;
+    struct GameContext *ctx;            // Where it's being built
+    struct BuildInputs inputs;          // What it's being built from
+};
+
+// Everything a game has under way (at GameCtx->pregen)
+struct Pregen {
+    struct Build builds[MAX_PREGEN];    // Oldest first
+    struct GameContext *spare;          // A builder to reuse, or NULL
+};
+
+#define PG (GameCtx->pregen)
+
+// Build levels in background threads?  If not, pregen_start() does
+// nothing and every level is built when it's needed.  Either way, the
+// levels come out the same.
+static bool Background = true;
+
+void
+pregen_set_background(bool enable) {
+    Background = enable;
+}// pregen_set_background
+
+
+static void
+get_inputs(struct BuildInputs *in) {
+    memset(in, 0, sizeof(*in));
+    in->challenge = UU.challenge;
+    in->wizardMode = UU.wizardMode;
+    in->has_up_elevator = UU.has_up_elevator;
+    in->has_down_elevator = UU.has_down_elevator;
+    memcpy(in->created, UU.created, sizeof(in->created));
+    memcpy(in->banished, UU.banished, sizeof(in->banished));
+}// get_inputs
+
+
+// Make sure the game has a seed for its level streams.  This comes
+// from the game's own stream, so it has to be done at the same point
+// in the game whether or not we build in the background.  Both
+// pregen_get() and pregen_start() do it first thing, even if they
+// don't build anything.
+static void
+need_level_seed() {
+    if (GameCtx->levelSeed) { return; }
+
+    uint64_t seed = ((uint64_t)rng_next() << 32) ^ (uint64_t)rng_next();
+    GameCtx->levelSeed = seed | 1;
+}// need_level_seed
+
+// Return the initial state of the random number stream for 'level'
+// in a game whose level seed is 'gameSeed'.  This mixes the two up
+// with the SplitMix64 finalizer so that neighbouring levels' streams
+// are unrelated.
+static uint64_t
+level_seed(uint64_t gameSeed, int level) {
+    uint64_t z = gameSeed ^ ((uint64_t)(level + 1) * 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}// level_seed
+
+
+// Allocate the game's struct Pregen if it doesn't have one yet.
+static void
+alloc_pregen() {
+    if (PG) { return; }
+
+    PG = xcalloc(1, sizeof(struct Pregen));
+    for (int n = 0; n < MAX_PREGEN; n++) {
+        PG->builds[n].level = -1;
+    }// for
+}// alloc_pregen
+
+
+// Get a context to build 'level' in.  The player is copied from the
+// current one but isn't anywhere on the level.  Contexts are big, so
+// we reuse one that pregen_release() has handed back if we can.  (The
+// only part of it a builder uses is its one level and that level's
+// object index, so that's all that needs clearing.)
+static struct GameContext *
+new_builder(int level) {
+    alloc_pregen();
+
+    struct GameContext *ctx = PG->spare;
+    if (ctx) {
+        PG->spare = NULL;
+        memset(&ctx->world.levels[level], 0, sizeof(ctx->world.levels[0]));
+        ctx->objIndex[level].valid = false;
+        ctx->buildNotes[0] = 0;
+    } else {
+        ctx = gc_new();
+    }// if .. else
+
+    ctx->uu = UU;
+    ctx->uu.x = ctx->uu.y = -1;
+    ctx->world.levelNum = level;
+    ctx->levelSeed = GameCtx->levelSeed;
+    ctx->building = true;
+    return ctx;
+}// new_builder
+
+// Build the level in builder context 'ctx' from its stream.  This
+// leaves the current thread's context and stream as it found them.
+static void
+build(struct GameContext *ctx) {
+    struct GameContext *prev = gc_bind(ctx);
+    uint64_t prevRng = RngState;
+
+    RngState = level_seed(ctx->levelSeed, ctx->world.levelNum);
+    generate_level();
+
+    RngState = prevRng;
+    gc_bind(prev);
+}// build
+
+static void *
+build_thread(void *ctx) {
+    build(ctx);
+    return NULL;
+}// build_thread
+
+
+// Wait for 'bd' to be finished, if it's still going.
+static void
+finish(struct Build *bd) {
+    if (!bd->running) { return; }
+
+    trace_begin("pregen.wait");
+    pthread_join(bd->thread, NULL);
+    trace_end("pregen.wait");
+    bd->running = false;
+}// finish
+
+// Throw away 'bd' (finishing it first, if need be).
+static void
+drop(struct Build *bd) {
+    finish(bd);
+    pregen_release(bd->ctx);
+    bd->ctx = NULL;
+    bd->level = -1;
+}// drop
+
+
+// Return a context in which 'level' (which mustn't exist in the
+// current one) has been built.  The caller takes the level (and the
+// player's created[] and elevator flags) from it and then hands it
+// back with pregen_release().
+//
+// This is the one built in the background if there is one and it's
+// still good; otherwise, we build it now.
+struct GameContext *
+pregen_get(int level) {
+    need_level_seed();
+
+    struct Build *bd = NULL;
+    for (int n = 0; PG && n < MAX_PREGEN; n++) {
+        if (PG->builds[n].level == level) { bd = &PG->builds[n]; }
+    }// for
+
+    if (bd) {
+        finish(bd);
+
+        struct BuildInputs now;
+        get_inputs(&now);
+        if (memcmp(&now, &bd->inputs, sizeof(now)) == 0) {
+            struct GameContext *ctx = bd->ctx;
+            bd->ctx = NULL;
+            bd->level = -1;
+            return ctx;
+        }// if
+
+        drop(bd);
+    }// if
+
+    trace_begin("buildlevel");
+    struct GameContext *ctx = new_builder(level);
+    build(ctx);
+    trace_end("buildlevel");
+
+    return ctx;
+}// pregen_get
+
+
+// Start building 'level' (which doesn't exist yet) in the background,
+// unless it's already under way.  If too many levels are, the oldest
+// is dropped.
+void
+pregen_start(int level) {
+    need_level_seed();
+    if (!Background) { return; }
+
+    alloc_pregen();
+    struct Build *builds = PG->builds;
+
+    struct Build *bd = NULL;
+    for (int n = 0; n < MAX_PREGEN; n++) {
+        if (builds[n].level == level) { return; }
+        if (!bd && builds[n].level < 0) { bd = &builds[n]; }
+    }// for
+
+    if (!bd) {
+        drop(&builds[0]);
+        memmove(&builds[0], &builds[1], (MAX_PREGEN - 1) * sizeof(builds[0]));
+        bd = &builds[MAX_PREGEN - 1];
+        bd->level = -1;
+        bd->running = false;
+        bd->ctx = NULL;
+    }// if
+
+    // This computes the path the first time it's called, so make sure
+    // that happens here rather than in (several) builders at once.
+    levels_path();
+
+    bd->ctx = new_builder(level);
+    get_inputs(&bd->inputs);
+    if (os_start_thread(&bd->thread, build_thread, bd->ctx) != 0) {
+        // No matter; we'll build it when it's needed.
+        pregen_release(bd->ctx);
+        bd->ctx = NULL;
+        return;
+    }// if
+
+    bd->level = level;
+    bd->running = true;
+}// pregen_start
+
+
+// Hand back a context from pregen_get() (or a builder we're done
+// with) so that it can be reused.
+void
+pregen_release(struct GameContext *built) {
+    alloc_pregen();
+    if (PG->spare) {
+        gc_free(built);
+        return;
+    }// if
+
+    PG->spare = built;
+}// pregen_release
+
+
+// Wait for everything under way to be finished.  For benchmarks.
+void
+pregen_finish() {
+    for (int n = 0; PG && n < MAX_PREGEN; n++) {
+        finish(&PG->builds[n]);
+    }// for
+}// pregen_finish
+
+
+// Throw away everything 'ctx' has under way (or kept for reuse).
+// Called when its world is replaced and when it's freed.
+void
+pregen_discard(struct GameContext *ctx) {
+    struct Pregen *pg = ctx->pregen;
+    if (!pg) { return; }
+
+    for (int n = 0; n < MAX_PREGEN; n++) {
+        struct Build *bd = &pg->builds[n];
+        if (bd->level < 0) { continue; }
+
+        if (bd->running) { pthread_join(bd->thread, NULL); }
+        gc_free(bd->ctx);
+    }// for
+
+    gc_free(pg->spare);
+    free(pg);
+    ctx->pregen = NULL;
+}// pregen_discard
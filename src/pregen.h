@@ -0,0 +1,40 @@
+// This file is part of ReLarn; Copyright (C) 1986 - 2023; GPLv2; NO WARRANTY!
+// See Copyright.txt, LICENSE.txt and AUTHORS.txt for terms.
+
+// Building new levels ahead of time.
+//
+// Creating a level takes long enough to notice, so once the player
+// arrives somewhere, setlevel() has us start building the adjacent
+// levels that don't exist yet in background threads.  If the player
+// then goes to one of them, newcavelevel() just has to copy it into
+// the world and put the player on it.
+//
+// Each level is built in a context of its own (with a copy of UU, so
+// that generate_level() can work as usual) from a random number
+// stream of its own, which comes from a per-game seed and the level
+// number.  So what a level looks like doesn't depend on when, where
+// or whether it was built ahead of time.  However, it does also
+// depend on some of the player's state (the unique items created so
+// far, banished monsters, etc.); if that has changed by the time the
+// player gets there, we throw the early copy away and build the level
+// again, just as it would have been if it had been built then.
+//
+// Levels built ahead of time aren't saved.  They are thrown away when
+// the world is replaced (e.g. by restoring a game) and when the game
+// ends.
+
+#ifndef HDR_GUARD_PREGEN_H
+#define HDR_GUARD_PREGEN_H
+
+#include <stdbool.h>
+
+struct GameContext;
+
+struct GameContext *pregen_get(int level);
+void pregen_release(struct GameContext *built);
+void pregen_start(int level);
+void pregen_finish(void);
+void pregen_discard(struct GameContext *ctx);
+void pregen_set_background(bool enable);
+
+#endif
@@ -0,0 +1,236 @@
+// This file is part of ReLarn; Copyright (C) 1986 - 2023; GPLv2; NO WARRANTY!
+// See Copyright.txt, LICENSE.txt and AUTHORS.txt for terms.
+
+#include "profile.h"
+
+#include "settings.h"
+#include "map.h"
+#include "util.h"
+#include "internal_assert.h"
+
+#include <stdio.h>
+#include <stdint.h>
+
+
+const char *ProfPhaseNames[PP_MAX + 1] = {
+    "fov", "display", "action", "regen", "recalc", "randmonst", "look",
+    "movemonst", "whole turn",
+};
+
+
+#ifdef TURN_PROFILE
+
+// Histogram bucket n counts samples under 2^n microseconds (and at
+// least half that); the last bucket also takes everything slower.
+#define NUM_BUCKETS 24
+
+// Where the turn was played.  Deep levels are much busier than the
+// town so we keep them apart.
+enum PROF_AREA {
+    PA_TOWN,
+    PA_UPPER,
+    PA_LOWER,
+    PA_VOLCANO,
+
+    PA_MAX,
+};
+
+static const char *AreaNames[PA_MAX] = {
+    "Town", "Dungeon levels 1-7", "Dungeon levels 8-15", "Volcano",
+};
+
+struct PhaseStats {
+    long turns;             // Turns in which this phase ran
+    uint64_t total_usec;
+    uint64_t max_usec;
+    long buckets[NUM_BUCKETS];
+};
+static __thread struct PhaseStats Stats[PA_MAX][PP_MAX + 1];
+
+// The turn in progress.
+static __thread struct {
+    bool active;
+    enum PROF_AREA area;
+    uint64_t start;
+    uint64_t phase_start[PP_MAX];
+    uint64_t usec[PP_MAX];
+    bool ran[PP_MAX];
+} Turn;
+
+// Time spent waiting for input.  This is subtracted from everything.
+static __thread uint64_t Paused = 0;
+static __thread uint64_t PauseStart = 0;
+static __thread int PauseDepth = 0;
+
+
+// Current time minus the time spent waiting for input.
+static uint64_t
+busy_usec() {
+    return monotonic_usec() - Paused;
+}// busy_usec
+
+
+static enum PROF_AREA
+area_for(int level) {
+    if (level == 0)         { return PA_TOWN; }
+    if (level <= 7)         { return PA_UPPER; }
+    if (level <= DBOTTOM)   { return PA_LOWER; }
+    return PA_VOLCANO;
+}// area_for
+
+
+static void
+record(struct PhaseStats *ps, uint64_t usec) {
+    ps->turns++;
+    ps->total_usec += usec;
+    if (usec > ps->max_usec) { ps->max_usec = usec; }
+
+    int bucket = 0;
+    while (bucket < NUM_BUCKETS - 1 && usec >= ((uint64_t)1 << bucket)) {
+        ++bucket;
+    }
+    ps->buckets[bucket]++;
+}// record
+
+
+// Close out the previous turn (if any) and start timing a new one
+// on 'level'.
+void
+prof_turn_start(int level) {
+    uint64_t now = busy_usec();
+
+    if (Turn.active) {
+        struct PhaseStats *area = Stats[Turn.area];
+        for (int n = 0; n < PP_MAX; n++) {
+            if (Turn.ran[n]) { record(&area[n], Turn.usec[n]); }
+        }
+        record(&area[PP_MAX], now - Turn.start);
+    }// if
+
+    memset(&Turn, 0, sizeof(Turn));
+    Turn.active = true;
+    Turn.area = area_for(level);
+    Turn.start = now;
+}// prof_turn_start
+
+
+void
+prof_phase_start(enum PROF_PHASE phase) {
+    Turn.phase_start[phase] = busy_usec();
+}// prof_phase_start
+
+
+void
+prof_phase_stop(enum PROF_PHASE phase) {
+    Turn.usec[phase] += busy_usec() - Turn.phase_start[phase];
+    Turn.ran[phase] = true;
+}// prof_phase_stop
+
+
+// Stop the clock while waiting for the user.  Calls may nest.
+void
+prof_pause() {
+    if (PauseDepth++ == 0) { PauseStart = monotonic_usec(); }
+}// prof_pause
+
+
+void
+prof_resume() {
+    ASSERT(PauseDepth > 0);
+    if (--PauseDepth == 0) { Paused += monotonic_usec() - PauseStart; }
+}// prof_resume
+
+
+// Return the upper bound of the bucket containing the given
+// fraction of the samples.
+static uint64_t
+percentile(const struct PhaseStats *ps, double fraction) {
+    long wanted = (long)(ps->turns * fraction), seen = 0;
+    for (int n = 0; n < NUM_BUCKETS; n++) {
+        seen += ps->buckets[n];
+        if (seen > wanted) { return (uint64_t)1 << n; }
+    }
+    return (uint64_t)1 << (NUM_BUCKETS - 1);
+}// percentile
+
+
+static void
+report_area(struct StringBuilder *sb, enum PROF_AREA area) {
+    const struct PhaseStats *stats = Stats[area];
+
+    sb_appendf(sb, "%s: %ld turns\n\n", AreaNames[area],
+               stats[PP_MAX].turns);
+    sb_appendf(sb, "  %-11s %7s %9s %9s %9s %10s\n",
+               "phase", "turns", "mean us", "p50 us<", "p95 us<", "max us");
+
+    for (int n = 0; n <= PP_MAX; n++) {
+        const struct PhaseStats *ps = &stats[n];
+        if (!ps->turns) { continue; }
+
+        sb_appendf(sb, "  %-11s %7ld %9.1f %9llu %9llu %10llu\n",
+                   ProfPhaseNames[n], ps->turns,
+                   (double)ps->total_usec / ps->turns,
+                   (unsigned long long)percentile(ps, 0.5),
+                   (unsigned long long)percentile(ps, 0.95),
+                   (unsigned long long)ps->max_usec);
+    }// for
+
+    // Histograms, omitting the empty buckets.
+    sb_append(sb, "\n  Histograms (us<bound:count):\n");
+    for (int n = 0; n <= PP_MAX; n++) {
+        const struct PhaseStats *ps = &stats[n];
+        if (!ps->turns) { continue; }
+
+        sb_appendf(sb, "  %-11s", ProfPhaseNames[n]);
+        for (int b = 0; b < NUM_BUCKETS; b++) {
+            if (!ps->buckets[b]) { continue; }
+            sb_appendf(sb, " %llu:%ld", (unsigned long long)1 << b,
+                       ps->buckets[b]);
+        }
+        sb_append(sb, "\n");
+    }// for
+    sb_append(sb, "\n");
+}// report_area
+
+
+// Append a summary of all turns profiled so far to 'sb'.
+void
+prof_report(struct StringBuilder *sb) {
+    sb_append(sb, "Turn profile (time waiting for input excluded)\n\n");
+
+    bool any = false;
+    for (int area = 0; area < PA_MAX; area++) {
+        if (!Stats[area][PP_MAX].turns) { continue; }
+        report_area(sb, area);
+        any = true;
+    }// for
+
+    if (!any) { sb_append(sb, "No turns recorded yet.\n"); }
+}// prof_report
+
+#else
+
+void
+prof_report(struct StringBuilder *sb) {
+    sb_append(sb, "Turn profiling was not compiled in (see config.mk).\n");
+}// prof_report
+
+#endif // TURN_PROFILE
+
+
+// Append the report to the file named by the 'turn-profile-file'
+// option, if set.  This is registered with atexit().
+void
+prof_write_file() {
+    if (!GameSettings.turnProfileFile[0]) { return; }
+
+    FILE *fh = fopen(GameSettings.turnProfileFile, "a");
+    if (!fh) { return; }
+
+    struct StringBuilder *sb = sb_alloc();
+    prof_report(sb);
+    fprintf(fh, "%s\n", sb_str(sb));
+    sb_free(sb);
+
+    fclose(fh);
+}// prof_write_file
@@ -0,0 +1,84 @@
+// This file is part of ReLarn; Copyright (C) 1986 - 2023; GPLv2; NO WARRANTY!
+// See Copyright.txt, LICENSE.txt and AUTHORS.txt for terms.
+
+// Per-phase turn profiler.
+//
+// onemove() brackets each of its phases with prof_begin()/prof_end().
+// Elapsed times (minus any time spent waiting for a keypress; see
+// prof_pause()) are summed per turn and then added to a per-phase
+// log2 histogram for the kind of level the turn was played on, so
+// we can see which phase dominates keypress latency where.
+//
+// The same hooks also mark the turn and its phases in the session
+// trace, if there is one (see trace.h).
+//
+// Statistics are kept per thread, so programs playing several games
+// at once (relarn-sim) don't contend over them.
+//
+// The profiler is only built if TURN_PROFILE is defined (see
+// config.mk).  Otherwise, the timing functions below are empty
+// inline functions and cost nothing; prof_report() still exists but
+// just says so.
+
+#ifndef HDR_GUARD_PROFILE_H
+#define HDR_GUARD_PROFILE_H
+
+#include "stringbuilder.h"
+#include "trace.h"
+
+#include <stdbool.h>
+
+
+enum PROF_PHASE {
+    PP_FOV,             // see_and_update_fov()
+    PP_DISPLAY,         // update_display()
+    PP_ACTION,          // play_turn() or moveplayer()
+    PP_REGEN,           // regen()
+    PP_RECALC,          // recalc()
+    PP_RANDMONST,       // randmonst()
+    PP_LOOK,            // lookforobject()
+    PP_MOVEMONST,       // movemonst(), both calls if hasted
+
+    PP_MAX,
+};
+
+// Phase names; the extra entry (PP_MAX) is the turn as a whole.
+extern const char *ProfPhaseNames[PP_MAX + 1];
+
+void prof_report(struct StringBuilder *sb);
+void prof_write_file(void);
+
+#ifdef TURN_PROFILE
+
+void prof_turn_start(int level);
+void prof_phase_start(enum PROF_PHASE phase);
+void prof_phase_stop(enum PROF_PHASE phase);
+void prof_pause(void);
+void prof_resume(void);
+
+#else
+
+static inline void prof_turn_start(int level) {}
+static inline void prof_phase_start(enum PROF_PHASE phase) {}
+static inline void prof_phase_stop(enum PROF_PHASE phase) {}
+static inline void prof_pause(void) {}
+static inline void prof_resume(void) {}
+
+#endif // TURN_PROFILE
+
+
+// The hooks called by onemove().
+static inline void prof_next_turn(int level) {
+    trace_next_turn(level);
+    prof_turn_start(level);
+}
+static inline void prof_begin(enum PROF_PHASE phase) {
+    trace_begin(ProfPhaseNames[phase]);
+    prof_phase_start(phase);
+}
+static inline void prof_end(enum PROF_PHASE phase) {
+    prof_phase_stop(phase);
+    trace_end(ProfPhaseNames[phase]);
+}
+
+#endif
@@ -8,6 +8,8 @@
 #include "map.h"
 #include "store.h"
 
+#include <stddef.h>
+
 // PLATFORM_ID is an ID specific to the OS+CPU so we can detect
 // incompatible save files.  It needs to get set on the command line.
 // Currently uses the result of `uname -psr` but can be anything
@@ -16,8 +18,17 @@
 #   error "PLATFORM_ID is undefined."
 #endif
 
+// The layout of struct SaveGame.  Bump this when it changes and teach
+// load_stashed_game_from_file() to convert the previous one.
+//
+//  1. The original (no format number in the header).
+//  2. Timed effects are kept in a struct EffectTable.
+#define SAVE_FORMAT "2"
+
 // WARNING: this must be the same length as the generated string!
-#define RELARN_SAVE_ID_FMT "ReLarn " VERSION " " PLATFORM_ID " %d\n"
+#define RELARN_SAVE_ID_FMT                                              \
+    "ReLarn " VERSION " " PLATFORM_ID " %d f" SAVE_FORMAT "\n"
+#define RELARN_SAVE_ID_FMT_V1 "ReLarn " VERSION " " PLATFORM_ID " %d\n"
 
 struct SaveGame {
     char header[sizeof(RELARN_SAVE_ID_FMT)];
@@ -28,9 +39,61 @@ struct SaveGame {
     unsigned shopInventSz;
 };
 
-static struct SaveGame CurrentSave;
-volatile static bool stashedGameExists = false;
-volatile static bool stashOperationInProgress = false;
+// Format 1 kept a separate countdown (an int32_t) for each timed
+// effect where struct Player now has 'effects'.  The rest of it is
+// unchanged.
+struct PlayerV1 {
+    _Alignas(struct Player) char start[offsetof(struct Player, effects)];
+
+    int32_t effects[EFF_COUNT];     // See V1EffectOrder
+
+    struct EnlStat enlightenment;
+    struct SphereList spherelist;
+    bool known_obj[OBJ_COUNT];
+    bool spellknow[SPNUM];
+    bool banished[NUM_MONSTERS];
+    bool has_up_elevator;
+    bool has_down_elevator;
+    int32_t lifeprot;
+    bool killedBigBad;
+    int16_t monstCount;
+    bool wizardMode;
+    bool hasTheEyeOfLarn;
+};
+
+struct SaveGameV1 {
+    char header[sizeof(RELARN_SAVE_ID_FMT_V1)];
+    struct PlayerV1 uu;
+    struct World world;
+    struct Object invent[IVENSIZE];
+    struct StoreItem shopInvent[OBJ_COUNT];
+    unsigned shopInventSz;
+};
+
+// The order of the countdowns in struct PlayerV1.
+static const enum EFFECT V1EffectOrder[EFF_COUNT] = {
+    EFF_PROTECTION, EFF_DEXCOUNT, EFF_STRCOUNT, EFF_BLIND, EFF_CONFUSE,
+    EFF_ALTPRO, EFF_HERO, EFF_CHARM, EFF_INVISIBILITY, EFF_CANCELLATION,
+    EFF_HASTESELF, EFF_AGGRAVATE, EFF_GLOBE, EFF_SCAREMONST, EFF_AWARENESS,
+    EFF_HOLDMONST, EFF_TIMESTOP, EFF_HASTEMONST, EFF_SPIRITPRO,
+    EFF_UNDEADPRO, EFF_GIANTSTR, EFF_FIRERESISTANCE, EFF_STEALTH,
+    EFF_SEEINVISIBLE, EFF_MONSTER_DETECTION, EFF_WTW, EFF_ITCHING,
+    EFF_CLUMSINESS, EFF_HALFDAM, EFF_COKED,
+};
+
+// The stash lives in the game context.  CurrentSave is only valid
+// after alloc_current_save() has been called.
+#define CurrentSave                 (*GameCtx->currentSave)
+#define stashedGameExists           (GameCtx->stashedGameExists)
+#define stashOperationInProgress    (GameCtx->stashOperationInProgress)
+
+// Allocate the context's SaveGame if it doesn't have one yet.
+static void
+alloc_current_save() {
+    if (!GameCtx->currentSave) {
+        GameCtx->currentSave = xmalloc(sizeof(struct SaveGame));
+    }// if
+}// alloc_current_save
 
 
 // Test to see if a stashed game exists.  This is used for sanity
@@ -43,19 +106,31 @@ bool stash_op_in_progress() { return stashOperationInProgress; }
 // against to confirm that this is a valid savefile from a compatible
 // ReLarn version.  (This used to be a macro but it turns out it's
 // actually pretty difficult to distinguish between 32-bit and 64-bit
-// targets at compile time.)
+// targets at compile time.)  'fmt' is RELARN_SAVE_ID_FMT or the
+// format-1 equivalent; 'buf' must be at least as long.
 static const char*
-savefile_magic_string() {
-    static char magic_string[sizeof(RELARN_SAVE_ID_FMT)];
-    
-    if (!magic_string[0]) {
-        snprintf(magic_string, sizeof(magic_string),
-                 RELARN_SAVE_ID_FMT, (int)(8*sizeof(void*)));
+make_magic_string(char *buf, size_t bufsize, const char *fmt) {
+    if (!buf[0]) {
+        snprintf(buf, bufsize, fmt, (int)(8*sizeof(void*)));
     }
 
-    return magic_string;
+    return buf;
+}// make_magic_string
+
+static const char*
+savefile_magic_string() {
+    static char magic_string[sizeof(RELARN_SAVE_ID_FMT)];
+    return make_magic_string(magic_string, sizeof(magic_string),
+                             RELARN_SAVE_ID_FMT);
 }// savefile_magic_string
 
+static const char*
+savefile_magic_string_v1() {
+    static char magic_string[sizeof(RELARN_SAVE_ID_FMT_V1)];
+    return make_magic_string(magic_string, sizeof(magic_string),
+                             RELARN_SAVE_ID_FMT_V1);
+}// savefile_magic_string_v1
+
 
 // Copy the game state from the global state (and 'world') into the
 // SaveGame at CurrentSave.
@@ -69,13 +144,14 @@ stash_game_state() {
     ASSERT(!stashOperationInProgress);
     stashOperationInProgress = true;
 
+    alloc_current_save();
     strcpy(CurrentSave.header, savefile_magic_string());
 
     CurrentSave.uu = UU;
 
     stash_global_world_at(&CurrentSave.world);
 
-    memcpy(CurrentSave.invent, &Invent, sizeof(Invent));
+    memcpy(CurrentSave.invent, Invent, sizeof(CurrentSave.invent));
 
     memcpy(CurrentSave.shopInvent, &ShopInvent, sizeof(ShopInvent));
     CurrentSave.shopInventSz = ShopInventSz;
@@ -94,7 +170,7 @@ restore_global_game_state() {
 
     restore_global_world_from(&CurrentSave.world);
 
-    memcpy(&Invent, CurrentSave.invent, sizeof(Invent));
+    inv_set_all(CurrentSave.invent);
 
     memcpy(&ShopInvent, CurrentSave.shopInvent, sizeof(ShopInvent));
     ShopInventSz = CurrentSave.shopInventSz;
@@ -142,26 +218,88 @@ save_stashed_game_to_file(FILE *fh) {
 }// save_stashed_game_to_file
 
 
-bool
-load_stashed_game_from_file(FILE *fh, bool *wrongFileVersion) {
+// Test if the 'len' bytes at 'buf' are a save file whose contents
+// are 'size' bytes long and begin with 'magic'.
+static bool
+is_savefile(const unsigned char *buf, size_t len, size_t size,
+            const char *magic)
+{
+    if (len != size + sizeof(unsigned int)) { return false; }
+    if (memcmp(buf, magic, strlen(magic) + 1) != 0) { return false; }
 
-    ASSERT(!stashOperationInProgress);  // Whoah!
+    unsigned int filesum = 0;
+    memcpy(&filesum, buf + size, sizeof(filesum));
 
-    struct SaveGame game;
-    size_t read = fread(&game, 1, sizeof(struct SaveGame), fh);
+    return filesum == sum((unsigned char *)buf, size);
+}// is_savefile
 
-    if (!streq(savefile_magic_string(), game.header)) { return false; }
 
-    unsigned int filesum = 0;
-    read += fread(&filesum, 1, sizeof(filesum), fh);
+// Convert a format-1 save to the current format.
+static void
+convert_v1_save(const struct SaveGameV1 *old, struct SaveGame *game) {
+    memset(game, 0, sizeof(*game));
+    strcpy(game->header, savefile_magic_string());
 
-    if (read != sizeof(struct SaveGame) + sizeof(filesum)) { return false; }
+    const struct PlayerV1 *ou = &old->uu;
+    struct Player *uu = &game->uu;
 
-    unsigned int computed_filesum = sum((unsigned char *)&game, sizeof(game));
-    if (filesum != computed_filesum) { return false; }
+    memcpy(uu, ou->start, sizeof(ou->start));
 
-    CurrentSave = game;
-    stashedGameExists = true;
+    int32_t turns[EFF_COUNT];
+    for (int n = 0; n < EFF_COUNT; n++) {
+        turns[V1EffectOrder[n]] = ou->effects[n];
+    }// for
+    effect_table_init(&uu->effects, turns);
+
+    uu->enlightenment = ou->enlightenment;
+    uu->spherelist = ou->spherelist;
+    memcpy(uu->known_obj, ou->known_obj, sizeof(uu->known_obj));
+    memcpy(uu->spellknow, ou->spellknow, sizeof(uu->spellknow));
+    memcpy(uu->banished, ou->banished, sizeof(uu->banished));
+    uu->has_up_elevator = ou->has_up_elevator;
+    uu->has_down_elevator = ou->has_down_elevator;
+    uu->lifeprot = ou->lifeprot;
+    uu->killedBigBad = ou->killedBigBad;
+    uu->monstCount = ou->monstCount;
+    uu->wizardMode = ou->wizardMode;
+    uu->hasTheEyeOfLarn = ou->hasTheEyeOfLarn;
+
+    game->world = old->world;
+    memcpy(game->invent, old->invent, sizeof(game->invent));
+    memcpy(game->shopInvent, old->shopInvent, sizeof(game->shopInvent));
+    game->shopInventSz = old->shopInventSz;
+}// convert_v1_save
+
+
+bool
+load_stashed_game_from_file(FILE *fh, bool *wrongFileVersion) {
+
+    ASSERT(!stashOperationInProgress);  // Whoah!
+
+    // Read the whole file (plus a byte, to catch files that are too
+    // long); its size and header tell us which format it's in.
+    size_t bufsize = sizeof(unsigned int) + 1 +
+        (sizeof(struct SaveGame) > sizeof(struct SaveGameV1)
+         ? sizeof(struct SaveGame) : sizeof(struct SaveGameV1));
+    unsigned char *buf = xmalloc(bufsize);
+    size_t len = fread(buf, 1, bufsize, fh);
+
+    bool current = is_savefile(buf, len, sizeof(struct SaveGame),
+                               savefile_magic_string());
+    bool v1 = !current &&
+        is_savefile(buf, len, sizeof(struct SaveGameV1),
+                    savefile_magic_string_v1());
+
+    if (current || v1) {
+        alloc_current_save();
+        if (current) {
+            memcpy(&CurrentSave, buf, sizeof(struct SaveGame));
+        } else {
+            convert_v1_save((const struct SaveGameV1 *)buf, &CurrentSave);
+        }// if .. else
+        stashedGameExists = true;
+    }// if
 
-    return true;
+    free(buf);
+    return current || v1;
 }// load_stashed_game_from_file
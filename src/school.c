@@ -165,13 +165,13 @@ elapse_time(int num_turns) {
     UU.spells = UU.spellmax;
         
     /* cure blindness!  */
-    if (UU.blindCount) {
-        UU.blindCount = 1;
+    if (effect_left(EFF_BLIND)) {
+        effect_set(EFF_BLIND, 1);
     }/* if */
 
     /*  end confusion   */
-    if (UU.confuse) {
-        UU.confuse = 1;
+    if (effect_left(EFF_CONFUSE)) {
+        effect_set(EFF_CONFUSE, 1);
     }/* if */
 
     /* adjust parameters for time change */
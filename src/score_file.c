@@ -11,10 +11,60 @@
 #include "settings.h"
 #include "os.h"
 
+#include <limits.h>
+#include <stddef.h>
+
+
+// The scoreboard is stored in two files:
+//
+// 1. The data file (scoredata_path()): a header followed by
+//    ScoreBoardEntry records in the order they were added.  It is
+//    only ever appended to.
+//
+// 2. The index file (scoreindex_path()): a header followed by an
+//    IndexEntry for each of the first 'indexed' records in the data
+//    file, sorted by descending score.
+//
+// Records added since the index was last written (the "tail") are
+// read from the data file and sorted in memory when the board is
+// opened.  Once there are more than INDEX_MERGE_THRESHOLD of them,
+// they are merged into the index.  This keeps adding a score cheap
+// (an append plus, occasionally, a merge) and lets us fetch the top
+// N scores without reading the whole file.
+//
+// The index can always be rebuilt from the data file so if it's
+// missing or looks wrong, we just treat every record as part of the
+// tail.
+//
+// Locking works like this:
+//
+// - Writers (newscore(), ensureboard()) hold an exclusive lock on the
+//   data file, so there's only ever one.  A writer appends the new
+//   record just past the last published one, flushes it and only
+//   then publishes it by updating the record count in the header (a
+//   single aligned 8-byte write).
+//
+// - Readers don't lock the data file at all.  They read the published
+//   count and never look past it, so they can't see a partly-written
+//   record.  Published records are never modified.
+//
+// - Readers hold a shared lock on the index while using it.  Only a
+//   merge (which a writer does every INDEX_MERGE_THRESHOLD or so new
+//   scores) takes an exclusive lock on the index, so readers only
+//   wait for that, never for an ordinary append.  Readers never
+//   update the index themselves.
 
-//#define SCOREFILE SCOREBOARDDIR "/" SCORENAME
 #define SCORE_LINE_MAX 300
 
+#define INDEX_MERGE_THRESHOLD 512
+
+// Max. number of entries showscores() will display.
+#define SHOWSCORES_MAX 500
+
+#define SCORE_MAGIC "RLSCORE"
+#define INDEX_MAGIC "RLSCIDX"
+#define SCORE_FORMAT_VERSION 2
+
 struct ScoreBoardEntry {
     char        uid[OS_UID_STR_MAX+1];  // OS-specific user id rendered as a string
     long        won;                    // did the player win?  1 = yes, 0 = no
@@ -29,24 +79,78 @@ struct ScoreBoardEntry {
     char        ending[80];             // how the player met their end
 };
 
+// Header at the start of the data file.
+struct ScoreFileHeader {
+    char magic[8];          // SCORE_MAGIC
+    uint32_t version;       // SCORE_FORMAT_VERSION
+    uint32_t record_size;   // sizeof(struct ScoreBoardEntry)
+    uint64_t published;     // Number of complete records; see above
+};
 
-// Ensure we can write to the scoreboard file.  Also creates it if it
-// doesn't exist.
-void
-ensureboard() {
-    const char *sbpath = scoreboard_path();
+// Header at the start of the index file.
+struct ScoreIndexHeader {
+    char magic[8];          // INDEX_MAGIC
+    uint32_t version;       // SCORE_FORMAT_VERSION
+    uint32_t unused;
+    uint64_t indexed;       // Number of records in the index
+};
 
-    FILE *fh = fopen(sbpath, "ab");
-    ENSURE_MSG(fh, "Unable to write to scorefile.");
+// One entry in the index.
+struct IndexEntry {
+    int64_t score;
+    uint32_t record;        // Position of the record in the data file
+    uint32_t won;
+};
 
-    // We're going to test locking here and then just sort of assume
-    // it'll work from now on.  (I wouldn't do this for important
-    // software, but this is a game's scorefile so it's good enough.)
-    ENSURE_MSG(lock_file(fh), "Unable to lock scorefile.");
-    unlock_file(fh);
+// An open scoreboard.  This is also a cursor over the entries in
+// score order (see next_entry()).
+struct ScoreBoard {
+    FILE *data;
+    FILE *index;                // May be NULL
+    bool index_locked;
 
-    fclose(fh);
-}/* ensureboard*/
+    size_t num_records;         // Number of published records
+    size_t num_indexed;         // Number of those in the index
+
+    struct IndexEntry *tail;    // Unindexed entries, sorted
+    size_t num_tail;
+
+    // Cursor state
+    size_t index_remaining;     // Index entries not yet read
+    struct IndexEntry head;     // Next index entry, if have_head
+    bool have_head;
+    size_t tail_pos;            // Next entry in 'tail'
+};
+
+// Selects which entries a ScoreReader returns.
+struct ScoreFilter {
+    bool won_only;              // Only winning games
+    const char *uid;            // Only this user's games (NULL for all)
+};
+
+// A single pass over the entries matching a filter, best score
+// first.  Memory use is bounded by the index's unmerged tail (or the
+// limit), not by the size of the scoreboard.
+struct ScoreReader {
+    struct ScoreBoard board;
+    struct ScoreFilter filter;
+    size_t remaining;           // Max. number of entries left to return
+    bool error;                 // Set if reading a record failed
+};
+
+
+// Sort order for IndexEntry: highest score first; ties go to the
+// older entry.
+static int
+cmp_entry(const void *va, const void *vb) {
+    const struct IndexEntry *a = va, *b = vb;
+
+    if (a->score < b->score) { return 1; }
+    if (a->score > b->score) { return -1; }
+    if (a->record > b->record) { return 1; }
+    if (a->record < b->record) { return -1; }
+    return 0;
+}// cmp_entry
 
 
 // Replace all tabs or newlines in dest with spaces so that they don't
@@ -59,33 +163,8 @@ sanitize(struct ScoreBoardEntry* dest) {
 }// sanitize
 
 
-static char *
-encode(const struct ScoreBoardEntry* dest) {
-    static char buffer[SCORE_LINE_MAX];
-
-    snprintf(buffer, sizeof(buffer),
-             "%s\t%ld\t%ld\t%ld\t%ld\t%ld\t%ld\t%ld\t%s\t%s\t%s\n",
-             dest->uid,
-             dest->won,
-             dest->score,
-             dest->taxes,
-             dest->challenge,
-             dest->level,
-             dest->exp_level,
-             dest->gender,
-             dest->who,
-             dest->cclass,
-             dest->ending);
-
-    ASSERT(strlen(buffer) < sizeof(buffer));
-
-    return buffer;
-}// encode
-
-
-
-// Decode 'line' into 'dest'.  Returns true on success, false if an
-// error occurred.
+// Decode 'line' (in the old text scoreboard format) into 'dest'.
+// Returns true on success, false if an error occurred.
 //
 // WARNING: modifies argument 'line'.
 static bool
@@ -127,75 +206,441 @@ decode(char *line, struct ScoreBoardEntry* dest) {
         }// if .. else
     }// for
 
+    // The last field has the line's newline on it.
+    sanitize(dest);
+    for (size_t n = strlen(dest->ending); n > 0 && dest->ending[n-1] == ' '; n--){
+        dest->ending[n - 1] = 0;
+    }// for
+
     return true;
 }// decode
 
-// Comparision function for sorting the list of entries into
-// descending order
-static int
-cmp_sbe(const void *va, const void *vb) {
-    const struct ScoreBoardEntry *a = va, *b = vb;
 
-    if (a->score < b->score) { return 1; }
-    if (a->score > b->score) { return -1; }
-    return 0;
-}// cmp_sbe
+// Write the contents of the old text-format scoreboard (if present)
+// to the data file 'data' at the current position.  Returns the
+// number of entries written.
+static size_t
+import_text_scores(FILE *data) {
+    FILE *fh = fopen(scoreboard_path(), "r");
+    if (!fh) { return 0; }
 
+    size_t count = 0, bad = 0;
+    char line[SCORE_LINE_MAX];
+    while (fgets(line, sizeof(line), fh)) {
+        struct ScoreBoardEntry item;
+        memset(&item, 0, sizeof(item));
 
-// Return the scorefile as an array of structs.  *count is set to the
-// number of items.
-//
-// On error, *count is set to a non-zero value to distinguish between
-// an empty scorefile.
-static struct ScoreBoardEntry *
-load_scorefile(size_t *count) {
-    *count = 0;
+        if (!decode(line, &item)) {
+            ++bad;
+            continue;
+        }// if
 
-    FILE *fh = fopen(scoreboard_path(), "r+b");
-    if (!fh) { return NULL; }
+        if (fwrite(&item, sizeof(item), 1, data) != 1) { break; }
+        ++count;
+    }// while
 
-    lock_file(fh);
+    fclose(fh);
 
-    struct ScoreBoardEntry *result = NULL;
-    size_t num_entries = 0;
-    bool error = false;
+    if (bad) {
+        say("Skipped %zu malformed line(s) in '%s'.\n", bad,
+            scoreboard_path());
+    }// if
 
-    for (int n = 0; ; n++) {
-        struct ScoreBoardEntry item;
-        char line[SCORE_LINE_MAX];
+    return count;
+}// import_text_scores
 
-        char *ok = fgets(line, sizeof(line), fh);
-        if (!ok) {
-            if (feof(fh)) { break; }
-            error = true;
-            break;
-        }
 
-        if (!decode(line, &item)) {
-            error = true;
-            break;
-        }
+// Write 'count' into the 'published' field of the data file's
+// header, making that many records visible to readers.
+static bool
+publish(FILE *data, uint64_t count) {
+    return
+        fseek(data, offsetof(struct ScoreFileHeader, published),
+              SEEK_SET) == 0 &&
+        fwrite(&count, sizeof(count), 1, data) == 1 &&
+        fflush(data) == 0;
+}// publish
 
-        ++num_entries;
-        result = xrealloc(result, num_entries * sizeof(struct ScoreBoardEntry));
-        memcpy(&result[num_entries - 1], &item, sizeof(struct ScoreBoardEntry));
-    }// for
 
+// Ensure we can write to the scoreboard file.  Also creates it if it
+// doesn't exist, importing the old text scoreboard if there is one.
+void
+ensureboard() {
+    // Create the file if needed.
+    FILE *fh = fopen(scoredata_path(), "ab");
+    ENSURE_MSG(fh, "Unable to write to scorefile.");
+    fclose(fh);
+
+    fh = fopen(scoredata_path(), "r+b");
+    ENSURE_MSG(fh, "Unable to write to scorefile.");
+
+    // We're going to test locking here and then just sort of assume
+    // it'll work from now on.  (I wouldn't do this for important
+    // software, but this is a game's scorefile so it's good enough.)
+    ENSURE_MSG(lock_file(fh), "Unable to lock scorefile.");
+
+    // If the file is new (or was created empty by the installer), we
+    // write the header and bring over the old scores.
+    fseek(fh, 0, SEEK_END);
+    if (ftell(fh) == 0) {
+        struct ScoreFileHeader hdr;
+        memset(&hdr, 0, sizeof(hdr));
+        zstrncpy(hdr.magic, SCORE_MAGIC, sizeof(hdr.magic));
+        hdr.version = SCORE_FORMAT_VERSION;
+        hdr.record_size = sizeof(struct ScoreBoardEntry);
+
+        ENSURE_MSG(fwrite(&hdr, sizeof(hdr), 1, fh) == 1,
+                   "Unable to initialize scorefile.");
+
+        size_t count = import_text_scores(fh);
+        ENSURE_MSG(fflush(fh) == 0 && publish(fh, count),
+                   "Unable to initialize scorefile.");
+    }// if
+
+    fseek(fh, 0, SEEK_SET);
     unlock_file(fh);
+
     fclose(fh);
+}/* ensureboard*/
+
+
+// Read and check the data file's header, returning the number of
+// published records or -1 on error.
+static long
+read_data_header(FILE *data) {
+    struct ScoreFileHeader hdr;
+    bool ok =
+        fseek(data, 0, SEEK_SET) == 0 &&
+        fread(&hdr, sizeof(hdr), 1, data) == 1 &&
+        strncmp(hdr.magic, SCORE_MAGIC, sizeof(hdr.magic)) == 0 &&
+        hdr.version == SCORE_FORMAT_VERSION &&
+        hdr.record_size == sizeof(struct ScoreBoardEntry) &&
+        hdr.published <= LONG_MAX;
+
+    return ok ? (long)hdr.published : -1;
+}// read_data_header
+
+
+// Read record number 'recnum' from the data file into 'dest'.
+static bool
+read_record(struct ScoreBoard *sb, size_t recnum,
+            struct ScoreBoardEntry *dest) {
+    long pos = sizeof(struct ScoreFileHeader) +
+        recnum * sizeof(struct ScoreBoardEntry);
+
+    return
+        fseek(sb->data, pos, SEEK_SET) == 0 &&
+        fread(dest, sizeof(*dest), 1, sb->data) == 1;
+}// read_record
+
+
+// Reset the cursor in 'sb' to the highest score.
+static void
+rewind_entries(struct ScoreBoard *sb) {
+    sb->index_remaining = 0;
+    sb->have_head = false;
+    sb->tail_pos = 0;
+
+    if (sb->index &&
+        fseek(sb->index, sizeof(struct ScoreIndexHeader), SEEK_SET) == 0)
+    {
+        sb->index_remaining = sb->num_indexed;
+    }// if
+}// rewind_entries
+
+
+// Fetch the next entry (in score order) from 'sb' into 'dest'.
+// Returns false if there are no more.
+static bool
+next_entry(struct ScoreBoard *sb, struct IndexEntry *dest) {
+    if (!sb->have_head && sb->index_remaining > 0) {
+        --sb->index_remaining;
+        sb->have_head = fread(&sb->head, sizeof(sb->head), 1, sb->index) == 1;
+        if (!sb->have_head) { sb->index_remaining = 0; }
+    }// if
+
+    // Take whichever of the next index entry and the next tail entry
+    // comes first.
+    if (sb->tail_pos < sb->num_tail &&
+        (!sb->have_head || cmp_entry(&sb->tail[sb->tail_pos], &sb->head) < 0))
+    {
+        *dest = sb->tail[sb->tail_pos++];
+        return true;
+    }// if
+
+    if (sb->have_head) {
+        *dest = sb->head;
+        sb->have_head = false;
+        return true;
+    }// if
+
+    return false;
+}// next_entry
+
+
+// Rewrite the index file so that it covers every record in the data
+// file.
+static void
+merge_index(struct ScoreBoard *sb) {
+    ASSERT(sb->index && sb->index_locked);
+
+    size_t total = sb->num_indexed + sb->num_tail;
+    struct IndexEntry *entries = xmalloc((total + 1) * sizeof(*entries));
+
+    size_t count = 0;
+    rewind_entries(sb);
+    while (count < total && next_entry(sb, &entries[count])) {
+        ++count;
+    }// while
+
+    // Mark the index empty while we rewrite it so that if we're
+    // interrupted, the next reader just rebuilds it.
+    struct ScoreIndexHeader hdr;
+    memset(&hdr, 0, sizeof(hdr));
+    zstrncpy(hdr.magic, INDEX_MAGIC, sizeof(hdr.magic));
+    hdr.version = SCORE_FORMAT_VERSION;
+
+    bool ok =
+        fseek(sb->index, 0, SEEK_SET) == 0 &&
+        fwrite(&hdr, sizeof(hdr), 1, sb->index) == 1 &&
+        fwrite(entries, sizeof(*entries), count, sb->index) == count &&
+        fflush(sb->index) == 0;
+
+    if (ok) {
+        hdr.indexed = count;
+        ok = fseek(sb->index, 0, SEEK_SET) == 0 &&
+            fwrite(&hdr, sizeof(hdr), 1, sb->index) == 1 &&
+            fflush(sb->index) == 0;
+    }// if
+
+    free(entries);
 
-    if (error) {
-        free(result);
-        *count = 42;
-        return NULL;
+    // If writing failed, we leave things as they were; the entries
+    // are all still available via the old index and the tail.
+    if (!ok) { return; }
+
+    free(sb->tail);
+    sb->tail = NULL;
+    sb->num_tail = 0;
+    sb->num_indexed = count;
+}// merge_index
+
+
+// Read the index header from sb->index (if open) and set
+// sb->num_indexed from it.  If it's missing or damaged, num_indexed
+// is 0.
+static void
+read_index_header(struct ScoreBoard *sb) {
+    sb->num_indexed = 0;
+    if (!sb->index) { return; }
+
+    struct ScoreIndexHeader hdr;
+    if (fseek(sb->index, 0, SEEK_SET) != 0 ||
+        fread(&hdr, sizeof(hdr), 1, sb->index) != 1 ||
+        strncmp(hdr.magic, INDEX_MAGIC, sizeof(hdr.magic)) != 0 ||
+        hdr.version != SCORE_FORMAT_VERSION ||
+        hdr.indexed > sb->num_records)
+    {
+        return;
+    }// if
+
+    sb->num_indexed = hdr.indexed;
+}// read_index_header
+
+
+// Test if 'item' is selected by 'filter' (NULL selects everything).
+static bool
+matches(const struct ScoreFilter *filter,
+        const struct ScoreBoardEntry *item) {
+    return !filter || (
+        (!filter->won_only || item->won) &&
+        (!filter->uid || streq(filter->uid, item->uid)) );
+}// matches
+
+
+// Helpers for a bounded heap of IndexEntry (see heap_offer()).  The
+// root is the lowest-ranked entry.
+static void
+heap_swap(struct IndexEntry *heap, size_t a, size_t b) {
+    struct IndexEntry tmp = heap[a];
+    heap[a] = heap[b];
+    heap[b] = tmp;
+}// heap_swap
+
+static void
+heap_sift_down(struct IndexEntry *heap, size_t len, size_t pos) {
+    for (;;) {
+        size_t worst = pos, left = 2*pos + 1, right = left + 1;
+
+        if (left < len && cmp_entry(&heap[left], &heap[worst]) > 0) {
+            worst = left;
+        }
+        if (right < len && cmp_entry(&heap[right], &heap[worst]) > 0) {
+            worst = right;
+        }
+        if (worst == pos) { return; }
+
+        heap_swap(heap, pos, worst);
+        pos = worst;
+    }// for
+}// heap_sift_down
+
+// Add 'entry' to 'heap' (currently '*len' entries long) but keep no
+// more than the 'max' best entries.
+static void
+heap_offer(struct IndexEntry *heap, size_t *len, size_t max,
+           struct IndexEntry entry) {
+    if (*len < max) {
+        size_t pos = (*len)++;
+        heap[pos] = entry;
+
+        while (pos > 0 && cmp_entry(&heap[pos], &heap[(pos-1)/2]) > 0) {
+            heap_swap(heap, pos, (pos-1)/2);
+            pos = (pos-1)/2;
+        }// while
+        return;
+    }// if
+
+    // If it's better than the worst entry we're keeping, it replaces it.
+    if (max > 0 && cmp_entry(&entry, &heap[0]) < 0) {
+        heap[0] = entry;
+        heap_sift_down(heap, *len, 0);
+    }// if
+}// heap_offer
+
+
+// Read the records not covered by the index into sb->tail and sort
+// them.  Only records selected by 'filter' are kept and of those,
+// only the best 'limit'; this is done in a single pass with a bounded
+// heap so memory use is proportional to 'limit'.
+static bool
+load_tail(struct ScoreBoard *sb, const struct ScoreFilter *filter,
+          size_t limit) {
+    size_t count = sb->num_records - sb->num_indexed;
+    size_t keep = count < limit ? count : limit;
+
+    sb->num_tail = 0;
+    sb->tail = xmalloc((keep + 1) * sizeof(struct IndexEntry));
+    if (keep == 0) { return true; }
+
+    for (size_t n = 0; n < count; n++) {
+        size_t recnum = sb->num_indexed + n;
+        struct ScoreBoardEntry item;
+
+        // Sequential, so we only need to seek for the first one.
+        if (n == 0 ? !read_record(sb, recnum, &item)
+                   : fread(&item, sizeof(item), 1, sb->data) != 1)
+        {
+            return false;
+        }// if
+
+        if (!matches(filter, &item)) { continue; }
+
+        struct IndexEntry ie = { item.score, recnum, !!item.won };
+        heap_offer(sb->tail, &sb->num_tail, keep, ie);
+    }// for
+
+    qsort(sb->tail, sb->num_tail, sizeof(struct IndexEntry), cmp_entry);
+    return true;
+}// load_tail
+
+
+// Close 'sb', releasing the index lock and freeing its memory.
+static void
+close_board(struct ScoreBoard *sb) {
+    if (sb->index) {
+        if (sb->index_locked) {
+            fseek(sb->index, 0, SEEK_SET);
+            unlock_file(sb->index);
+        }
+        fclose(sb->index);
+    }// if
+
+    if (sb->data) { fclose(sb->data); }
+
+    free(sb->tail);
+}// close_board
+
+
+// Open the scoreboard for reading.  'filter' and 'limit' say which
+// entries the caller wants from the tail (see load_tail()); index
+// entries are not filtered.
+//
+// Returns SB_OK on success.  SB_MISSING means there's no scoreboard
+// yet (which is not really an error) and SB_ERROR means it's
+// unreadable.  On failure, nothing needs to be closed.
+enum SB_STATUS { SB_OK, SB_MISSING, SB_ERROR };
+static enum SB_STATUS
+open_board(struct ScoreBoard *sb, const struct ScoreFilter *filter,
+           size_t limit) {
+    memset(sb, 0, sizeof(*sb));
+
+    // Lock the index first.  Since merges happen with the index
+    // locked, this guarantees the index won't cover records that
+    // weren't published when we read the count below.
+    sb->index = fopen(scoreindex_path(), "rb");
+    if (sb->index) {
+        sb->index_locked = lock_file_shared(sb->index);
+    }// if
+
+    sb->data = fopen(scoredata_path(), "rb");
+    if (!sb->data) {
+        close_board(sb);
+        return SB_MISSING;
+    }// if
+
+    long published = read_data_header(sb->data);
+    if (published < 0) {
+        close_board(sb);
+        return SB_ERROR;
+    }// if
+    sb->num_records = published;
+
+    read_index_header(sb);
+
+    if (!load_tail(sb, filter, limit)) {
+        close_board(sb);
+        return SB_ERROR;
+    }// if
+
+    rewind_entries(sb);
+
+    return SB_OK;
+}// open_board
+
+
+// Merge the records in 'data' that aren't in the index into it.  The
+// caller must hold the exclusive lock on 'data'.
+static void
+update_index(FILE *data, size_t num_records) {
+    struct ScoreBoard sb;
+    memset(&sb, 0, sizeof(sb));
+
+    sb.data = data;
+    sb.num_records = num_records;
+
+    sb.index = fopen(scoreindex_path(), "r+b");
+    if (!sb.index) {
+        sb.index = fopen(scoreindex_path(), "w+b");
     }
+    if (!sb.index) { return; }     // Readers will cope
 
-    qsort(result, num_entries, sizeof(struct ScoreBoardEntry), cmp_sbe);
+    // We can read the header without the lock since only the holder
+    // of the data file lock (i.e. us) ever writes to the index.
+    read_index_header(&sb);
 
-    *count = num_entries;
-    return result;
-}// load_scorefile
+    if (num_records - sb.num_indexed > INDEX_MERGE_THRESHOLD) {
+        fseek(sb.index, 0, SEEK_SET);
+        sb.index_locked = lock_file(sb.index);
 
+        if (load_tail(&sb, NULL, SIZE_MAX)) {
+            merge_index(&sb);
+        }// if
+    }// if
+
+    sb.data = NULL;     // Not ours to close
+    close_board(&sb);
+}// update_index
 
 
 // Append a new score to the scorefile.
@@ -203,6 +648,7 @@ bool
 newscore(long score, bool won, int level, const char *ending,
          const struct Player *uu) {
     struct ScoreBoardEntry sb;
+    memset(&sb, 0, sizeof(sb));
 
     zstrncpy(sb.uid, get_user_id(), OS_UID_STR_MAX);
     zstrncpy(sb.who, uu->name, sizeof(sb.who));
@@ -219,41 +665,93 @@ newscore(long score, bool won, int level, const char *ending,
     // Sanitize the strings
     sanitize(&sb);
 
-    FILE *fh = fopen(scoreboard_path(), "ab");
-    if (!fh) { return false; }
-    lock_file(fh);
+    FILE *data = fopen(scoredata_path(), "r+b");
+    if (!data) { return false; }
+    lock_file(data);
+
+    // Write the new record just past the last published one (i.e.
+    // over anything left by an interrupted write), then publish it.
+    long published = read_data_header(data);
+    long pos = sizeof(struct ScoreFileHeader) +
+        published * sizeof(struct ScoreBoardEntry);
+    bool status =
+        published >= 0 &&
+        fseek(data, pos, SEEK_SET) == 0 &&
+        fwrite(&sb, sizeof(sb), 1, data) == 1 &&
+        fflush(data) == 0 &&
+        publish(data, published + 1);
+
+    if (status) {
+        update_index(data, published + 1);
+    }// if
 
-    int status = fputs(encode(&sb), fh);
+    fseek(data, 0, SEEK_SET);
+    unlock_file(data);
+    fclose(data);
 
-    unlock_file(fh);
-    fclose(fh);
-
-    return status >= 0;
+    return status;
 }/* newscore*/
 
 
+// Open a ScoreReader on the scoreboard that will return up to 'limit'
+// entries matching 'filter', best first.  Returns SB_OK on success,
+// in which case 'rd' must be closed with reader_close().
+static enum SB_STATUS
+reader_open(struct ScoreReader *rd, struct ScoreFilter filter, size_t limit) {
+    rd->filter = filter;
+    rd->remaining = limit;
+    rd->error = false;
+
+    return open_board(&rd->board, &rd->filter, limit);
+}// reader_open
+
+// Fetch the next matching entry into 'dest'; returns false if there
+// are no more or if an error occurred (in which case rd->error is
+// set).
+static bool
+reader_next(struct ScoreReader *rd, struct ScoreBoardEntry *dest) {
+    struct IndexEntry ie;
+
+    while (rd->remaining > 0 && next_entry(&rd->board, &ie)) {
+        // We can skip the read for losing games if only winners are
+        // wanted.
+        if (rd->filter.won_only && !ie.won) { continue; }
+
+        if (!read_record(&rd->board, ie.record, dest)) {
+            rd->error = true;
+            return false;
+        }// if
+
+        if (!matches(&rd->filter, dest)) { continue; }
+
+        --rd->remaining;
+        return true;
+    }// while
+
+    return false;
+}// reader_next
+
+static void
+reader_close(struct ScoreReader *rd) {
+    close_board(&rd->board);
+}// reader_close
+
+
 // Retrieve taxes owed from the scoreboard.
 long
 get_taxes_owed() {
-    long taxes = -1;
-    if (taxes >= 0) { return taxes; }
+    // Find this user's best winning game.
+    struct ScoreFilter filter = { true, get_user_id() };
+    struct ScoreReader rd;
+    if (reader_open(&rd, filter, 1) != SB_OK) { return 0; }
 
-    size_t len = 0;
-    struct ScoreBoardEntry *items = load_scorefile(&len);
-    if (!items) {
-        return 0;
+    long taxes = -1;
+    struct ScoreBoardEntry item;
+    if (reader_next(&rd, &item)) {
+        taxes = item.taxes;
     }// if
 
-    const char * userid = get_user_id();
-
-    for (size_t n = 0; n < len; n++) {
-        if (streq(items[n].uid, userid) && items[n].won) {
-            taxes = items[n].taxes;
-            break;
-        }// if
-    }// for
-
-    free(items);
+    reader_close(&rd);
     return taxes;
 }// get_taxes_owed
 
@@ -263,9 +761,6 @@ showscores(bool all) {
     char buffer[400];
 
     struct TextBuffer *dest = tb_malloc(INF_BUFFER, SCREEN_W);
-    
-    size_t len = 0;
-    struct ScoreBoardEntry *items = load_scorefile(&len);
 
     // Heading
     snprintf(buffer, sizeof(buffer),
@@ -273,24 +768,18 @@ showscores(bool all) {
              "Score", "", "Challenge", "Floor", "Level");
     tb_append(dest, buffer);
 
-    if (!items && len > 0) {
-        tb_append(dest, "\n");
-        tb_append(dest, "    *** Error reading score file ***");
-        len = 0;
-    }
-
-    size_t n;
-    for (n = 0; n < len; n++) {
-        struct ScoreBoardEntry item = items[n];
-
-        if (!all && !item.won) { continue; }
+    struct ScoreFilter filter = { !all, NULL };
+    struct ScoreReader rd;
+    enum SB_STATUS status = reader_open(&rd, filter, SHOWSCORES_MAX);
 
+    struct ScoreBoardEntry item;
+    while (status == SB_OK && reader_next(&rd, &item)) {
         char nbuf[sizeof(item.who) + sizeof(item.cclass) + 60];
         snprintf(nbuf, sizeof(nbuf), "%s the %s %s", item.who,
                  female((enum GENDER)item.gender), item.cclass);
 
         snprintf(buffer, sizeof(buffer),
-                 "%9ld %-5s %-9d %-5d %-5d\n%s, you %s\n",
+                 "%9ld %-5s %-9d %-5d %-5d\n%s, you %s\n\n",
                  item.score,
                  (all && item.won) ? "(won)" : "",
                  (int)item.challenge + 1,
@@ -299,7 +788,17 @@ showscores(bool all) {
                  nbuf,
                  item.ending);
         tb_append(dest, buffer);
-    }// for
+    }// while
+
+    if (status == SB_OK) {
+        if (rd.error) { status = SB_ERROR; }
+        reader_close(&rd);
+    }// if
+
+    if (status == SB_ERROR) {
+        tb_append(dest, "\n");
+        tb_append(dest, "    *** Error reading score file ***");
+    }
 
     showpages(dest);
 
@@ -326,16 +825,17 @@ write_scores(const char *filename) {
             "# name\tgender\tclass\tscore\twon?\tskill\tfloor\t"
             "exp\tending description\n");
 
-    size_t len = 0;
-    struct ScoreBoardEntry *items = load_scorefile(&len);
-
-    size_t n;
-    for (n = 0; n < len; n++) {
-        struct ScoreBoardEntry item = items[n];
+    // This streams the entries so memory use doesn't depend on the
+    // size of the scoreboard (as long as the index is up to date).
+    struct ScoreFilter filter = { false, NULL };
+    struct ScoreReader rd;
+    enum SB_STATUS status = reader_open(&rd, filter, SIZE_MAX);
 
+    struct ScoreBoardEntry item;
+    while (status == SB_OK && reader_next(&rd, &item)) {
         fprintf(fh,
 
-                "%s\t%s\t%s\t" "%ld\t%s\t" "%d\t%d\t%d\t%s",
+                "%s\t%s\t%s\t" "%ld\t%s\t" "%d\t%d\t%d\t%s\n",
 
                 item.who,
                 female((enum GENDER)item.gender),
@@ -348,13 +848,16 @@ write_scores(const char *filename) {
                 (int)item.level,
                 (int)item.exp_level,
                 item.ending);
-    }// for
+    }// while
+
+    if (status == SB_OK) {
+        if (rd.error) { status = SB_ERROR; }
+        reader_close(&rd);
+    }// if
 
-    free(items);
-    
     if (fh != stdout) {
         fclose(fh);
     }// if
 
-    return true;
+    return status != SB_ERROR;
 }// write_scores
@@ -361,6 +361,30 @@ readopts (const char *opts_file) {
             continue;
         }// if
 
+        if (opt(line, "render-stats-file:", &arg)) {
+            zstrncpy(GameSettings.renderStatsFile, arg,
+                     sizeof(GameSettings.renderStatsFile));
+            continue;
+        }// if
+
+        if (opt(line, "turn-profile-file:", &arg)) {
+            zstrncpy(GameSettings.turnProfileFile, arg,
+                     sizeof(GameSettings.turnProfileFile));
+            continue;
+        }// if
+
+        if (opt(line, "alloc-stats-file:", &arg)) {
+            zstrncpy(GameSettings.allocStatsFile, arg,
+                     sizeof(GameSettings.allocStatsFile));
+            continue;
+        }// if
+
+        if (opt(line, "trace-file:", &arg)) {
+            zstrncpy(GameSettings.traceFile, arg,
+                     sizeof(GameSettings.traceFile));
+            continue;
+        }// if
+
         // Unknown token:
         say(CFGERR "Unknown config option: '%s'\n", line);
     }/* while */
@@ -40,6 +40,10 @@ struct Options {
     bool showFoV;                   // Highlight area of visibility
     bool showUnrevealed;            // Show unexplored sections as gray
     bool drawDebugging;             // Debug option
+    char renderStatsFile[MAXPATHLEN];   // CSV file for per-turn render stats
+    char turnProfileFile[MAXPATHLEN];   // Turn profile is appended here on exit
+    char allocStatsFile[MAXPATHLEN];    // Ditto for allocation statistics
+    char traceFile[MAXPATHLEN];         // Chrome trace of the session
 
     bool darkScreen;                // Color for light on dark screen
     bool darkScreenSet;             // darkScreen was explicitly set.
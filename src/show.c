@@ -8,6 +8,7 @@
 #include "ui.h"
 
 #include "game.h"
+#include "arena.h"
 
 
 /* Return a string describing the index'th item in inventory.  If
@@ -18,7 +19,7 @@
 const char *
 inv_line(int index, enum PRICEMODE pricemode) {
     struct Object obj = Invent[index];
-    static char result[400];
+    static __thread char result[400];
 
     zstrncpy(result, knownobjname(obj), sizeof(result));
 
@@ -56,18 +57,17 @@ inv_line(int index, enum PRICEMODE pricemode) {
    there is nothing acceptible in the inventory. */
 int
 inv_pick(const char *desc, unsigned filter, enum PRICEMODE pricemode) {
+    struct ArenaMark scope = arena_mark();
+
     int *ids = NULL;
     int count = inv_pick_multi(desc, filter, pricemode, &ids, false);
+    ASSERT(count <= 1);
 
     // Return special values if there were no selections or no
     // selectables.
-    if (count == 0) { return -1; }
-    if (count < 0) { return -2; }
-
-    ASSERT(count == 1);
+    int result = count == 0 ? -1 : count < 0 ? -2 : ids[0];
 
-    int result = ids[0];
-    free(ids);
+    arena_release(scope);
     return result;
 }/* inv_pick*/
 
@@ -75,8 +75,8 @@ inv_pick(const char *desc, unsigned filter, enum PRICEMODE pricemode) {
 
 // Display the inventory and let the player choose zero or more
 // items. Returns number of selected items and stores their IDs in
-// *ids, which it allocates.  If there are no qualifying items,
-// returns -2.
+// *ids, which comes from the arena (see pick_multi()).  If there are
+// no qualifying items, returns -2.
 int
 inv_pick_multi(const char *desc, unsigned filter, enum PRICEMODE pricemode,
                int **ids, bool multi) {
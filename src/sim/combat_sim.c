@@ -0,0 +1,509 @@
+// This file is part of ReLarn; Copyright (C) 1986 - 2023; GPLv2; NO WARRANTY!
+// See Copyright.txt, LICENSE.txt and AUTHORS.txt for terms.
+
+// combat-sim: Monte Carlo melee simulator over the monster table.
+//
+// Pits synthetic players against every monster (or a chosen few) and
+// writes a CSV table of how the fights went: win/loss rates, fight
+// length and the expected damage done per blow in each direction.
+// The sweep covers every combination of monster, player level,
+// loadout (weapon and armor) and difficulty ("challenge") level.
+//
+// The fights use the game's own combat code: each round the player
+// swings with hit_mon_melee() and, if the monster is still there, it
+// answers with hitplayer().  Everything those do (special attacks,
+// rust, level drain, dulling weapons, challenge scaling, etc.) is
+// included.  Movement, spells and regeneration are not.  A fight
+// ends when one side dies, the monster teleports away ("fled", e.g.
+// after stealing) or it goes on for too many rounds ("draw").
+//
+// A player is built from a character class by init_new_player(),
+// given the loadout and levelled up with raiselevel() so that their
+// hit points and stats are what a real player's would be.  Every
+// monster faces the same player for a given level/loadout/challenge
+// and each fight starts from a copy of it.  The arena is a blank
+// level in the thread's own game context.
+//
+// Each (build, monster) cell has its own seed so the table doesn't
+// depend on the number of threads.  Cells are handed out to the
+// workers a few at a time; since they're ordered by build, a worker
+// seldom needs to make a new player.  Nothing goes to the screen:
+// the headless UI discards say() and friends.
+//
+// Run from src/ (or with RELARN_INSTALL_ROOT set) so that the game's
+// data files can be found.
+
+#include "game_context.h"
+#include "map.h"
+#include "monster.h"
+#include "player.h"
+#include "settings.h"
+#include "os.h"
+#include "util.h"
+
+#include "bench/ui_headless.h"
+
+#include <pthread.h>
+#include <setjmp.h>
+#include <stdio.h>
+#include <unistd.h>
+
+// What can happen in a fight
+enum OUTCOME {
+    OC_WIN,
+    OC_LOSS,
+    OC_FLED,
+    OC_DRAW,
+
+    OC_COUNT
+};
+
+// The player's equipment; ONONE for none
+struct Loadout {
+    enum OBJECT_ID weapon, armor;
+};
+
+static const struct Loadout Loadouts[] = {
+    {ONONE,         ONONE},
+    {ODAGGER,       OLEATHER},
+    {OSPEAR,        OSTUDLEATHER},
+    {OFLAIL,        ORING},
+    {OLONGSWORD,    OCHAIN},
+    {O2SWORD,       OSPLINT},
+    {OSWORD,        OPLATEARMOR},
+};
+#define NUM_LOADOUTS ((int)(sizeof(Loadouts) / sizeof(Loadouts[0])))
+
+// Inventory slots for the loadout.  (Not slot 0: hit_mon_melee()
+// only dulls weapons wielded from other slots.)
+#define ARMOR_SLOT  1
+#define WEAPON_SLOT 2
+
+// Where the fight happens
+#define ARENA_LEVEL 1
+#define PLAYER_X    (MAXX / 2)
+#define PLAYER_Y    (MAXY / 2)
+#define MONST_X     (PLAYER_X + 1)
+#define MONST_Y     PLAYER_Y
+
+// Tallies for one cell of the table
+struct CellResult {
+    long outcomes[OC_COUNT];
+    long rounds;
+    long dealt, swings;         // Damage done to the monster
+    long taken, attacks;        // Damage done to the player
+};
+
+// Cells handed to a worker at a time
+#define CELL_CHUNK 8
+
+
+// Settings.  These are set up before the workers start and are
+// read-only afterward.
+static long FightsPerCell = 1000;
+static int NumWorkers = 0;
+static unsigned long BaseSeed = 1;
+static int MaxRounds = 200;
+static enum CHAR_CLASS CClass = CCOGRE;
+
+static int *Monsters = NULL, NumMonsters = 0;
+static int *Levels = NULL, NumLevels = 0;
+static int *Challenges = NULL, NumChallenges = 0;
+
+static long NumCells = 0;
+static struct CellResult *Results = NULL;
+
+static pthread_mutex_t NextCellLock = PTHREAD_MUTEX_INITIALIZER;
+static long NextCell = 0;
+
+
+//
+// Cells
+//
+
+// Cells are numbered build-major: all the monsters for the first
+// build, then all the monsters for the second, etc.  Builds are
+// numbered challenge-major, then level, then loadout.
+static int
+cell_build(long cell)           { return cell / NumMonsters; }
+
+static int
+cell_monster(long cell)         { return Monsters[cell % NumMonsters]; }
+
+static int
+build_loadout(int build)        { return build % NUM_LOADOUTS; }
+
+static int
+build_level(int build)          { return Levels[build / NUM_LOADOUTS % NumLevels]; }
+
+static int
+build_challenge(int build) {
+    return Challenges[build / NUM_LOADOUTS / NumLevels];
+}// build_challenge
+
+
+//
+// Fighting
+//
+
+// The player everyone fights, as set up by make_player()
+struct Build {
+    int id;                     // -1 if none yet
+    struct Player uu;
+    struct Object invent[IVENSIZE];
+};
+
+static __thread jmp_buf PlayerDied;
+
+static void
+player_died(int cause) {
+    longjmp(PlayerDied, 1);
+}// player_died
+
+
+// Create the player for build 'build' in 'bd'.
+static void
+make_player(int build, struct Build *bd) {
+    const struct Loadout *lo = &Loadouts[build_loadout(build)];
+
+    // (init_new_player() expects a zeroed Player, as in a new game.)
+    memset(&UU, 0, sizeof(UU));
+    seed_rng(BaseSeed + build);
+    init_new_player(CClass, FEMALE, MALE, build_challenge(build));
+
+    for (int n = 0; n < IVENSIZE; n++) {
+        inv_set(n, NULL_OBJ);
+    }// for
+    if (lo->armor != ONONE) {
+        inv_set(ARMOR_SLOT, obj(lo->armor, 0));
+        UU.wear = ARMOR_SLOT;
+    }// if
+    if (lo->weapon != ONONE) {
+        inv_set(WEAPON_SLOT, obj(lo->weapon, 0));
+        UU.wield = WEAPON_SLOT;
+    }// if
+
+    while (UU.level < build_level(build)) {
+        raiselevel();
+    }// while
+
+    UU.x = PLAYER_X;
+    UU.y = PLAYER_Y;
+    UU.hp = UU.hpmax;
+    recalc();
+
+    bd->id = build;
+    bd->uu = UU;
+    memcpy(bd->invent, Invent, sizeof(bd->invent));
+}// make_player
+
+
+// Empty the arena after a fight.  Usually only the squares around
+// the fighters can have anything (loot, lemmings) on them but a
+// monster that ran off or stole something could be anywhere.
+static void
+reset_arena(bool everything) {
+    // This goes behind set_obj_at()'s back.
+    GameCtx->objIndex[getlevel()].valid = false;
+
+    if (everything) {
+        memset(lev(), 0, sizeof(struct Level));
+        lev()->exists = true;
+        return;
+    }// if
+
+    // (This is done after every fight so it needs to be quick.)
+    for (int x = PLAYER_X - 3; x <= MONST_X + 3; x++) {
+        memset(&lev()->map[x][PLAYER_Y - 3], 0, 7 * sizeof(struct MapSquare));
+    }// for
+}// reset_arena
+
+
+// Fight 'mon_id' with the player in 'bd' and add the results to
+// 'res'.  Tallies are updated in memory as the fight goes so they're
+// still right if the player dies (i.e. longjmps) in the middle.
+static void
+fight(int mon_id, const struct Build *bd, struct CellResult *res) {
+    UU = bd->uu;
+    inv_set_all(bd->invent);
+    at(MONST_X, MONST_Y)->mon = mk_mon(mon_id);
+    at(MONST_X, MONST_Y)->mon.awake = true;
+
+    static __thread long hpBefore;
+    static __thread int rounds;
+    enum OUTCOME outcome = OC_DRAW;
+
+    rounds = 0;
+    if (setjmp(PlayerDied) != 0) {
+        res->taken += hpBefore - UU.hp;
+        outcome = OC_LOSS;
+    } else {
+        while (rounds < MaxRounds) {
+            ++rounds;
+
+            int monHp = at(MONST_X, MONST_Y)->mon.hitp;
+            hit_mon_melee(MONST_X, MONST_Y);
+            struct Monster mon = at(MONST_X, MONST_Y)->mon;
+            res->swings++;
+            res->dealt += monHp - (ismon(mon) ? mon.hitp : 0);
+
+            if (!ismon(mon)) {
+                outcome = OC_WIN;
+                break;
+            }// if
+
+            hpBefore = UU.hp;
+            res->attacks++;
+            hitplayer(MONST_X, MONST_Y);
+            res->taken += hpBefore - UU.hp;
+
+            if (!ismon(at(MONST_X, MONST_Y)->mon)) {
+                outcome = OC_FLED;
+                break;
+            }// if
+        }// while
+    }// if .. else
+
+    res->outcomes[outcome]++;
+    res->rounds += rounds;
+
+    reset_arena(outcome == OC_FLED || lev()->numStolen > 0);
+}// fight
+
+
+// Claim the next few cells; returns false when they're all gone.
+static bool
+next_cells(long *first, long *end) {
+    pthread_mutex_lock(&NextCellLock);
+    *first = NextCell;
+    NextCell = min_l(NextCell + CELL_CHUNK, NumCells);
+    *end = NextCell;
+    pthread_mutex_unlock(&NextCellLock);
+
+    return *first < *end;
+}// next_cells
+
+static void *
+worker_main(void *arg) {
+    struct GameContext *ctx = gc_new();
+    gc_bind(ctx);
+    ctx->endGame = player_died;
+
+    ctx->world.levelNum = ARENA_LEVEL;
+    lev()->exists = true;
+
+    struct Build *bd = xmalloc(sizeof(struct Build));
+    bd->id = -1;
+
+    long first, end;
+    while (next_cells(&first, &end)) {
+        for (long cell = first; cell < end; cell++) {
+            if (bd->id != cell_build(cell)) {
+                make_player(cell_build(cell), bd);
+            }// if
+
+            seed_rng(BaseSeed + cell);
+            for (long n = 0; n < FightsPerCell; n++) {
+                fight(cell_monster(cell), bd, &Results[cell]);
+            }// for
+        }// for
+    }// while
+
+    free(bd);
+    gc_bind(NULL);
+    gc_free(ctx);
+
+    return NULL;
+}// worker_main
+
+
+//
+// Reporting
+//
+
+static const char *
+gear_name(enum OBJECT_ID id) {
+    return id == ONONE ? "none" : Types[id].shortdesc;
+}// gear_name
+
+static double
+ratio(long num, long denom) {
+    return denom ? (double)num / denom : 0;
+}// ratio
+
+static void
+write_csv(FILE *fh) {
+    fprintf(fh, "monster_id,monster,level,weapon,armor,challenge,fights,"
+            "win_rate,loss_rate,fled_rate,draw_rate,mean_rounds,"
+            "dmg_per_swing,dmg_per_attack,dmg_dealt_per_fight,"
+            "dmg_taken_per_fight\n");
+
+    for (long cell = 0; cell < NumCells; cell++) {
+        const struct CellResult *res = &Results[cell];
+        int build = cell_build(cell);
+        int mon = cell_monster(cell);
+        const struct Loadout *lo = &Loadouts[build_loadout(build)];
+
+        fprintf(fh, "%d,%s,%d,%s,%s,%d,%ld,%.4f,%.4f,%.4f,%.4f,%.2f,"
+                "%.3f,%.3f,%.2f,%.2f\n",
+                mon, MonType[mon].name, build_level(build),
+                gear_name(lo->weapon), gear_name(lo->armor),
+                build_challenge(build), FightsPerCell,
+                ratio(res->outcomes[OC_WIN], FightsPerCell),
+                ratio(res->outcomes[OC_LOSS], FightsPerCell),
+                ratio(res->outcomes[OC_FLED], FightsPerCell),
+                ratio(res->outcomes[OC_DRAW], FightsPerCell),
+                ratio(res->rounds, FightsPerCell),
+                ratio(res->dealt, res->swings),
+                ratio(res->taken, res->attacks),
+                ratio(res->dealt, FightsPerCell),
+                ratio(res->taken, FightsPerCell));
+    }// for
+}// write_csv
+
+
+//
+// Setup
+//
+
+// Parse a comma-separated list of numbers and ranges (e.g. "1,5-8")
+// into a new array.  Returns false if it's malformed or has numbers
+// outside [lo, hi].
+static bool
+parse_list(const char *text, int lo, int hi, int **list, int *count) {
+    *count = 0;
+    *list = NULL;
+
+    for (const char *c = text; *c; ) {
+        char *after;
+        long first = strtol(c, &after, 10);
+        long last = first;
+        if (after == c) { return false; }
+
+        if (*after == '-') {
+            c = after + 1;
+            last = strtol(c, &after, 10);
+            if (after == c) { return false; }
+        }// if
+
+        if (first < lo || last > hi || first > last) { return false; }
+        if (*after && *after != ',') { return false; }
+        c = *after ? after + 1 : after;
+
+        *list = xrealloc(*list, (*count + last - first + 1) * sizeof(int));
+        for (long n = first; n <= last; n++) {
+            (*list)[(*count)++] = n;
+        }// for
+    }// for
+
+    return *count > 0;
+}// parse_list
+
+static void
+usage(const char *prog) {
+    fprintf(stderr,
+            "usage: %s [-n fights] [-j threads] [-s seed] [-r max_rounds] "
+            "[-c class]\n"
+            "          [-m monsters] [-l levels] [-d challenges]\n\n"
+            "  -n fights      fights per table entry (default 1000)\n"
+            "  -j threads     worker threads (default: one per CPU)\n"
+            "  -s seed        base RNG seed (default 1)\n"
+            "  -r max_rounds  call a fight a draw after this many rounds "
+            "(default 200)\n"
+            "  -c class       character class (default Ogre)\n"
+            "  -m monsters    monster IDs to fight (default all: 1-%d)\n"
+            "  -l levels      player levels (default 1,3,5,10,15,20,30)\n"
+            "  -d challenges  difficulty levels (default 0,2,4,6)\n\n"
+            "Lists are comma-separated numbers or ranges, e.g. 1,5-8.  "
+            "The table goes\nto stdout as CSV; a summary goes to stderr.\n",
+            prog, LAST_MONSTER);
+    exit(1);
+}// usage
+
+static void
+parse_args(int argc, char *argv[]) {
+    const char *monsters = NULL;
+    const char *levels = "1,3,5,10,15,20,30";
+    const char *challenges = "0,2,4,6";
+
+    for (int opt; (opt = getopt(argc, argv, "n:j:s:r:c:m:l:d:")) != -1; ) {
+        switch (opt) {
+        case 'n': FightsPerCell = atol(optarg);             break;
+        case 'j': NumWorkers = atoi(optarg);                break;
+        case 's': BaseSeed = strtoul(optarg, NULL, 10);     break;
+        case 'r': MaxRounds = atoi(optarg);                 break;
+        case 'm': monsters = optarg;                        break;
+        case 'l': levels = optarg;                          break;
+        case 'd': challenges = optarg;                      break;
+
+        case 'c':
+            CClass = ccvalue(optarg);
+            if (CClass == CCNONE) { usage(argv[0]); }
+            break;
+
+        default:
+            usage(argv[0]);
+        }// switch
+    }// for
+
+    if (NumWorkers <= 0) { NumWorkers = sysconf(_SC_NPROCESSORS_ONLN); }
+    if (NumWorkers <= 0) { NumWorkers = 1; }
+
+    if (monsters) {
+        if (!parse_list(monsters, 1, LAST_MONSTER, &Monsters, &NumMonsters)) {
+            usage(argv[0]);
+        }// if
+    } else {
+        NumMonsters = LAST_MONSTER;
+        Monsters = xcalloc(NumMonsters, sizeof(int));
+        for (int n = 0; n < NumMonsters; n++) {
+            Monsters[n] = n + 1;
+        }// for
+    }// if .. else
+
+    if (!parse_list(levels, 1, MAXPLEVEL, &Levels, &NumLevels) ||
+        !parse_list(challenges, 0, 100, &Challenges, &NumChallenges) ||
+        optind < argc || FightsPerCell < 1 || MaxRounds < 1)
+    {
+        usage(argv[0]);
+    }// if
+}// parse_args
+
+
+int
+main(int argc, char *argv[]) {
+    parse_args(argc, argv);
+
+    init_os(argv[0]);
+    initopts();
+
+    NumCells = (long)NumMonsters * NumLevels * NUM_LOADOUTS * NumChallenges;
+    Results = xcalloc(NumCells, sizeof(struct CellResult));
+
+    pthread_t *threads = xcalloc(NumWorkers, sizeof(pthread_t));
+    uint64_t start = monotonic_usec();
+
+    for (int n = 0; n < NumWorkers; n++) {
+        ENSURE_MSG(pthread_create(&threads[n], NULL, worker_main, NULL) == 0,
+                   "Unable to start worker thread.");
+    }// for
+    for (int n = 0; n < NumWorkers; n++) {
+        pthread_join(threads[n], NULL);
+    }// for
+
+    double secs = (monotonic_usec() - start) / 1e6;
+
+    write_csv(stdout);
+
+    long fights = NumCells * FightsPerCell, rounds = 0;
+    for (long cell = 0; cell < NumCells; cell++) {
+        rounds += Results[cell].rounds;
+    }// for
+    fprintf(stderr, "class %s  seed %lu  threads %d  cells %ld  fights %ld  "
+            "rounds %ld\ntime %.2f s  fights/s %.0f  fights/s/thread %.0f  "
+            "rounds/s %.0f\n",
+            ccname(CClass), BaseSeed, NumWorkers, NumCells, fights, rounds,
+            secs, fights / secs, fights / secs / NumWorkers, rounds / secs);
+
+    return 0;
+}// main
@@ -0,0 +1,202 @@
+// This file is part of ReLarn; Copyright (C) 1986 - 2023; GPLv2; NO WARRANTY!
+// See Copyright.txt, LICENSE.txt and AUTHORS.txt for terms.
+
+#include "policy.h"
+
+#include "player.h"
+#include "util.h"
+
+#include <stdio.h>
+
+#define ESC '\033'
+
+// Movement keys, indexed by DIRECTION
+static const char DirKeys[] = {
+    [DIR_NORTH] = 'k', [DIR_EAST] = 'l', [DIR_SOUTH] = 'j', [DIR_WEST] = 'h',
+    [DIR_NORTHEAST] = 'u', [DIR_NORTHWEST] = 'y',
+    [DIR_SOUTHEAST] = 'n', [DIR_SOUTHWEST] = 'b',
+};
+
+
+void
+policy_init(struct PolicyState *ps, const char *script) {
+    ps->script = script;
+    ps->pos = 0;
+    ps->lastX = ps->lastY = ps->lastLevel = -1;
+    ps->distLevel = -1;
+}// policy_init
+
+
+static char
+random_dir_key() {
+    return DirKeys[randdir()];
+}// random_dir_key
+
+
+//
+// Random walker: wanders about, answering questions at random.
+//
+
+static char
+random_walker(enum HEADLESS_INPUT what, struct PolicyState *ps) {
+    switch (what) {
+    case HI_COMMAND:
+    case HI_DIRECTION:  return random_dir_key();
+    case HI_PROMPT:     return "gny\033"[rund(4)];
+    case HI_CONFIRM:    return rund(2) ? 'y' : 'n';
+    case HI_ITEM:       return ESC;
+    }// switch
+
+    return ESC;
+}// random_walker
+
+
+//
+// Stair diver: heads straight for the dungeon entrance and then for
+// the stairs down on each level, fighting whatever is in the way.
+//
+
+// Fill ps->dist with the number of steps from each square to tx,ty,
+// going around walls.
+static void
+compute_dist(struct PolicyState *ps, int tx, int ty) {
+    int8_t qx[MAXX * MAXY], qy[MAXX * MAXY];
+    int head = 0, tail = 0;
+
+    for (int x = 0; x < MAXX; x++) {
+        for (int y = 0; y < MAXY; y++) {
+            ps->dist[x][y] = -1;
+        }// for
+    }// for
+
+    ps->dist[tx][ty] = 0;
+    qx[tail] = tx;
+    qy[tail++] = ty;
+
+    while (head < tail) {
+        int8_t x = qx[head], y = qy[head++];
+
+        for (DIRECTION dir = DIR_MIN_DIR; dir <= DIR_MAX; dir++) {
+            int8_t nx, ny;
+            adjpoint(x, y, dir, &nx, &ny);
+            if (!inbounds(nx, ny) || ps->dist[nx][ny] >= 0 ||
+                at(nx, ny)->obj.type == OWALL)
+            {
+                continue;
+            }// if
+
+            ps->dist[nx][ny] = ps->dist[x][y] + 1;
+            qx[tail] = nx;
+            qy[tail++] = ny;
+        }// for
+    }// while
+}// compute_dist
+
+
+// Return the object the diver is trying to reach on this level.
+static enum OBJECT_ID
+diver_target() {
+    int lvl = getlevel();
+    if (lvl == 0)       { return OENTRANCE; }
+    if (lvl < DBOTTOM)  { return OSTAIRSDOWN; }
+    return ONONE;
+}// diver_target
+
+
+static char
+diver_move(struct PolicyState *ps) {
+    int lvl = getlevel();
+
+    // If we didn't get anywhere last time (a wall, a monster that
+    // won't die), try something else half the time.
+    bool stuck = UU.x == ps->lastX && UU.y == ps->lastY &&
+        lvl == ps->lastLevel;
+    ps->lastX = UU.x;
+    ps->lastY = UU.y;
+    ps->lastLevel = lvl;
+    if (stuck && rund(2)) { return random_dir_key(); }
+
+    if (ps->distLevel != lvl) {
+        int8_t tx, ty;
+        enum OBJECT_ID target = diver_target();
+        if (target == ONONE || !findobj(target, &tx, &ty)) {
+            return random_dir_key();
+        }// if
+
+        compute_dist(ps, tx, ty);
+        ps->distLevel = lvl;
+    }// if
+
+    // Step to the neighbour closest to the target.
+    int best = -1;
+    char key = 0;
+    for (DIRECTION dir = DIR_MIN_DIR; dir <= DIR_MAX; dir++) {
+        int8_t nx, ny;
+        adjpoint(UU.x, UU.y, dir, &nx, &ny);
+        if (!inbounds(nx, ny)) { continue; }
+
+        int d = ps->dist[nx][ny];
+        if (d >= 0 && (best < 0 || d < best)) {
+            best = d;
+            key = DirKeys[dir];
+        }// if
+    }// for
+
+    return key ? key : random_dir_key();
+}// diver_move
+
+
+static char
+stair_diver(enum HEADLESS_INPUT what, struct PolicyState *ps) {
+    switch (what) {
+    case HI_COMMAND:
+        return diver_move(ps);
+
+    case HI_PROMPT: {
+        enum OBJECT_ID here = at(UU.x, UU.y)->obj.type;
+        return (here == OENTRANCE || here == OSTAIRSDOWN) ? 'g' : ESC;
+    }
+
+    case HI_DIRECTION:  return random_dir_key();
+    case HI_CONFIRM:    return 'n';
+    case HI_ITEM:       return ESC;
+    }// switch
+
+    return ESC;
+}// stair_diver
+
+
+//
+// Scripted: plays the given keys in order, over and over.
+//
+
+static char
+scripted(enum HEADLESS_INPUT what, struct PolicyState *ps) {
+    char key = ps->script[ps->pos++];
+    if (!ps->script[ps->pos]) { ps->pos = 0; }
+    return key;
+}// scripted
+
+
+static const struct Policy Policies[] = {
+    {"random",  "walk and answer questions at random",  random_walker},
+    {"diver",   "head for the stairs down",             stair_diver},
+    {"script",  "repeat the keys given with -k",        scripted},
+    {NULL, NULL, NULL}
+};
+
+// Return the policy named 'name' or NULL if there isn't one.
+const struct Policy *
+find_policy(const char *name) {
+    for (int n = 0; Policies[n].name; n++) {
+        if (streq(name, Policies[n].name)) { return &Policies[n]; }
+    }// for
+    return NULL;
+}// find_policy
+
+void
+list_policies(FILE *fh) {
+    for (int n = 0; Policies[n].name; n++) {
+        fprintf(fh, "    %-8s %s\n", Policies[n].name, Policies[n].desc);
+    }// for
+}// list_policies
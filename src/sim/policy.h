@@ -0,0 +1,44 @@
+// This file is part of ReLarn; Copyright (C) 1986 - 2023; GPLv2; NO WARRANTY!
+// See Copyright.txt, LICENSE.txt and AUTHORS.txt for terms.
+
+// Bot policies for relarn-sim.
+//
+// A policy plays the game by supplying every key the (headless) UI
+// asks for.  Policies may look at the game state directly; they run
+// in the game's thread with its context bound.  Random choices use
+// the game's RNG so a game is reproducible from its seed.
+
+#ifndef HDR_GUARD_POLICY_H
+#define HDR_GUARD_POLICY_H
+
+#include "bench/ui_headless.h"
+#include "map.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+// Per-game policy state.
+struct PolicyState {
+    const char *script;         // Keys for the scripted policy
+    size_t pos;                 // Next key in script
+
+    // Where the last command was asked for, to detect being stuck
+    int lastX, lastY, lastLevel;
+
+    // Distances to the current target, by square (-1: unreachable)
+    int distLevel;              // Level dist[] is for; -1 if none
+    int16_t dist[MAXX][MAXY];
+};
+
+struct Policy {
+    const char *name;
+    const char *desc;
+    char (*input)(enum HEADLESS_INPUT what, struct PolicyState *ps);
+};
+
+const struct Policy *find_policy(const char *name);
+void list_policies(FILE *fh);
+void policy_init(struct PolicyState *ps, const char *script);
+
+#endif
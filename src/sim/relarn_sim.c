@@ -0,0 +1,484 @@
+// This file is part of ReLarn; Copyright (C) 1986 - 2023; GPLv2; NO WARRANTY!
+// See Copyright.txt, LICENSE.txt and AUTHORS.txt for terms.
+
+// relarn-sim: play lots of games with a bot and report what happened.
+//
+// Runs N games on a pool of threads, each game driven by a policy
+// (see policy.h) through the headless UI, and prints aggregate
+// statistics: turns survived, game time, deepest level reached, score
+// and cause of death.  It's meant for evaluating balance changes over
+// very large numbers of games.
+//
+// Each game has its own game context and RNG seed (the base seed plus
+// the game number), so results don't depend on the number of threads
+// or on scheduling and any single game can be replayed with -s/-n.
+// Games are dealt out to the workers in contiguous ranges; a worker
+// that runs out steals half of the remaining range of another, so the
+// load stays balanced even though game lengths vary wildly.  Workers
+// share nothing but the queues and merge their statistics at the end.
+//
+// Games end when the player dies (life protection still works), wins,
+// quits, survives the turn limit ("timeout") or the policy wastes too
+// many keys in a single turn ("stuck").  Nothing is written to disk;
+// the game-over screen, scoreboard and save files are skipped.  (Since
+// ending a game jumps straight out of the engine, anything the engine
+// had allocated at the time, e.g. a store's pick list, is leaked.
+// That's rare enough not to matter.)
+//
+// Run from src/ (or with RELARN_INSTALL_ROOT set) so that the game's
+// data files can be found.
+
+#include "allocstats.h"
+#include "arena.h"
+#include "game.h"
+#include "game_context.h"
+#include "map.h"
+#include "player.h"
+#include "pregen.h"
+#include "settings.h"
+#include "stringbuilder.h"
+#include "os.h"
+#include "util.h"
+
+#include "policy.h"
+
+#include <math.h>
+#include <pthread.h>
+#include <setjmp.h>
+#include <stdio.h>
+#include <unistd.h>
+
+// Endings that aren't game endings, stored after them in causes[]
+enum SIM_ENDING {
+    SE_QUIT = DD_COUNT,
+    SE_TIMEOUT,
+    SE_STUCK,
+
+    SE_COUNT
+};
+
+// Most keys a policy can use on one turn before we call it stuck
+#define MAX_KEYS_PER_TURN 1000
+
+// Running count, sum, min and max of a value
+struct Tally {
+    long n;
+    double sum, sumsq;
+    long min, max;
+};
+
+struct Results {
+    long games;
+    long turns_total;
+    long allocs_total;          // Heap allocations made during turns
+    struct Tally turns, gtime, depth, score;
+    long depthCount[NLEVELS];
+    long causes[SE_COUNT];
+};
+
+struct Worker {
+    pthread_t thread;
+    int id;
+
+    pthread_mutex_t lock;       // Protects next and end
+    long next, end;             // Games still to play: [next, end)
+
+    struct Results results;     // Only touched by this worker
+};
+
+
+// Settings.  These are set up before the workers start and are
+// read-only afterward.
+static long NumGames = 1000;
+static int NumWorkers = 0;
+static const struct Policy *Policy = NULL;
+static char *Script = "";
+static unsigned long BaseSeed = 1;
+static long MaxTurns = 100000;
+static enum CHAR_CLASS CClass = CCOGRE;
+static int Difficulty = 0;
+static bool PrintGames = false;
+
+static struct Worker **Workers = NULL;
+
+
+static void
+tally_add(struct Tally *st, long value) {
+    if (st->n == 0 || value < st->min) { st->min = value; }
+    if (st->n == 0 || value > st->max) { st->max = value; }
+    st->n++;
+    st->sum += value;
+    st->sumsq += (double)value * value;
+}// tally_add
+
+static void
+tally_merge(struct Tally *into, const struct Tally *from) {
+    if (from->n == 0) { return; }
+    if (into->n == 0 || from->min < into->min) { into->min = from->min; }
+    if (into->n == 0 || from->max > into->max) { into->max = from->max; }
+    into->n += from->n;
+    into->sum += from->sum;
+    into->sumsq += from->sumsq;
+}// tally_merge
+
+
+//
+// Playing one game
+//
+
+// How the game in this thread ended.  endGame() longjmps back to
+// play_game() since the game can end anywhere in the engine.
+static __thread jmp_buf GameOver;
+static __thread int EndCause;
+static __thread long KeysLeft;
+
+static void
+end_game(int cause) {
+    EndCause = cause < 0 ? SE_QUIT : cause;
+    longjmp(GameOver, 1);
+}// end_game
+
+// Get the next key from the policy.  'arg' is its PolicyState.
+static char
+sim_input(enum HEADLESS_INPUT what, void *arg) {
+    if (--KeysLeft < 0) {
+        EndCause = SE_STUCK;
+        longjmp(GameOver, 1);
+    }// if
+    return Policy->input(what, arg);
+}// sim_input
+
+
+static const char *
+level_label(int lvl) {
+    static const char *labels[] = {
+        "H", "1", "2", "3", "4", "5", "6", "7", "8", "9", "10", "11", "12",
+        "13", "14", "15", "V1", "V2", "V3", "V4", "V5"
+    };
+    ASSERT(lvl >= 0 && lvl < NLEVELS && NLEVELS == sizeof(labels)/sizeof(labels[0]));
+    return labels[lvl];
+}// level_label
+
+
+static void
+play_game(long game, struct Results *res) {
+    struct GameContext *ctx = gc_new();
+    gc_bind(ctx);
+    ctx->endGame = end_game;
+    ctx->noScoreboard = true;       // Taxes depend on the host's scores
+
+    struct PolicyState *ps = xmalloc(sizeof(struct PolicyState));
+    policy_init(ps, Script);
+    headless_set_input(sim_input, ps);
+
+    seed_rng(BaseSeed + game);
+    arena_reset();      // In case the last game ended mid-command
+    init_new_player(CClass, FEMALE, MALE, Difficulty);
+
+    volatile long turns = 0;
+    volatile int deepest = 0;
+    volatile unsigned long allocStart = 0;
+
+    if (setjmp(GameOver) == 0) {
+        setlevel(0, true);
+        recalc();
+
+        allocStart = xalloc_count();
+        while (turns < MaxTurns) {
+            KeysLeft = MAX_KEYS_PER_TURN;
+            onemove(DIR_CANCEL);
+
+            ++turns;
+            if (getlevel() > deepest) { deepest = getlevel(); }
+        }// while
+
+        EndCause = SE_TIMEOUT;
+    }// if
+
+    if (getlevel() > deepest) { deepest = getlevel(); }
+
+    long score = compute_score(EndCause == DDWINNER);
+
+    res->games++;
+    res->turns_total += turns;
+    res->allocs_total += allocStart ? xalloc_count() - allocStart : 0;
+    tally_add(&res->turns, turns);
+    tally_add(&res->gtime, UU.gtime);
+    tally_add(&res->depth, deepest);
+    tally_add(&res->score, score);
+    res->depthCount[deepest]++;
+    res->causes[EndCause]++;
+
+    if (PrintGames) {
+        printf("game %ld seed=%lu turns=%ld gtime=%ld depth=%s score=%ld "
+               "end=%d\n", game, BaseSeed + game, (long)turns, (long)UU.gtime,
+               level_label(deepest), score, EndCause);
+    }// if
+
+    headless_set_input(NULL, NULL);
+    gc_bind(NULL);
+    gc_free(ctx);
+    free(ps);
+}// play_game
+
+
+//
+// The work-stealing pool
+//
+
+// Take the next game from w's queue or, if that's empty, steal the
+// back half of someone else's.  Returns false when there's nothing
+// left anywhere.  (Only one lock is held at a time.)
+static bool
+next_game(struct Worker *w, long *game) {
+    pthread_mutex_lock(&w->lock);
+    bool found = w->next < w->end;
+    if (found) { *game = w->next++; }
+    pthread_mutex_unlock(&w->lock);
+    if (found) { return true; }
+
+    for (int n = 1; n < NumWorkers; n++) {
+        struct Worker *victim = Workers[(w->id + n) % NumWorkers];
+
+        pthread_mutex_lock(&victim->lock);
+        long left = victim->end - victim->next;
+        long start = victim->end - (left + 1) / 2;
+        long end = victim->end;
+        if (left > 0) { victim->end = start; }
+        pthread_mutex_unlock(&victim->lock);
+
+        if (left > 0) {
+            pthread_mutex_lock(&w->lock);
+            w->next = start + 1;
+            w->end = end;
+            pthread_mutex_unlock(&w->lock);
+
+            *game = start;
+            return true;
+        }// if
+    }// for
+
+    return false;
+}// next_game
+
+static void *
+worker_main(void *arg) {
+    struct Worker *w = arg;
+    long game;
+
+    while (next_game(w, &game)) {
+        play_game(game, &w->results);
+    }// while
+
+    arena_free();
+    return NULL;
+}// worker_main
+
+
+//
+// Reporting
+//
+
+static void
+print_tally(const char *name, const struct Tally *st) {
+    double mean = st->n ? st->sum / st->n : 0;
+    double var = st->n ? st->sumsq / st->n - mean * mean : 0;
+    printf("%-10s mean %12.1f  sd %12.1f  min %10ld  max %10ld\n", name,
+           mean, var > 0 ? sqrt(var) : 0, st->min, st->max);
+}// print_tally
+
+static const char *
+ending_desc(int cause) {
+    switch (cause) {
+    case SE_QUIT:       return "quit.";
+    case SE_TIMEOUT:    return "were still alive at the turn limit.";
+    case SE_STUCK:      return "got stuck (too many keys in one turn).";
+    default:            return cause_desc(cause);
+    }// switch
+}// ending_desc
+
+static void
+report(const struct Results *res, double secs) {
+    printf("policy %s  class %s  difficulty %d  seeds %lu-%lu  threads %d\n",
+           Policy->name, ccname(CClass), Difficulty, BaseSeed,
+           BaseSeed + NumGames - 1, NumWorkers);
+    printf("games %ld  turns %ld  time %.2f s  games/s %.1f  "
+           "turns/s %.0f  turns/s/thread %.0f\n",
+           res->games, res->turns_total, secs, res->games / secs,
+           res->turns_total / secs, res->turns_total / secs / NumWorkers);
+    printf("heap allocations %ld  per turn %.3f\n\n", res->allocs_total,
+           res->turns_total ? (double)res->allocs_total / res->turns_total : 0);
+
+    print_tally("turns", &res->turns);
+    print_tally("gametime", &res->gtime);
+    print_tally("depth", &res->depth);
+    print_tally("score", &res->score);
+
+    printf("\nDeepest level reached:\n");
+    for (int lvl = 0; lvl < NLEVELS; lvl++) {
+        if (!res->depthCount[lvl]) { continue; }
+        printf("  %-3s %10ld %6.2f%%\n", level_label(lvl),
+               res->depthCount[lvl], 100.0 * res->depthCount[lvl] / res->games);
+    }// for
+
+    printf("\nHow the games ended (you...):\n");
+    for (int cause = 0; cause < SE_COUNT; cause++) {
+        if (!res->causes[cause]) { continue; }
+        printf("  %10ld %6.2f%%  %s\n", res->causes[cause],
+               100.0 * res->causes[cause] / res->games, ending_desc(cause));
+    }// for
+}// report
+
+
+//
+// Setup
+//
+
+// Copy 'keys' into a new string with escapes ("\e", "\n", "\\")
+// replaced by the characters they stand for.
+static char *
+unescape(const char *keys) {
+    char *result = xmalloc(strlen(keys) + 1);
+    char *out = result;
+
+    for (const char *c = keys; *c; c++) {
+        if (*c != '\\' || !c[1]) { *out++ = *c; continue; }
+
+        c++;
+        *out++ = *c == 'e' ? '\033' : *c == 'n' ? '\n' : *c;
+    }// for
+    *out = 0;
+
+    return result;
+}// unescape
+
+static void
+usage(const char *prog) {
+    fprintf(stderr,
+            "usage: %s [-n games] [-j threads] [-p policy] [-k keys] "
+            "[-s seed]\n"
+            "          [-t max_turns] [-c class] [-d difficulty] [-g] [-f]\n\n"
+            "  -n games       number of games to play (default 1000)\n"
+            "  -j threads     worker threads (default: one per CPU)\n"
+            "  -p policy      how to play (default diver):\n",
+            prog);
+    list_policies(stderr);
+    fprintf(stderr,
+            "  -k keys        keys for the 'script' policy (\\e is ESC)\n"
+            "  -s seed        seed of the first game (default 1)\n"
+            "  -t max_turns   end games after this many turns "
+            "(default 100000)\n"
+            "  -c class       character class (default Ogre)\n"
+            "  -d difficulty  difficulty level (default 0)\n"
+            "  -g             also print a line for each game\n"
+            "  -f             build each level when it's needed rather than\n"
+            "                 ahead of time (the games come out the same)\n");
+    exit(1);
+}// usage
+
+static void
+parse_args(int argc, char *argv[]) {
+    Policy = find_policy("diver");
+
+    for (int opt; (opt = getopt(argc, argv, "n:j:p:k:s:t:c:d:gf")) != -1; ) {
+        switch (opt) {
+        case 'n': NumGames = atol(optarg);                  break;
+        case 'j': NumWorkers = atoi(optarg);                break;
+        case 'k': Script = unescape(optarg);                break;
+        case 's': BaseSeed = strtoul(optarg, NULL, 10);     break;
+        case 't': MaxTurns = atol(optarg);                  break;
+        case 'd': Difficulty = atoi(optarg);                break;
+        case 'g': PrintGames = true;                        break;
+        case 'f': pregen_set_background(false);             break;
+
+        case 'p':
+            Policy = find_policy(optarg);
+            if (!Policy) { usage(argv[0]); }
+            break;
+
+        case 'c':
+            CClass = ccvalue(optarg);
+            if (CClass == CCNONE) { usage(argv[0]); }
+            break;
+
+        default:
+            usage(argv[0]);
+        }// switch
+    }// for
+
+    if (NumWorkers <= 0) { NumWorkers = sysconf(_SC_NPROCESSORS_ONLN); }
+    if (NumWorkers <= 0) { NumWorkers = 1; }
+
+    if (optind < argc || NumGames < 1 || MaxTurns < 1 || Difficulty < 0 ||
+        (Policy == find_policy("script") && !Script[0]))
+    {
+        usage(argv[0]);
+    }// if
+}// parse_args
+
+
+int
+main(int argc, char *argv[]) {
+    parse_args(argc, argv);
+
+    init_os(argv[0]);
+    initopts();
+
+    // These paths (and the user ID) are worked out on first use and
+    // cached, so do it now before several threads want them at once.
+    levels_path();
+    scoredata_path();
+    scoreindex_path();
+    get_user_id();
+
+    // Deal out the games in equal, contiguous ranges.
+    Workers = xcalloc(NumWorkers, sizeof(struct Worker *));
+    for (int n = 0; n < NumWorkers; n++) {
+        struct Worker *w = xcalloc(1, sizeof(struct Worker));
+        w->id = n;
+        w->next = NumGames * n / NumWorkers;
+        w->end = NumGames * (n + 1) / NumWorkers;
+        pthread_mutex_init(&w->lock, NULL);
+        Workers[n] = w;
+    }// for
+
+    uint64_t start = monotonic_usec();
+
+    for (int n = 0; n < NumWorkers; n++) {
+        ENSURE_MSG(pthread_create(&Workers[n]->thread, NULL, worker_main,
+                                  Workers[n]) == 0,
+                   "Unable to start worker thread.");
+    }// for
+
+    struct Results total = {0};
+    for (int n = 0; n < NumWorkers; n++) {
+        const struct Results *res = &Workers[n]->results;
+
+        pthread_join(Workers[n]->thread, NULL);
+
+        total.games += res->games;
+        total.turns_total += res->turns_total;
+        total.allocs_total += res->allocs_total;
+        tally_merge(&total.turns, &res->turns);
+        tally_merge(&total.gtime, &res->gtime);
+        tally_merge(&total.depth, &res->depth);
+        tally_merge(&total.score, &res->score);
+        for (int i = 0; i < NLEVELS; i++) {
+            total.depthCount[i] += res->depthCount[i];
+        }// for
+        for (int i = 0; i < SE_COUNT; i++) {
+            total.causes[i] += res->causes[i];
+        }// for
+    }// for
+
+    report(&total, (monotonic_usec() - start) / 1e6);
+
+#ifdef ALLOC_STATS
+    struct StringBuilder *sb = sb_alloc();
+    alloc_report(sb);
+    printf("\n%s", sb_str(sb));
+    sb_free(sb);
+#endif
+
+    return 0;
+}// main
@@ -5,416 +5,353 @@
 // Consider this part of cast.c; it's here for readability.
 //
 // This is the big list of spell immunities used by the function
-// nospell and turns into a giant array-of-struct initializer.
+// nospell().  It's a pair of X-macros that cast.c expands into
+// constant tables at compile time:
+//
+//  SPELL_IMMUNITY_MESSAGES(MSG) calls MSG(id, text) for each message
+//  a monster can give when a spell has no effect on it.  The text
+//  gets the monster's name.
+//
+//  SPELL_IMMUNITIES(IMM, arg) calls IMM(arg, monster, spell, msg_id)
+//  for each monster that is immune to a spell.  'arg' is passed
+//  through untouched for the caller's use.
+//
+// Each monster/spell pair may only appear once; cast.c will fail to
+// compile otherwise.
+
+#define SPELL_IMMUNITY_MESSAGES(MSG)                                          \
+    MSG(IM_WEB_NO_EFFECT,    "the web had no effect on the %s")               \
+    MSG(IM_WEB_SHAPESHIFT,   "the %s changed shape to avoid the web")         \
+    MSG(IM_NOT_AFRAID,       "the %s isn't afraid of you")                    \
+    MSG(IM_NOT_AFFECTED,     "the %s isn't affected")                         \
+    MSG(IM_INFRAVISION,      "the %s can see you with his infravision")       \
+    MSG(IM_VAPORIZES,        "the %s vaporizes your missile")                 \
+    MSG(IM_BOUNCES,          "your missile bounces off the %s")               \
+    MSG(IM_NO_SLEEP,         "the %s doesn't sleep")                          \
+    MSG(IM_RESISTS,          "the %s resists")                                \
+    MSG(IM_DEAF,             "the %s can't hear the noise")                   \
+    MSG(IM_WEB_TAIL,         "the %s's tail cuts it free of the web")         \
+    MSG(IM_WEB_BURNS,        "the %s burns through the web")                  \
+    MSG(IM_PASS_THROUGH,     "your missiles pass right through the %s")       \
+    MSG(IM_SEES_ILLUSIONS,   "the %s sees through your illusions")            \
+    MSG(IM_FOND_MEMORY,      "the %s appears to be recalling a fond memory.") \
+    MSG(IM_LOVES_COLD,       "the %s loves the cold!")                        \
+    MSG(IM_LOVES_WATER,      "the %s loves the water!")                       \
+    MSG(IM_TERRIFIED,        "the demon is terrified of the %s!")             \
+    MSG(IM_LOVES_FIRE,       "the %s loves fire and lightning!")
 
 
-{
-  "the web had no effect on the %s",
-  {
-    {VORTEX, CWEB},
-    {INVISIBLESTALKER, CWEB},
-    {POLTERGEIST, CWEB},
-    {YELLOWMOLD, CWEB},
-    {WATERLORD, CWEB},
-    {SPIRITNAGA, CWEB},
-    {DEMONLORD1, CWEB},
-    {DEMONLORD2, CWEB},
-    {DEMONLORD3, CWEB},
-    {DEMONLORD4, CWEB},
-    {DEMONLORD5, CWEB},
-    {DEMONLORD6, CWEB},
-    {DEMONLORD7, CWEB},
-    {DEMONPRINCE, CWEB},
-    {DEMONKING, CWEB},
-    {NOMONST, 0},
-  },
-},
-{
-  "the %s changed shape to avoid the web",
-  {
-    {CUBE, CWEB},
-    {METAMORPH, CWEB},
-    {VAMPIRE, CWEB},
-    {MIMIC, CWEB},
-    {NOMONST, 0},
-  },
-},
-{
-  "the %s isn't afraid of you",
-  {
-    {GNOMEKING, CCHARM},
-    {WATERLORD, CCHARM},
-    {SPIRITNAGA, CCHARM},
-    {DEMONLORD1, CCHARM},
-    {DEMONLORD1, CSCAREMON},
-    {DEMONLORD2, CCHARM},
-    {DEMONLORD2, CSCAREMON},
-    {DEMONLORD3, CCHARM},
-    {DEMONLORD3, CSCAREMON},
-    {DEMONLORD4, CCHARM},
-    {DEMONLORD4, CSCAREMON},
-    {DEMONLORD5, CCHARM},
-    {DEMONLORD5, CSCAREMON},
-    {DEMONLORD6, CCHARM},
-    {DEMONLORD6, CSCAREMON},
-    {DEMONLORD7, CCHARM},
-    {DEMONLORD7, CSCAREMON},
-    {DEMONPRINCE, CCHARM},
-    {DEMONPRINCE, CSCAREMON},
-    {DEMONKING, CCHARM},
-    {NOMONST, 0},
-  },
-},
-{
-  "the %s isn't affected",
-  {
-    {EYE, CFINGER},
-    {ZOMBIE, CSSPEAR},
-    {ZOMBIE, CPHANTASM},
-    {ZOMBIE, CCLOUD},
-    {ZOMBIE, CDRY},
-    {ZOMBIE, CDRAIN},
-    {ZOMBIE, CFINGER},
-    {TROLL, CDRY},
-    {WHITEDRAGON, CDRY},
-    {CUBE, CCLOUD},
-    {CUBE, CFINGER},
-    {METAMORPH, CCLOUD},
-    {METAMORPH, CDRY},
-    {METAMORPH, CFINGER},
-    {VORTEX, CCLOUD},
-    {VORTEX, CDRY},
-    {VORTEX, CFLOOD},
-    {VORTEX, CFINGER},
-    {VIOLETFUNGI, CFINGER},
-    {WRAITH, CSSPEAR},
-    {WRAITH, CCLOUD},
-    {WRAITH, CDRY},
-    {WRAITH, CDRAIN},
-    {WRAITH, CFINGER},
-    {XORN, CDRY},
-    {XORN, CFLOOD},
-    {XORN, CFINGER},
-    {VAMPIRE, CSSPEAR},
-    {VAMPIRE, CCLOUD},
-    {VAMPIRE, CDRAIN},
-    {VAMPIRE, CFINGER},
-    {POLTERGEIST, CSSPEAR},
-    {POLTERGEIST, CCOLD},
-    {POLTERGEIST, CCLOUD},
-    {POLTERGEIST, CDRY},
-    {POLTERGEIST, CDRAIN},
-    {POLTERGEIST, CFLOOD},
-    {POLTERGEIST, CFINGER},
-    {YELLOWMOLD, CCLOUD},
-    {YELLOWMOLD, CFINGER},
-    {WATERLORD, CSSPEAR},
-    {WATERLORD, CCLOUD},
-    {WATERLORD, CFINGER},
-    {XVART, CFLOOD},
-    {XVART, CFINGER},
-    {SPIRITNAGA, CSSPEAR},
-    {SPIRITNAGA, CCOLD},
-    {SPIRITNAGA, CCLOUD},
-    {SPIRITNAGA, CDRY},
-    {SPIRITNAGA, CDRAIN},
-    {SPIRITNAGA, CFLOOD},
-    {SPIRITNAGA, CFINGER},
-    {DEMONLORD1, CCLOUD},
-    {DEMONLORD1, CDRY},
-    {DEMONLORD1, CFLOOD},
-    {DEMONLORD1, CFINGER},
-    {DEMONLORD1, CMAGICFIRE},
-    {DEMONLORD2, CCLOUD},
-    {DEMONLORD2, CDRY},
-    {DEMONLORD2, CFLOOD},
-    {DEMONLORD2, CFINGER},
-    {DEMONLORD2, CMAGICFIRE},
-    {DEMONLORD3, CCLOUD},
-    {DEMONLORD3, CDRY},
-    {DEMONLORD3, CFLOOD},
-    {DEMONLORD3, CFINGER},
-    {DEMONLORD3, CMAGICFIRE},
-    {DEMONLORD4, CCLOUD},
-    {DEMONLORD4, CDRY},
-    {DEMONLORD4, CFLOOD},
-    {DEMONLORD4, CFINGER},
-    {DEMONLORD4, CMAGICFIRE},
-    {DEMONLORD5, CCLOUD},
-    {DEMONLORD5, CDRY},
-    {DEMONLORD5, CFLOOD},
-    {DEMONLORD5, CFINGER},
-    {DEMONLORD5, CMAGICFIRE},
-    {DEMONLORD6, CPOLY},
-    {DEMONLORD6, CCLOUD},
-    {DEMONLORD6, CDRY},
-    {DEMONLORD6, CFLOOD},
-    {DEMONLORD6, CFINGER},
-    {DEMONLORD6, CMAGICFIRE},
-    {DEMONLORD7, CPOLY},
-    {DEMONLORD7, CCLOUD},
-    {DEMONLORD7, CDRY},
-    {DEMONLORD7, CFLOOD},
-    {DEMONLORD7, CFINGER},
-    {DEMONLORD7, CMAGICFIRE},
-    {DEMONPRINCE, CPOLY},
-    {DEMONPRINCE, CCLOUD},
-    {DEMONPRINCE, CDRY},
-    {DEMONPRINCE, CDRAIN},
-    {DEMONPRINCE, CFLOOD},
-    {DEMONPRINCE, CFINGER},
-    {DEMONPRINCE, CMAGICFIRE},
-    {DEMONKING, CCLOUD},
-    {DEMONKING, CDRY},
-    {DEMONKING, CDRAIN},
-    {DEMONKING, CFINGER},
-    {DEMONKING, CSCAREMON},
-    {DEMONKING, CHOLDMON},
-    {DEMONKING, CMAGICFIRE},
-    {NOMONST, 0},
-  },
-},
-{
-  "the %s can see you with his infravision",
-  {
-    {GNOME, CINV},
-    {KOBOLD, CINV},
-    {BUGBEAR, CINV},
-    {ELF, CINV},
-    {FORVALAKA, CINV},
-    {ROTHE, CINV},
-    {XORN, CINV},
-    {UMBERHULK, CINV},
-    {GNOMEKING, CINV},
-    {SPIRITNAGA, CINV},
-    {DEMONLORD1, CINV},
-    {DEMONLORD2, CINV},
-    {DEMONLORD3, CINV},
-    {DEMONLORD4, CINV},
-    {DEMONLORD5, CINV},
-    {DEMONLORD6, CINV},
-    {DEMONLORD7, CINV},
-    {DEMONPRINCE, CINV},
-    {DEMONKING, CINV},
-    {NOMONST, 0},
-  },
-},
-{
-  "the %s vaporizes your missile",
-  {
-    {HELLHOUND, CMMISSILE},
-    {SILVERDRAGON, CMMISSILE},
-    {REDDRAGON, CMMISSILE},
-    {NOMONST, 0},
-  },
-},
-{
-  "your missile bounces off the %s",
-  {
-    {TROLL, CMMISSILE},
-    {ROTHE, CMMISSILE},
-    {XORN, CMMISSILE},
-    {UMBERHULK, CMMISSILE},
-    {GNOMEKING, CMMISSILE},
-    {BRONZEDRAGON, CMMISSILE},
-    {GREENDRAGON, CMMISSILE},
-    {PLATINUMDRAGON, CMMISSILE},
-    {NOMONST, 0},
-  },
-},
-{
-  "the %s doesn't sleep",
-  {
-    {EYE, CSLEEP},
-    {ZOMBIE, CSLEEP},
-    {CUBE, CSLEEP},
-    {VIOLETFUNGI, CSLEEP},
-    {WRAITH, CSLEEP},
-    {XORN, CSLEEP},
-    {POLTERGEIST, CSLEEP},
-    {DISENCHANTRESS, CSLEEP},
-    {YELLOWMOLD, CSLEEP},
-    {WATERLORD, CSLEEP},
-    {SPIRITNAGA, CSLEEP},
-    {DEMONLORD1, CSLEEP},
-    {DEMONLORD2, CSLEEP},
-    {DEMONLORD3, CSLEEP},
-    {DEMONLORD4, CSLEEP},
-    {DEMONLORD5, CSLEEP},
-    {DEMONLORD6, CSLEEP},
-    {DEMONLORD7, CSLEEP},
-    {DEMONPRINCE, CSLEEP},
-    {DEMONKING, CSLEEP},
-    {NOMONST, 0},
-  },
-},
-{
-  "the %s resists",
-  {
-    {GNOMEKING, CPOLY},
-    {WATERLORD, CPOLY},
-    {SPIRITNAGA, CPOLY},
-    {SILVERDRAGON, CSLEEP},
-    {SILVERDRAGON, CPOLY},
-    {PLATINUMDRAGON, CSLEEP},
-    {PLATINUMDRAGON, CPOLY},
-    {DEMONLORD1, CPOLY},
-    {DEMONLORD1, CDRAIN},
-    {DEMONLORD1, CTELEPORT},
-    {DEMONLORD1, CMKWALL},
-    {DEMONLORD2, CPOLY},
-    {DEMONLORD2, CDRAIN},
-    {DEMONLORD2, CTELEPORT},
-    {DEMONLORD2, CMKWALL},
-    {DEMONLORD3, CPOLY},
-    {DEMONLORD3, CDRAIN},
-    {DEMONLORD3, CTELEPORT},
-    {DEMONLORD3, CMKWALL},
-    {DEMONLORD4, CPOLY},
-    {DEMONLORD4, CDRAIN},
-    {DEMONLORD4, CTELEPORT},
-    {DEMONLORD4, CMKWALL},
-    {DEMONLORD5, CPOLY},
-    {DEMONLORD5, CDRAIN},
-    {DEMONLORD5, CTELEPORT},
-    {DEMONLORD5, CMKWALL},
-    {DEMONLORD6, CTELEPORT},
-    {DEMONLORD6, CMKWALL},
-    {DEMONLORD7, CTELEPORT},
-    {DEMONLORD7, CMKWALL},
-    {DEMONPRINCE, CTELEPORT},
-    {DEMONPRINCE, CMKWALL},
-    {DEMONKING, CPOLY},
-    {DEMONKING, CTELEPORT},
-    {DEMONKING, CMKWALL},
-    {NOMONST, 0},
-  },
-},
-{
-  "the %s can't hear the noise",
-  {
-    {EYE, CSSPEAR},
-    {CUBE, CSSPEAR},
-    {VORTEX, CSSPEAR},
-    {SHAMBLINGMOUND, CSSPEAR},
-    {YELLOWMOLD, CSSPEAR},
-    {DEMONLORD1, CSSPEAR},
-    {DEMONLORD2, CSSPEAR},
-    {DEMONLORD3, CSSPEAR},
-    {DEMONLORD4, CSSPEAR},
-    {DEMONLORD5, CSSPEAR},
-    {DEMONLORD6, CSSPEAR},
-    {DEMONLORD7, CSSPEAR},
-    {DEMONPRINCE, CSSPEAR},
-    {DEMONKING, CSSPEAR},
-    {NOMONST, 0},
-  },
-},
-{
-  "the %s's tail cuts it free of the web",
-  {
-    {ICELIZARD, CWEB},
-    {GREENDRAGON, CWEB},
-    {PLATINUMDRAGON, CWEB},
-    {NOMONST, 0},
-  },
-},
-{
-  "the %s burns through the web",
-  {
-    {HELLHOUND, CWEB},
-    {SILVERDRAGON, CWEB},
-    {REDDRAGON, CWEB},
-    {NOMONST, 0},
-  },
-},
-{
-  "your missiles pass right through the %s",
-  {
-    {CUBE, CMMISSILE},
-    {METAMORPH, CMMISSILE},
-    {VORTEX, CMMISSILE},
-    {WRAITH, CMMISSILE},
-    {POLTERGEIST, CMMISSILE},
-    {WATERLORD, CMMISSILE},
-    {XVART, CMMISSILE},
-    {SPIRITNAGA, CMMISSILE},
-    {DEMONLORD1, CMMISSILE},
-    {DEMONLORD2, CMMISSILE},
-    {DEMONLORD3, CMMISSILE},
-    {DEMONLORD4, CMMISSILE},
-    {DEMONLORD5, CMMISSILE},
-    {DEMONLORD6, CMMISSILE},
-    {DEMONLORD7, CMMISSILE},
-    {DEMONPRINCE, CMMISSILE},
-    {DEMONKING, CMMISSILE},
-    {NOMONST, 0},
-  },
-},
-{
-  "the %s sees through your illusions",
-  {
-    {WHITEDRAGON, CPHANTASM},
-    {ELF, CPHANTASM},
-    {WRAITH, CPHANTASM},
-    {VAMPIRE, CPHANTASM},
-    {SPIRITNAGA, CPHANTASM},
-    {PLATINUMDRAGON, CPHANTASM},
-    {NOMONST, 0},
-  },
-},
-{
-  "the %s appears to be recalling a fond memory.",
-  {
-    {DEMONLORD1, CPHANTASM},
-    {DEMONLORD2, CPHANTASM},
-    {DEMONLORD3, CPHANTASM},
-    {DEMONLORD4, CPHANTASM},
-    {DEMONLORD5, CPHANTASM},
-    {DEMONLORD6, CPHANTASM},
-    {DEMONLORD7, CPHANTASM},
-    {DEMONPRINCE, CPHANTASM},
-    {DEMONKING, CPHANTASM},
-    {NOMONST, 0},
-  },
-},
-{
-  "the %s loves the cold!",
-  {
-    {ICELIZARD, CCOLD},
-    {YETI, CCOLD},
-    {WHITEDRAGON, CCOLD},
-    {NOMONST, 0},
-  },
-},
-{
-  "the %s loves the water!",
-  {
-    {WATERLORD, CFLOOD},
-    {NOMONST, 0},
-  },
-},
-{
-  "the demon is terrified of the %s!",
-  {
-    {DEMONLORD1, CSUMMON},
-    {DEMONLORD2, CSUMMON},
-    {DEMONLORD3, CSUMMON},
-    {DEMONLORD4, CSUMMON},
-    {DEMONLORD5, CSUMMON},
-    {DEMONLORD6, CSUMMON},
-    {DEMONLORD7, CSUMMON},
-    {DEMONPRINCE, CSUMMON},
-    {DEMONKING, CSUMMON},
-    {NOMONST, 0},
-  },
-},
-{
-  "the %s loves fire and lightning!",
-  {
-    {DEMONKING, CFIREBALL},
-    {DEMONKING, CLIGHTNING},
-    {NOMONST, 0},
-  },
-},
-{ NULL, }
+#define SPELL_IMMUNITIES(IMM, arg)                                            \
+    IMM(arg, VORTEX,              CWEB,           IM_WEB_NO_EFFECT)           \
+    IMM(arg, INVISIBLESTALKER,    CWEB,           IM_WEB_NO_EFFECT)           \
+    IMM(arg, POLTERGEIST,         CWEB,           IM_WEB_NO_EFFECT)           \
+    IMM(arg, YELLOWMOLD,          CWEB,           IM_WEB_NO_EFFECT)           \
+    IMM(arg, WATERLORD,           CWEB,           IM_WEB_NO_EFFECT)           \
+    IMM(arg, SPIRITNAGA,          CWEB,           IM_WEB_NO_EFFECT)           \
+    IMM(arg, DEMONLORD1,          CWEB,           IM_WEB_NO_EFFECT)           \
+    IMM(arg, DEMONLORD2,          CWEB,           IM_WEB_NO_EFFECT)           \
+    IMM(arg, DEMONLORD3,          CWEB,           IM_WEB_NO_EFFECT)           \
+    IMM(arg, DEMONLORD4,          CWEB,           IM_WEB_NO_EFFECT)           \
+    IMM(arg, DEMONLORD5,          CWEB,           IM_WEB_NO_EFFECT)           \
+    IMM(arg, DEMONLORD6,          CWEB,           IM_WEB_NO_EFFECT)           \
+    IMM(arg, DEMONLORD7,          CWEB,           IM_WEB_NO_EFFECT)           \
+    IMM(arg, DEMONPRINCE,         CWEB,           IM_WEB_NO_EFFECT)           \
+    IMM(arg, DEMONKING,           CWEB,           IM_WEB_NO_EFFECT)           \
+                                                                              \
+    IMM(arg, CUBE,                CWEB,           IM_WEB_SHAPESHIFT)          \
+    IMM(arg, METAMORPH,           CWEB,           IM_WEB_SHAPESHIFT)          \
+    IMM(arg, VAMPIRE,             CWEB,           IM_WEB_SHAPESHIFT)          \
+    IMM(arg, MIMIC,               CWEB,           IM_WEB_SHAPESHIFT)          \
+                                                                              \
+    IMM(arg, GNOMEKING,           CCHARM,         IM_NOT_AFRAID)              \
+    IMM(arg, WATERLORD,           CCHARM,         IM_NOT_AFRAID)              \
+    IMM(arg, SPIRITNAGA,          CCHARM,         IM_NOT_AFRAID)              \
+    IMM(arg, DEMONLORD1,          CCHARM,         IM_NOT_AFRAID)              \
+    IMM(arg, DEMONLORD1,          CSCAREMON,      IM_NOT_AFRAID)              \
+    IMM(arg, DEMONLORD2,          CCHARM,         IM_NOT_AFRAID)              \
+    IMM(arg, DEMONLORD2,          CSCAREMON,      IM_NOT_AFRAID)              \
+    IMM(arg, DEMONLORD3,          CCHARM,         IM_NOT_AFRAID)              \
+    IMM(arg, DEMONLORD3,          CSCAREMON,      IM_NOT_AFRAID)              \
+    IMM(arg, DEMONLORD4,          CCHARM,         IM_NOT_AFRAID)              \
+    IMM(arg, DEMONLORD4,          CSCAREMON,      IM_NOT_AFRAID)              \
+    IMM(arg, DEMONLORD5,          CCHARM,         IM_NOT_AFRAID)              \
+    IMM(arg, DEMONLORD5,          CSCAREMON,      IM_NOT_AFRAID)              \
+    IMM(arg, DEMONLORD6,          CCHARM,         IM_NOT_AFRAID)              \
+    IMM(arg, DEMONLORD6,          CSCAREMON,      IM_NOT_AFRAID)              \
+    IMM(arg, DEMONLORD7,          CCHARM,         IM_NOT_AFRAID)              \
+    IMM(arg, DEMONLORD7,          CSCAREMON,      IM_NOT_AFRAID)              \
+    IMM(arg, DEMONPRINCE,         CCHARM,         IM_NOT_AFRAID)              \
+    IMM(arg, DEMONPRINCE,         CSCAREMON,      IM_NOT_AFRAID)              \
+    IMM(arg, DEMONKING,           CCHARM,         IM_NOT_AFRAID)              \
+                                                                              \
+    IMM(arg, EYE,                 CFINGER,        IM_NOT_AFFECTED)            \
+    IMM(arg, ZOMBIE,              CSSPEAR,        IM_NOT_AFFECTED)            \
+    IMM(arg, ZOMBIE,              CPHANTASM,      IM_NOT_AFFECTED)            \
+    IMM(arg, ZOMBIE,              CCLOUD,         IM_NOT_AFFECTED)            \
+    IMM(arg, ZOMBIE,              CDRY,           IM_NOT_AFFECTED)            \
+    IMM(arg, ZOMBIE,              CDRAIN,         IM_NOT_AFFECTED)            \
+    IMM(arg, ZOMBIE,              CFINGER,        IM_NOT_AFFECTED)            \
+    IMM(arg, TROLL,               CDRY,           IM_NOT_AFFECTED)            \
+    IMM(arg, WHITEDRAGON,         CDRY,           IM_NOT_AFFECTED)            \
+    IMM(arg, CUBE,                CCLOUD,         IM_NOT_AFFECTED)            \
+    IMM(arg, CUBE,                CFINGER,        IM_NOT_AFFECTED)            \
+    IMM(arg, METAMORPH,           CCLOUD,         IM_NOT_AFFECTED)            \
+    IMM(arg, METAMORPH,           CDRY,           IM_NOT_AFFECTED)            \
+    IMM(arg, METAMORPH,           CFINGER,        IM_NOT_AFFECTED)            \
+    IMM(arg, VORTEX,              CCLOUD,         IM_NOT_AFFECTED)            \
+    IMM(arg, VORTEX,              CDRY,           IM_NOT_AFFECTED)            \
+    IMM(arg, VORTEX,              CFLOOD,         IM_NOT_AFFECTED)            \
+    IMM(arg, VORTEX,              CFINGER,        IM_NOT_AFFECTED)            \
+    IMM(arg, VIOLETFUNGI,         CFINGER,        IM_NOT_AFFECTED)            \
+    IMM(arg, WRAITH,              CSSPEAR,        IM_NOT_AFFECTED)            \
+    IMM(arg, WRAITH,              CCLOUD,         IM_NOT_AFFECTED)            \
+    IMM(arg, WRAITH,              CDRY,           IM_NOT_AFFECTED)            \
+    IMM(arg, WRAITH,              CDRAIN,         IM_NOT_AFFECTED)            \
+    IMM(arg, WRAITH,              CFINGER,        IM_NOT_AFFECTED)            \
+    IMM(arg, XORN,                CDRY,           IM_NOT_AFFECTED)            \
+    IMM(arg, XORN,                CFLOOD,         IM_NOT_AFFECTED)            \
+    IMM(arg, XORN,                CFINGER,        IM_NOT_AFFECTED)            \
+    IMM(arg, VAMPIRE,             CSSPEAR,        IM_NOT_AFFECTED)            \
+    IMM(arg, VAMPIRE,             CCLOUD,         IM_NOT_AFFECTED)            \
+    IMM(arg, VAMPIRE,             CDRAIN,         IM_NOT_AFFECTED)            \
+    IMM(arg, VAMPIRE,             CFINGER,        IM_NOT_AFFECTED)            \
+    IMM(arg, POLTERGEIST,         CSSPEAR,        IM_NOT_AFFECTED)            \
+    IMM(arg, POLTERGEIST,         CCOLD,          IM_NOT_AFFECTED)            \
+    IMM(arg, POLTERGEIST,         CCLOUD,         IM_NOT_AFFECTED)            \
+    IMM(arg, POLTERGEIST,         CDRY,           IM_NOT_AFFECTED)            \
+    IMM(arg, POLTERGEIST,         CDRAIN,         IM_NOT_AFFECTED)            \
+    IMM(arg, POLTERGEIST,         CFLOOD,         IM_NOT_AFFECTED)            \
+    IMM(arg, POLTERGEIST,         CFINGER,        IM_NOT_AFFECTED)            \
+    IMM(arg, YELLOWMOLD,          CCLOUD,         IM_NOT_AFFECTED)            \
+    IMM(arg, YELLOWMOLD,          CFINGER,        IM_NOT_AFFECTED)            \
+    IMM(arg, WATERLORD,           CSSPEAR,        IM_NOT_AFFECTED)            \
+    IMM(arg, WATERLORD,           CCLOUD,         IM_NOT_AFFECTED)            \
+    IMM(arg, WATERLORD,           CFINGER,        IM_NOT_AFFECTED)            \
+    IMM(arg, XVART,               CFLOOD,         IM_NOT_AFFECTED)            \
+    IMM(arg, XVART,               CFINGER,        IM_NOT_AFFECTED)            \
+    IMM(arg, SPIRITNAGA,          CSSPEAR,        IM_NOT_AFFECTED)            \
+    IMM(arg, SPIRITNAGA,          CCOLD,          IM_NOT_AFFECTED)            \
+    IMM(arg, SPIRITNAGA,          CCLOUD,         IM_NOT_AFFECTED)            \
+    IMM(arg, SPIRITNAGA,          CDRY,           IM_NOT_AFFECTED)            \
+    IMM(arg, SPIRITNAGA,          CDRAIN,         IM_NOT_AFFECTED)            \
+    IMM(arg, SPIRITNAGA,          CFLOOD,         IM_NOT_AFFECTED)            \
+    IMM(arg, SPIRITNAGA,          CFINGER,        IM_NOT_AFFECTED)            \
+    IMM(arg, DEMONLORD1,          CCLOUD,         IM_NOT_AFFECTED)            \
+    IMM(arg, DEMONLORD1,          CDRY,           IM_NOT_AFFECTED)            \
+    IMM(arg, DEMONLORD1,          CFLOOD,         IM_NOT_AFFECTED)            \
+    IMM(arg, DEMONLORD1,          CFINGER,        IM_NOT_AFFECTED)            \
+    IMM(arg, DEMONLORD1,          CMAGICFIRE,     IM_NOT_AFFECTED)            \
+    IMM(arg, DEMONLORD2,          CCLOUD,         IM_NOT_AFFECTED)            \
+    IMM(arg, DEMONLORD2,          CDRY,           IM_NOT_AFFECTED)            \
+    IMM(arg, DEMONLORD2,          CFLOOD,         IM_NOT_AFFECTED)            \
+    IMM(arg, DEMONLORD2,          CFINGER,        IM_NOT_AFFECTED)            \
+    IMM(arg, DEMONLORD2,          CMAGICFIRE,     IM_NOT_AFFECTED)            \
+    IMM(arg, DEMONLORD3,          CCLOUD,         IM_NOT_AFFECTED)            \
+    IMM(arg, DEMONLORD3,          CDRY,           IM_NOT_AFFECTED)            \
+    IMM(arg, DEMONLORD3,          CFLOOD,         IM_NOT_AFFECTED)            \
+    IMM(arg, DEMONLORD3,          CFINGER,        IM_NOT_AFFECTED)            \
+    IMM(arg, DEMONLORD3,          CMAGICFIRE,     IM_NOT_AFFECTED)            \
+    IMM(arg, DEMONLORD4,          CCLOUD,         IM_NOT_AFFECTED)            \
+    IMM(arg, DEMONLORD4,          CDRY,           IM_NOT_AFFECTED)            \
+    IMM(arg, DEMONLORD4,          CFLOOD,         IM_NOT_AFFECTED)            \
+    IMM(arg, DEMONLORD4,          CFINGER,        IM_NOT_AFFECTED)            \
+    IMM(arg, DEMONLORD4,          CMAGICFIRE,     IM_NOT_AFFECTED)            \
+    IMM(arg, DEMONLORD5,          CCLOUD,         IM_NOT_AFFECTED)            \
+    IMM(arg, DEMONLORD5,          CDRY,           IM_NOT_AFFECTED)            \
+    IMM(arg, DEMONLORD5,          CFLOOD,         IM_NOT_AFFECTED)            \
+    IMM(arg, DEMONLORD5,          CFINGER,        IM_NOT_AFFECTED)            \
+    IMM(arg, DEMONLORD5,          CMAGICFIRE,     IM_NOT_AFFECTED)            \
+    IMM(arg, DEMONLORD6,          CPOLY,          IM_NOT_AFFECTED)            \
+    IMM(arg, DEMONLORD6,          CCLOUD,         IM_NOT_AFFECTED)            \
+    IMM(arg, DEMONLORD6,          CDRY,           IM_NOT_AFFECTED)            \
+    IMM(arg, DEMONLORD6,          CFLOOD,         IM_NOT_AFFECTED)            \
+    IMM(arg, DEMONLORD6,          CFINGER,        IM_NOT_AFFECTED)            \
+    IMM(arg, DEMONLORD6,          CMAGICFIRE,     IM_NOT_AFFECTED)            \
+    IMM(arg, DEMONLORD7,          CPOLY,          IM_NOT_AFFECTED)            \
+    IMM(arg, DEMONLORD7,          CCLOUD,         IM_NOT_AFFECTED)            \
+    IMM(arg, DEMONLORD7,          CDRY,           IM_NOT_AFFECTED)            \
+    IMM(arg, DEMONLORD7,          CFLOOD,         IM_NOT_AFFECTED)            \
+    IMM(arg, DEMONLORD7,          CFINGER,        IM_NOT_AFFECTED)            \
+    IMM(arg, DEMONLORD7,          CMAGICFIRE,     IM_NOT_AFFECTED)            \
+    IMM(arg, DEMONPRINCE,         CPOLY,          IM_NOT_AFFECTED)            \
+    IMM(arg, DEMONPRINCE,         CCLOUD,         IM_NOT_AFFECTED)            \
+    IMM(arg, DEMONPRINCE,         CDRY,           IM_NOT_AFFECTED)            \
+    IMM(arg, DEMONPRINCE,         CDRAIN,         IM_NOT_AFFECTED)            \
+    IMM(arg, DEMONPRINCE,         CFLOOD,         IM_NOT_AFFECTED)            \
+    IMM(arg, DEMONPRINCE,         CFINGER,        IM_NOT_AFFECTED)            \
+    IMM(arg, DEMONPRINCE,         CMAGICFIRE,     IM_NOT_AFFECTED)            \
+    IMM(arg, DEMONKING,           CCLOUD,         IM_NOT_AFFECTED)            \
+    IMM(arg, DEMONKING,           CDRY,           IM_NOT_AFFECTED)            \
+    IMM(arg, DEMONKING,           CDRAIN,         IM_NOT_AFFECTED)            \
+    IMM(arg, DEMONKING,           CFINGER,        IM_NOT_AFFECTED)            \
+    IMM(arg, DEMONKING,           CSCAREMON,      IM_NOT_AFFECTED)            \
+    IMM(arg, DEMONKING,           CHOLDMON,       IM_NOT_AFFECTED)            \
+    IMM(arg, DEMONKING,           CMAGICFIRE,     IM_NOT_AFFECTED)            \
+                                                                              \
+    IMM(arg, GNOME,               CINV,           IM_INFRAVISION)             \
+    IMM(arg, KOBOLD,              CINV,           IM_INFRAVISION)             \
+    IMM(arg, BUGBEAR,             CINV,           IM_INFRAVISION)             \
+    IMM(arg, ELF,                 CINV,           IM_INFRAVISION)             \
+    IMM(arg, FORVALAKA,           CINV,           IM_INFRAVISION)             \
+    IMM(arg, ROTHE,               CINV,           IM_INFRAVISION)             \
+    IMM(arg, XORN,                CINV,           IM_INFRAVISION)             \
+    IMM(arg, UMBERHULK,           CINV,           IM_INFRAVISION)             \
+    IMM(arg, GNOMEKING,           CINV,           IM_INFRAVISION)             \
+    IMM(arg, SPIRITNAGA,          CINV,           IM_INFRAVISION)             \
+    IMM(arg, DEMONLORD1,          CINV,           IM_INFRAVISION)             \
+    IMM(arg, DEMONLORD2,          CINV,           IM_INFRAVISION)             \
+    IMM(arg, DEMONLORD3,          CINV,           IM_INFRAVISION)             \
+    IMM(arg, DEMONLORD4,          CINV,           IM_INFRAVISION)             \
+    IMM(arg, DEMONLORD5,          CINV,           IM_INFRAVISION)             \
+    IMM(arg, DEMONLORD6,          CINV,           IM_INFRAVISION)             \
+    IMM(arg, DEMONLORD7,          CINV,           IM_INFRAVISION)             \
+    IMM(arg, DEMONPRINCE,         CINV,           IM_INFRAVISION)             \
+    IMM(arg, DEMONKING,           CINV,           IM_INFRAVISION)             \
+                                                                              \
+    IMM(arg, HELLHOUND,           CMMISSILE,      IM_VAPORIZES)               \
+    IMM(arg, SILVERDRAGON,        CMMISSILE,      IM_VAPORIZES)               \
+    IMM(arg, REDDRAGON,           CMMISSILE,      IM_VAPORIZES)               \
+                                                                              \
+    IMM(arg, TROLL,               CMMISSILE,      IM_BOUNCES)                 \
+    IMM(arg, ROTHE,               CMMISSILE,      IM_BOUNCES)                 \
+    IMM(arg, XORN,                CMMISSILE,      IM_BOUNCES)                 \
+    IMM(arg, UMBERHULK,           CMMISSILE,      IM_BOUNCES)                 \
+    IMM(arg, GNOMEKING,           CMMISSILE,      IM_BOUNCES)                 \
+    IMM(arg, BRONZEDRAGON,        CMMISSILE,      IM_BOUNCES)                 \
+    IMM(arg, GREENDRAGON,         CMMISSILE,      IM_BOUNCES)                 \
+    IMM(arg, PLATINUMDRAGON,      CMMISSILE,      IM_BOUNCES)                 \
+                                                                              \
+    IMM(arg, EYE,                 CSLEEP,         IM_NO_SLEEP)                \
+    IMM(arg, ZOMBIE,              CSLEEP,         IM_NO_SLEEP)                \
+    IMM(arg, CUBE,                CSLEEP,         IM_NO_SLEEP)                \
+    IMM(arg, VIOLETFUNGI,         CSLEEP,         IM_NO_SLEEP)                \
+    IMM(arg, WRAITH,              CSLEEP,         IM_NO_SLEEP)                \
+    IMM(arg, XORN,                CSLEEP,         IM_NO_SLEEP)                \
+    IMM(arg, POLTERGEIST,         CSLEEP,         IM_NO_SLEEP)                \
+    IMM(arg, DISENCHANTRESS,      CSLEEP,         IM_NO_SLEEP)                \
+    IMM(arg, YELLOWMOLD,          CSLEEP,         IM_NO_SLEEP)                \
+    IMM(arg, WATERLORD,           CSLEEP,         IM_NO_SLEEP)                \
+    IMM(arg, SPIRITNAGA,          CSLEEP,         IM_NO_SLEEP)                \
+    IMM(arg, DEMONLORD1,          CSLEEP,         IM_NO_SLEEP)                \
+    IMM(arg, DEMONLORD2,          CSLEEP,         IM_NO_SLEEP)                \
+    IMM(arg, DEMONLORD3,          CSLEEP,         IM_NO_SLEEP)                \
+    IMM(arg, DEMONLORD4,          CSLEEP,         IM_NO_SLEEP)                \
+    IMM(arg, DEMONLORD5,          CSLEEP,         IM_NO_SLEEP)                \
+    IMM(arg, DEMONLORD6,          CSLEEP,         IM_NO_SLEEP)                \
+    IMM(arg, DEMONLORD7,          CSLEEP,         IM_NO_SLEEP)                \
+    IMM(arg, DEMONPRINCE,         CSLEEP,         IM_NO_SLEEP)                \
+    IMM(arg, DEMONKING,           CSLEEP,         IM_NO_SLEEP)                \
+                                                                              \
+    IMM(arg, GNOMEKING,           CPOLY,          IM_RESISTS)                 \
+    IMM(arg, WATERLORD,           CPOLY,          IM_RESISTS)                 \
+    IMM(arg, SPIRITNAGA,          CPOLY,          IM_RESISTS)                 \
+    IMM(arg, SILVERDRAGON,        CSLEEP,         IM_RESISTS)                 \
+    IMM(arg, SILVERDRAGON,        CPOLY,          IM_RESISTS)                 \
+    IMM(arg, PLATINUMDRAGON,      CSLEEP,         IM_RESISTS)                 \
+    IMM(arg, PLATINUMDRAGON,      CPOLY,          IM_RESISTS)                 \
+    IMM(arg, DEMONLORD1,          CPOLY,          IM_RESISTS)                 \
+    IMM(arg, DEMONLORD1,          CDRAIN,         IM_RESISTS)                 \
+    IMM(arg, DEMONLORD1,          CTELEPORT,      IM_RESISTS)                 \
+    IMM(arg, DEMONLORD1,          CMKWALL,        IM_RESISTS)                 \
+    IMM(arg, DEMONLORD2,          CPOLY,          IM_RESISTS)                 \
+    IMM(arg, DEMONLORD2,          CDRAIN,         IM_RESISTS)                 \
+    IMM(arg, DEMONLORD2,          CTELEPORT,      IM_RESISTS)                 \
+    IMM(arg, DEMONLORD2,          CMKWALL,        IM_RESISTS)                 \
+    IMM(arg, DEMONLORD3,          CPOLY,          IM_RESISTS)                 \
+    IMM(arg, DEMONLORD3,          CDRAIN,         IM_RESISTS)                 \
+    IMM(arg, DEMONLORD3,          CTELEPORT,      IM_RESISTS)                 \
+    IMM(arg, DEMONLORD3,          CMKWALL,        IM_RESISTS)                 \
+    IMM(arg, DEMONLORD4,          CPOLY,          IM_RESISTS)                 \
+    IMM(arg, DEMONLORD4,          CDRAIN,         IM_RESISTS)                 \
+    IMM(arg, DEMONLORD4,          CTELEPORT,      IM_RESISTS)                 \
+    IMM(arg, DEMONLORD4,          CMKWALL,        IM_RESISTS)                 \
+    IMM(arg, DEMONLORD5,          CPOLY,          IM_RESISTS)                 \
+    IMM(arg, DEMONLORD5,          CDRAIN,         IM_RESISTS)                 \
+    IMM(arg, DEMONLORD5,          CTELEPORT,      IM_RESISTS)                 \
+    IMM(arg, DEMONLORD5,          CMKWALL,        IM_RESISTS)                 \
+    IMM(arg, DEMONLORD6,          CTELEPORT,      IM_RESISTS)                 \
+    IMM(arg, DEMONLORD6,          CMKWALL,        IM_RESISTS)                 \
+    IMM(arg, DEMONLORD7,          CTELEPORT,      IM_RESISTS)                 \
+    IMM(arg, DEMONLORD7,          CMKWALL,        IM_RESISTS)                 \
+    IMM(arg, DEMONPRINCE,         CTELEPORT,      IM_RESISTS)                 \
+    IMM(arg, DEMONPRINCE,         CMKWALL,        IM_RESISTS)                 \
+    IMM(arg, DEMONKING,           CPOLY,          IM_RESISTS)                 \
+    IMM(arg, DEMONKING,           CTELEPORT,      IM_RESISTS)                 \
+    IMM(arg, DEMONKING,           CMKWALL,        IM_RESISTS)                 \
+                                                                              \
+    IMM(arg, EYE,                 CSSPEAR,        IM_DEAF)                    \
+    IMM(arg, CUBE,                CSSPEAR,        IM_DEAF)                    \
+    IMM(arg, VORTEX,              CSSPEAR,        IM_DEAF)                    \
+    IMM(arg, SHAMBLINGMOUND,      CSSPEAR,        IM_DEAF)                    \
+    IMM(arg, YELLOWMOLD,          CSSPEAR,        IM_DEAF)                    \
+    IMM(arg, DEMONLORD1,          CSSPEAR,        IM_DEAF)                    \
+    IMM(arg, DEMONLORD2,          CSSPEAR,        IM_DEAF)                    \
+    IMM(arg, DEMONLORD3,          CSSPEAR,        IM_DEAF)                    \
+    IMM(arg, DEMONLORD4,          CSSPEAR,        IM_DEAF)                    \
+    IMM(arg, DEMONLORD5,          CSSPEAR,        IM_DEAF)                    \
+    IMM(arg, DEMONLORD6,          CSSPEAR,        IM_DEAF)                    \
+    IMM(arg, DEMONLORD7,          CSSPEAR,        IM_DEAF)                    \
+    IMM(arg, DEMONPRINCE,         CSSPEAR,        IM_DEAF)                    \
+    IMM(arg, DEMONKING,           CSSPEAR,        IM_DEAF)                    \
+                                                                              \
+    IMM(arg, ICELIZARD,           CWEB,           IM_WEB_TAIL)                \
+    IMM(arg, GREENDRAGON,         CWEB,           IM_WEB_TAIL)                \
+    IMM(arg, PLATINUMDRAGON,      CWEB,           IM_WEB_TAIL)                \
+                                                                              \
+    IMM(arg, HELLHOUND,           CWEB,           IM_WEB_BURNS)               \
+    IMM(arg, SILVERDRAGON,        CWEB,           IM_WEB_BURNS)               \
+    IMM(arg, REDDRAGON,           CWEB,           IM_WEB_BURNS)               \
+                                                                              \
+    IMM(arg, CUBE,                CMMISSILE,      IM_PASS_THROUGH)            \
+    IMM(arg, METAMORPH,           CMMISSILE,      IM_PASS_THROUGH)            \
+    IMM(arg, VORTEX,              CMMISSILE,      IM_PASS_THROUGH)            \
+    IMM(arg, WRAITH,              CMMISSILE,      IM_PASS_THROUGH)            \
+    IMM(arg, POLTERGEIST,         CMMISSILE,      IM_PASS_THROUGH)            \
+    IMM(arg, WATERLORD,           CMMISSILE,      IM_PASS_THROUGH)            \
+    IMM(arg, XVART,               CMMISSILE,      IM_PASS_THROUGH)            \
+    IMM(arg, SPIRITNAGA,          CMMISSILE,      IM_PASS_THROUGH)            \
+    IMM(arg, DEMONLORD1,          CMMISSILE,      IM_PASS_THROUGH)            \
+    IMM(arg, DEMONLORD2,          CMMISSILE,      IM_PASS_THROUGH)            \
+    IMM(arg, DEMONLORD3,          CMMISSILE,      IM_PASS_THROUGH)            \
+    IMM(arg, DEMONLORD4,          CMMISSILE,      IM_PASS_THROUGH)            \
+    IMM(arg, DEMONLORD5,          CMMISSILE,      IM_PASS_THROUGH)            \
+    IMM(arg, DEMONLORD6,          CMMISSILE,      IM_PASS_THROUGH)            \
+    IMM(arg, DEMONLORD7,          CMMISSILE,      IM_PASS_THROUGH)            \
+    IMM(arg, DEMONPRINCE,         CMMISSILE,      IM_PASS_THROUGH)            \
+    IMM(arg, DEMONKING,           CMMISSILE,      IM_PASS_THROUGH)            \
+                                                                              \
+    IMM(arg, WHITEDRAGON,         CPHANTASM,      IM_SEES_ILLUSIONS)          \
+    IMM(arg, ELF,                 CPHANTASM,      IM_SEES_ILLUSIONS)          \
+    IMM(arg, WRAITH,              CPHANTASM,      IM_SEES_ILLUSIONS)          \
+    IMM(arg, VAMPIRE,             CPHANTASM,      IM_SEES_ILLUSIONS)          \
+    IMM(arg, SPIRITNAGA,          CPHANTASM,      IM_SEES_ILLUSIONS)          \
+    IMM(arg, PLATINUMDRAGON,      CPHANTASM,      IM_SEES_ILLUSIONS)          \
+                                                                              \
+    IMM(arg, DEMONLORD1,          CPHANTASM,      IM_FOND_MEMORY)             \
+    IMM(arg, DEMONLORD2,          CPHANTASM,      IM_FOND_MEMORY)             \
+    IMM(arg, DEMONLORD3,          CPHANTASM,      IM_FOND_MEMORY)             \
+    IMM(arg, DEMONLORD4,          CPHANTASM,      IM_FOND_MEMORY)             \
+    IMM(arg, DEMONLORD5,          CPHANTASM,      IM_FOND_MEMORY)             \
+    IMM(arg, DEMONLORD6,          CPHANTASM,      IM_FOND_MEMORY)             \
+    IMM(arg, DEMONLORD7,          CPHANTASM,      IM_FOND_MEMORY)             \
+    IMM(arg, DEMONPRINCE,         CPHANTASM,      IM_FOND_MEMORY)             \
+    IMM(arg, DEMONKING,           CPHANTASM,      IM_FOND_MEMORY)             \
+                                                                              \
+    IMM(arg, ICELIZARD,           CCOLD,          IM_LOVES_COLD)              \
+    IMM(arg, YETI,                CCOLD,          IM_LOVES_COLD)              \
+    IMM(arg, WHITEDRAGON,         CCOLD,          IM_LOVES_COLD)              \
+                                                                              \
+    IMM(arg, WATERLORD,           CFLOOD,         IM_LOVES_WATER)             \
+                                                                              \
+    IMM(arg, DEMONLORD1,          CSUMMON,        IM_TERRIFIED)               \
+    IMM(arg, DEMONLORD2,          CSUMMON,        IM_TERRIFIED)               \
+    IMM(arg, DEMONLORD3,          CSUMMON,        IM_TERRIFIED)               \
+    IMM(arg, DEMONLORD4,          CSUMMON,        IM_TERRIFIED)               \
+    IMM(arg, DEMONLORD5,          CSUMMON,        IM_TERRIFIED)               \
+    IMM(arg, DEMONLORD6,          CSUMMON,        IM_TERRIFIED)               \
+    IMM(arg, DEMONLORD7,          CSUMMON,        IM_TERRIFIED)               \
+    IMM(arg, DEMONPRINCE,         CSUMMON,        IM_TERRIFIED)               \
+    IMM(arg, DEMONKING,           CSUMMON,        IM_TERRIFIED)               \
+                                                                              \
+    IMM(arg, DEMONKING,           CFIREBALL,      IM_LOVES_FIRE)              \
+    IMM(arg, DEMONKING,           CLIGHTNING,     IM_LOVES_FIRE)
@@ -72,8 +72,8 @@ static void
 sphboom (struct SphereState *sp) {
     uint8_t x = sp->x, y = sp->y;
 
-    if (UU.holdmonst) { UU.holdmonst = 1; }
-    if (UU.cancellation) { UU.cancellation = 1; }
+    if (effect_left(EFF_HOLDMONST)) { effect_set(EFF_HOLDMONST, 1); }
+    if (effect_left(EFF_CANCELLATION)) { effect_set(EFF_CANCELLATION, 1); }
 
     const int left      = max(1, x - 2);
     const int right     = min(x + 3, MAXX - 1);
@@ -96,7 +96,7 @@ sphboom (struct SphereState *sp) {
                 game_over_probably(DDSPHERE); /* player killed in explosion */
             }/* if */
 
-            at(ix, iy)->obj = obj(OANNIHILATION, 0);
+            set_obj_at(ix, iy, obj(OANNIHILATION, 0));
             at(ix, iy)->mon = NULL_MON;
             see_and_update_at(ix, iy);
         }/* for */
@@ -106,7 +106,7 @@ sphboom (struct SphereState *sp) {
 
     for (int ix = left; ix < right; ix++) {
         for (int iy = top; iy < bottom; iy++) {
-            at(ix, iy)->obj = NULL_OBJ;
+            set_obj_at(ix, iy, NULL_OBJ);
             see_and_update_at(ix, iy);
         }// for
     }// for
@@ -156,7 +156,7 @@ sphere_failed_no_talisman(struct SphereState *sp) {
     }
 
     /* cancellation cancels spheres */
-    if (UU.cancellation) {
+    if (effect_left(EFF_CANCELLATION)) {
         say("As the cancellation takes effect, you hear a great earth-shaking "
             "blast!\n");
         headsup();
@@ -228,7 +228,7 @@ static bool
 move_sphere(struct SphereState *sph, int destX, int destY) {
 
     // Remove the sphere object from the current location
-    at(sph->x, sph->y)->obj     = NULL_OBJ;
+    set_obj_at(sph->x, sph->y, NULL_OBJ);
     see_and_update_at(sph->x, sph->y);
 
     // Set the new location
@@ -244,7 +244,7 @@ move_sphere(struct SphereState *sph, int destX, int destY) {
 
     // Place the sphere object and destroy whatever creature may be
     // there.
-    at(sph->x, sph->y)->obj       = obj(OANNIHILATION, 0);
+    set_obj_at(sph->x, sph->y, obj(OANNIHILATION, 0));
     at(sph->x, sph->y)->mon       = NULL_MON;
     see_and_update_at(sph->x, sph->y);
 
@@ -310,7 +310,7 @@ rmsphere(struct SphereList *list, int x, int y) {
     // Now, delete it from the map.  (Note that this will work even if
     // the sphere isn't in UU.spheres.)
     if (at(x, y)->obj.type == OANNIHILATION) {
-        at(x, y)->obj = NULL_OBJ;
+        set_obj_at(x, y, NULL_OBJ);
         see_and_update_at(x,y);
     }// if
 }// rmsphere
@@ -335,7 +335,7 @@ updatespheres(struct SphereList *spheres) {
         // zero (i.e. the sphere has dissipated).
         --sp->lifetime;
         if (sp->lifetime == 0) {
-            at(sp->x, sp->y)->obj = NULL_OBJ;
+            set_obj_at(sp->x, sp->y, NULL_OBJ);
             see_and_update_at(sp->x, sp->y);
             continue;
         }// if
@@ -18,10 +18,7 @@
 // This is shared by the DnD Store, Trading Post and Dealer McDope.
 //
 
-// The common inventory
-struct StoreItem ShopInvent[OBJ_COUNT];
-unsigned ShopInventSz = 0;
-
+// The common inventory is ShopInvent[] in the game context.
 
 // Sort function; compare two StoreItems by price
 static int
@@ -332,13 +329,11 @@ sell_multi(int filter,                      // Mask of acceptible attributes
     int total = confirm_full_sale(nsell, forsale, pricemode);
     if (total < 0) {
         say("%s\n", nosale);
-        free(forsale);
         return;
     }// if
 
     UU.gold += total;
     restock_all(nsell, forsale);
-    free(forsale);
 
     say(fmt_sold_for_price, nsell, total);
 }// sell_multi
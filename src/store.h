@@ -16,8 +16,7 @@ struct StoreItem {
     uint8_t    qty;
 };
 
-extern struct StoreItem ShopInvent[OBJ_COUNT];
-extern unsigned ShopInventSz;
+// ShopInvent[] and ShopInventSz are in the game context.
 
 void sell_multi(int filter, enum PRICEMODE pricemode, const char *intro,
                 const char *nothing_to_sell, const char *nosale,
@@ -4,17 +4,46 @@
 #include "stringbuilder.h"
 
 #include <limits.h>
+#include <stdarg.h>
 
 #include "internal_assert.h"
 
 #include "util.h"
 
+// Initial capacity of a heap-allocated StringBuilder
+#define SB_INITIAL_CAPACITY 64
+
+
+// Make sure 'sb' has room for 'extra' more characters (plus the
+// trailing null), growing the buffer geometrically if not.  If the
+// buffer is caller-provided, this moves the contents to the heap.
+static void
+reserve(struct StringBuilder *sb, size_t extra) {
+    size_t needed = sb->length + extra + 1;
+    if (needed <= sb->capacity) { return; }
+
+    size_t newcap = 2 * sb->capacity;
+    if (newcap < needed) { newcap = needed; }
+
+    if (sb->external) {
+        char *newbuf = xmalloc(newcap);
+        memcpy(newbuf, sb->buffer, sb->length + 1);
+        sb->buffer = newbuf;
+        sb->external = false;
+    } else {
+        sb->buffer = xrealloc(sb->buffer, newcap);
+    }// if .. else
+
+    sb->capacity = newcap;
+}// reserve
+
 
 // Create a new StringBuilder
 struct StringBuilder*
 sb_alloc() {
     struct StringBuilder *sb = xcalloc(1, sizeof(struct StringBuilder));
-    sb->buffer = xcalloc(1, sizeof(char));
+    sb->capacity = SB_INITIAL_CAPACITY;
+    sb->buffer = xcalloc(sb->capacity, sizeof(char));
     return sb;
 }
 
@@ -23,39 +52,89 @@ void
 sb_free(struct StringBuilder *sb) {
     if (!sb) { return; }    // Tolerate NULL argument
 
-    free(sb->buffer);
+    sb_release(sb);
     free(sb);
 }
 
+// Initialize a caller-owned (typically stack) StringBuilder to use
+// 'storage' (of 'size' bytes) as its buffer until it outgrows it.
+// Use sb_release() (not sb_free() or sb_str_and_free()) to dispose
+// of it.
+void
+sb_init_external(struct StringBuilder *sb, char *storage, size_t size) {
+    ASSERT(size > 0);
+
+    sb->buffer = storage;
+    sb->buffer[0] = 0;
+    sb->length = 0;
+    sb->capacity = size;
+    sb->external = true;
+}// sb_init_external
+
+// Free any heap memory held by 'sb' but not 'sb' itself.
+void
+sb_release(struct StringBuilder *sb) {
+    if (!sb->external) {
+        free(sb->buffer);
+    }
+
+    sb->buffer = NULL;
+    sb->length = sb->capacity = 0;
+}// sb_release
+
 // Append the contents of 'text' to sb.
 void
 sb_append(struct StringBuilder *sb, const char *text) {
     if (! *text) { return; }
 
     size_t len = strlen(text);
+    reserve(sb, len);
+    memcpy(sb->buffer + sb->length, text, len + 1);
     sb->length += len;
-    sb->buffer = xrealloc(sb->buffer, sb->length + 1);
-    strcat(sb->buffer, text);
 
-    ASSERT(sb->length == strlen(sb->buffer));
     ASSERT(sb->length < LONG_MAX);
 }
 
 // Append a single char to 'sb'.
 void
 sb_append_char(struct StringBuilder *sb, char c) {
-    // TODO: make this more efficient
-    char cb[2];
-    cb[0] = c;
-    cb[1] = 0;
-    sb_append(sb, cb);
+    reserve(sb, 1);
+    sb->buffer[sb->length++] = c;
+    sb->buffer[sb->length] = 0;
 }
 
+// Append printf-style formatted text to 'sb', formatting directly
+// into the buffer.
+void
+sb_appendf(struct StringBuilder *sb, const char *fmt, ...) {
+    va_list ap;
+
+    // Try formatting into whatever space is left.
+    va_start(ap, fmt);
+    size_t avail = sb->capacity - sb->length;
+    int len = vsnprintf(sb->buffer + sb->length, avail, fmt, ap);
+    va_end(ap);
+
+    ASSERT(len >= 0);
+
+    // If it didn't fit, make room and try again.
+    if ((size_t)len >= avail) {
+        reserve(sb, len);
+
+        va_start(ap, fmt);
+        vsnprintf(sb->buffer + sb->length, len + 1, fmt, ap);
+        va_end(ap);
+    }// if
+
+    sb->length += len;
+    ASSERT(sb->length < LONG_MAX);
+}// sb_appendf
+
 // Free the builder, returning the alloc'd content.
 char *
 sb_str_and_free(struct StringBuilder *sb) {
-    ASSERT(sb);
-    
+    ASSERT(sb && !sb->external);
+
     const char *str = sb->buffer;
     free(sb);
     return (char *)str;
@@ -63,7 +142,6 @@ sb_str_and_free(struct StringBuilder *sb) {
 
 void
 sb_reset(struct StringBuilder *sb) {
-    sb->buffer = xrealloc(sb->buffer, 1);
     sb->buffer[0] = '\0';
     sb->length = 0;
 }// sb_reset
@@ -80,7 +158,6 @@ sb_drop(struct StringBuilder *sb, size_t count) {
         sb->length = 0;
     }// if .. else
 
-    sb->buffer = xrealloc(sb->buffer, sb->length + 1);
     sb->buffer[sb->length] = 0;
 }// sb_drop
 
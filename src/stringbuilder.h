@@ -7,22 +7,33 @@
 // or removing characters from the end.
 //
 // Length may not exceed LONG_MAX.
+//
+// The buffer grows geometrically, so appending is amortized O(1).
+// Short-lived builders can avoid the heap entirely by living on the
+// stack and starting out in caller-provided storage (see
+// sb_init_external()); they only allocate if they outgrow it.
 
 
 #include <stdlib.h>
+#include <stdbool.h>
 
 
 struct StringBuilder {
     // Private:
     char *buffer;
     size_t length;
+    size_t capacity;    // Bytes available in 'buffer', including the null
+    bool external;      // 'buffer' belongs to the caller; don't free it
 };
 
 
 struct StringBuilder *sb_alloc(void);
 void sb_free(struct StringBuilder *sb);
+void sb_init_external(struct StringBuilder *sb, char *storage, size_t size);
+void sb_release(struct StringBuilder *sb);
 void sb_append(struct StringBuilder *sb, const char *text);
 void sb_append_char(struct StringBuilder *sb, char c);
+void sb_appendf(struct StringBuilder *sb, const char *fmt, ...);
 char *sb_str_and_free(struct StringBuilder *sb);
 void sb_reset(struct StringBuilder *sb);
 void sb_drop(struct StringBuilder *sb, size_t count);
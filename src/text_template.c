@@ -3,6 +3,7 @@
 
 #include "text_template.h"
 
+#include "arena.h"
 #include "game.h"
 #include "constants.h"
 #include "stringbuilder.h"
@@ -14,10 +15,21 @@ static void append_expansion(struct StringBuilder *result,
                              const char *keyword);
 
 
+// Return 'template' with the ${keyword} fields filled in for 'pl'.
+// The result is allocated from the arena (see arena.h), so it lasts
+// until the end of the current command and mustn't be freed.
 char *
 text_expand(char *template, const struct Player *pl) {
-    struct StringBuilder *result = sb_alloc();
-    struct StringBuilder *keyword = sb_alloc();
+    // The text is built on the stack (unless it's unusually long) and
+    // then copied to the arena, which can't grow a block in place.
+    char resbuf[1024];
+    struct StringBuilder ressb, *result = &ressb;
+    sb_init_external(result, resbuf, sizeof(resbuf));
+
+    // Keywords are short so this should never touch the heap.
+    char kwbuf[32];
+    struct StringBuilder kwsb, *keyword = &kwsb;
+    sb_init_external(keyword, kwbuf, sizeof(kwbuf));
 
     for (size_t n = 0; template[n]; n++) {
 
@@ -49,16 +61,18 @@ text_expand(char *template, const struct Player *pl) {
         append_expansion(result, pl, sb_str(keyword));
     }// for
 
-    sb_free(keyword);
+    sb_release(keyword);
 
-    return sb_str_and_free(result);
+    char *text = arena_strdup(sb_str(result));
+    sb_release(result);
+    return text;
 }// text_expand
 
 
 // Format a number as an amount of gold pieces
 const char *
 gold_gp(long amount) {
-    static char text[40];
+    static __thread char text[40];
     snprintf(text, sizeof(text), "%ld gold piece%s", amount,
              amount == 1 ? "" : "s");
     return text;
@@ -83,12 +97,7 @@ append_expansion(struct StringBuilder *result, const struct Player *pl,
         sb_append(result, "@geemail.com.ln");
     }
     else if (streq("score", keyword)) {
-        long score = compute_score(true);
-
-        char buffer[20];
-        snprintf(buffer, sizeof(buffer), "%ld", score);
-
-        sb_append(result, buffer);
+        sb_appendf(result, "%ld", compute_score(true));
     }
     else if (streq("taxes_owed_gp", keyword)) {
         sb_append(result, gold_gp(compute_taxes_owed(pl)));
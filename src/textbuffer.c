@@ -8,11 +8,19 @@
 #include "textbuffer.h"
 
 static void splitAndAppend(struct TextBuffer *tb, const char *line);
-static void scrollBuffer (struct TextBuffer *tb);
-static void appendSegment (struct TextBuffer *tb, char *line);
-static char shortenLine (int width, char *ptr);
+static void appendSegment (struct TextBuffer *tb, char *line, int len);
+static char shortenLine (int width, char *ptr, int *len);
 static char *mk_lastline(struct TextBuffer *tb, const char *line);
-static char *dropLast(struct TextBuffer *tb);
+static const char *dropLast(struct TextBuffer *tb);
+
+// Initial number of slots in an INF_BUFFER TextBuffer.
+#define INITIAL_UNBOUNDED_SLOTS 32
+
+// Return a writable pointer to the slot holding line 'index'.
+static inline char *
+slot(struct TextBuffer *tb, int index) {
+    return (char *)tb_getline(tb, index);
+}// slot
 
 
 
@@ -28,13 +36,20 @@ tb_malloc(int length, int linewidth) {
 
     result = xmalloc (sizeof(struct TextBuffer));
 
-    result->text = NULL;
+    result->capacity = length < 0 ? INITIAL_UNBOUNDED_SLOTS : max(length, 1);
+    result->slot_size = linewidth + 1;
+    result->slots = xmalloc(result->capacity * result->slot_size);
+    result->first = 0;
+
     result->num_lines = 0;
     result->total_lines = 0;
     result->newline = true;
     result->max_lines = length;
     result->max_width = linewidth;
 
+    result->work = NULL;
+    result->work_size = 0;
+
     return result;
 }/* tb_malloc*/
 
@@ -42,18 +57,12 @@ tb_malloc(int length, int linewidth) {
 /* Delete a TextBuffer and anything it points to. */
 void
 tb_free(struct TextBuffer *tb) {
-    int n;
-
     if (!tb) {
         return;
     }/* if */
 
-    for (n = 0; n < tb->num_lines; n++) {
-        free(tb->text[n]);
-    }/* for */
-
-    free (tb->text);
-
+    free(tb->slots);
+    free(tb->work);
     free(tb);
 }/* tb_free*/
 
@@ -66,7 +75,6 @@ tb_append(struct TextBuffer *tb, const char *line) {
     if (!*line) return;
 
     splitAndAppend (tb, line);
-    scrollBuffer(tb);
 }/* tb_append*/
 
 /* Like tb_append() but also ends the last line. */
@@ -103,44 +111,56 @@ tb_getlastn(struct TextBuffer *tb, int index, int scrollback, int windowSize) {
     // Find the index of the bottom-most item to display
     int bottom = max(windowSize, tb->num_lines - scrollback);
 
-    // Find the actual index in tb->text corresponding to index and
+    // Find the actual index of the line corresponding to index and
     // scrollback.
     int real_index = index + (bottom - windowSize);
     if (real_index >= tb->num_lines) { return ""; }
     ASSERT(real_index >= 0);
 
     // Aaaaaaand, return the line
-    return tb->text[real_index];
+    return tb_getline(tb, real_index);
 }/* tb_getlastn*/
 
 
+/* Return the position of the line that tb_getlastn() would return at
+ * index 0 for these arguments.  The position is counted from the
+ * first line ever appended to 'tb' (i.e. it is not affected by old
+ * lines scrolling off the start of the buffer) so the result can be
+ * used to tell how far a window showing the buffer has moved. */
+int
+tb_lastn_start(struct TextBuffer *tb, int scrollback, int windowSize) {
+    scrollback = min(scrollback, tb->num_lines - windowSize);
+    scrollback = max(scrollback, 0);
+
+    int bottom = max(windowSize, tb->num_lines - scrollback);
+
+    return (bottom - windowSize) + (tb->total_lines - tb->num_lines);
+}// tb_lastn_start
+
+
 /* Append 'line' to 'tb', splitting it into multiple lines if it is
  * too long for a single line. */
 static void
 splitAndAppend(struct TextBuffer *tb, const char *line) {
-    char *linedup;
     char *ptr;
     char savedChar;
-    int maxlen;
+    int len;
 
     ASSERT(*line);
 
-    maxlen = tb->max_width;
-
-    linedup = mk_lastline(tb, line);
-    ptr = linedup;
+    ptr = mk_lastline(tb, line);
     while (1) {
         /* Null-terminate the end of the line at ptr. */
-        savedChar = shortenLine(maxlen, ptr);
+        savedChar = shortenLine(tb->max_width, ptr, &len);
 
         /* Append the current line (ptr to the null) to the buffer. */
-        appendSegment(tb, ptr);
+        appendSegment(tb, ptr, len);
 
         /* Advance ptr to the start of the following line. */
-        ptr += strlen (ptr) + 1;
+        ptr += len + 1;
 
-        /* If it's empty, we've hit the extra null added above and
-         * we're done. */
+        /* If it's empty, we've hit the extra null added by
+         * mk_lastline() and we're done. */
         if (!*ptr) {
             break;
         }/* if */
@@ -153,19 +173,17 @@ splitAndAppend(struct TextBuffer *tb, const char *line) {
             *ptr = savedChar;
         }/* if */
     }/* while */
-
-    free (linedup);
 }/* splitAndAppend*/
 
 
-/* Make a working copy of 'line' with an extra null at the end.  If
- * this is to be appended to the last line, first pull off that line
- * and prepend it to the copy.  Also, set tb->newline to true if line
- * ends with a newline.*/
+/* Make a working copy of 'line' with an extra null at the end in
+ * tb->work.  If this is to be appended to the last line, first pull
+ * off that line and prepend it to the copy.  Also, set tb->newline to
+ * true if line ends with a newline.*/
 static char *
 mk_lastline(struct TextBuffer *tb, const char *line) {
-    int llen;
-    char *linedup = NULL, *lastline = NULL;
+    size_t llen, lastlen = 0;
+    const char *lastline = NULL;
     bool setNewline = false;
 
     llen = strlen(line);
@@ -173,38 +191,42 @@ mk_lastline(struct TextBuffer *tb, const char *line) {
 
     if (!tb->newline) {
         lastline = dropLast(tb);
-        llen += strlen(lastline);
+        lastlen = lastline ? strlen(lastline) : 0;
     }/* if */
 
-    linedup = xmalloc (llen + 2);
-    linedup[0] = 0;
-
-    if (!tb->newline) {
-        strcpy(linedup, lastline);
-        free(lastline);
+    /* Grow the scratch buffer if needed.  (The dropped line's slot is
+     * untouched until the next append so it's still safe to read.) */
+    size_t needed = lastlen + llen + 2;
+    if (needed > tb->work_size) {
+        tb->work_size = 2 * tb->work_size;
+        if (tb->work_size < needed) { tb->work_size = needed; }
+        tb->work = xrealloc(tb->work, tb->work_size);
     }/* if */
 
-    strcat (linedup, line);
-    linedup[llen + 1] = 0;  /* Extra trailing null. */
+    if (lastlen) {
+        memcpy(tb->work, lastline, lastlen);
+    }/* if */
+    memcpy(tb->work + lastlen, line, llen);
+    tb->work[lastlen + llen] = 0;
+    tb->work[lastlen + llen + 1] = 0;  /* Extra trailing null. */
 
     /* Store the EOL-ness of the current line in tb->newline. */
     tb->newline = setNewline;
 
-    return linedup;
+    return tb->work;
 }/* mk_lastline*/
 
 
 
 /* Insert a null into the string at 'ptr' to make it shorter than
  * 'width' and return the character that was overwritten.  Tries to
- * split on whitespacebut. */
+ * split on whitespacebut.  The length of the resulting string is
+ * stored in '*len'. */
 static char
-shortenLine (int width, char *ptr) {
-    int end, plen;
+shortenLine (int width, char *ptr, int *len) {
+    int end;
     char replaced;
 
-    plen = strlen(ptr);
-
     /* Walk forward until we either exceed 'width' or find a
      * newline. */
     for (end = 0; end < width; end++) {
@@ -215,7 +237,8 @@ shortenLine (int width, char *ptr) {
 
     /* If ptr is shorter than width and there are no newlines, we're
      * done. */
-    if (end == plen) {
+    if (!ptr[end]) {
+        *len = end;
         return 0;
     }/* if */
 
@@ -226,6 +249,7 @@ shortenLine (int width, char *ptr) {
         if (isspace(ptr[end])) {
             replaced = ptr[end];
             ptr[end] = 0;
+            *len = end;
             return replaced;
         }/* if */
 
@@ -235,92 +259,76 @@ shortenLine (int width, char *ptr) {
      * blank, so we just insert the null at the last character. */
     replaced = ptr[width - 1];
     ptr[width - 1] = 0;
+    *len = width - 1;
 
     return replaced;
 }/* shortenLine */
 
 
-/* Append 'line' to the list of lines. */
+/* Append 'line' (of length 'len') to the list of lines, reusing the
+ * oldest line's slot if the buffer is full and bounded. */
 static void
-appendSegment (struct TextBuffer *tb, char *line) {
+appendSegment (struct TextBuffer *tb, char *line, int len) {
     int n;
-    char *linecopy;
 
     /* Normalize all whitespace, except for the \f used to mark a page
      * end. */
-    for (n = 0; line[n]; n++) {
+    for (n = 0; n < len; n++) {
         if (isspace(line[n]) && (line[n] != '\f' && n != 0)) {
             line[n] = ' ';
         }/* if */
     }/* for */
 
-
-    linecopy = xstrdup(line);
+    if (tb->num_lines == tb->capacity) {
+        if (tb->max_lines < 0) {
+            /* Unbounded buffers never wrap, so the lines are already
+             * in order from the start of the block. */
+            ASSERT(tb->first == 0);
+            tb->capacity *= 2;
+            tb->slots = xrealloc(tb->slots, tb->capacity * tb->slot_size);
+        } else {
+            tb->first = (tb->first + 1) % tb->capacity;
+            --tb->num_lines;
+        }/* if .. else*/
+    }/* if */
 
     ++tb->num_lines;
-    tb->text = xrealloc(tb->text, tb->num_lines * sizeof(char **));
-
     ++tb->total_lines;
 
-    tb->text[tb->num_lines - 1] = linecopy;
+    len = min(len, tb->max_width);
+    char *dest = slot(tb, tb->num_lines - 1);
+    memcpy(dest, line, len);
+    dest[len] = 0;
 }/* appendSegment */
 
-/* Unreference the last line from 'tb' and return a pointer to it. */
-static char *
+/* Remove the last line from 'tb' and return a pointer to it.  The
+ * result remains valid until the next line is appended. */
+static const char *
 dropLast(struct TextBuffer *tb) {
-    char *last;
+    const char *last;
 
     if (tb->num_lines <= 0) return NULL;
 
-    last = tb->text[tb->num_lines - 1];
+    last = tb_getline(tb, tb->num_lines - 1);
     --tb->num_lines;
     --tb->total_lines;
 
-    /* We don't resize tb->text here; appendSegment can do that. */
-
     return last;
 }/* dropLast*/
 
 
-/* Remove lines from the start of the buffer until there are no more
- * than tb->max_lines lines in it. */
-static void
-scrollBuffer (struct TextBuffer *tb) {
-    int scrollAmt, n;
-
-    scrollAmt = tb->num_lines - tb->max_lines;
-
-    if (tb->max_lines < 0 || scrollAmt <= 0) {
-        return;
-    }/* if */
-
-    for (n = 0; n < scrollAmt; n++) {
-        free (tb->text[n]);
-    }/* for */
-
-    for (n = scrollAmt; n < tb->num_lines; n++) {
-        tb->text[n - scrollAmt] = tb->text[n];
-    }/* for */
-
-    /* Adjust num_lines and null-terminate tb->text */
-    tb->num_lines -= scrollAmt;
-    tb->text[tb->num_lines] = NULL;
-}// scrollBuffer
-
 // Reposition all lines so that they're centered.
 void
 tb_center_all(struct TextBuffer *tb) {
     for (int n = 0; n < tb->num_lines; n++) {
-        size_t len = strlen(tb->text[n]);
+        char *line = slot(tb, n);
+        int len = strlen(line);
 
         if (len >= tb->max_width - 1) { continue; }
 
-        char *line = xmalloc(tb->max_width + 1);
-        snprintf(line, tb->max_width + 1, "%*s%s",
-                 (tb->max_width - (int)len)/2, "",
-                 tb->text[n]);
-        free(tb->text[n]);
-        tb->text[n] = line;
+        int pad = (tb->max_width - len)/2;
+        memmove(line + pad, line, len + 1);
+        memset(line, ' ', pad);
     }// for
 }// tb_center_all
 
@@ -331,7 +339,7 @@ void
 tb_backspace_last_line(struct TextBuffer *tb) {
     if (!tb->num_lines) { return; }
 
-    char *last = tb->text[tb->num_lines - 1];
+    char *last = slot(tb, tb->num_lines - 1);
     size_t llen = strlen(last);
     if (llen > 0) {
         last[llen - 1] = 0;
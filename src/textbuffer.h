@@ -20,17 +20,30 @@
 #define HDR_GUARD_TEXTBUFFER_H
 
 #include <stdbool.h>
+#include <stddef.h>
 
 #define INF_BUFFER (-1)
 
+// Lines are stored in fixed-size slots (max_width + 1 bytes each) in
+// a single block of memory that is used as a ring buffer: once a
+// bounded buffer is full, appending overwrites the oldest line.
+// Unbounded (INF_BUFFER) buffers double the block when full instead.
+// Either way, appending text doesn't normally touch the heap.
 struct TextBuffer {
-    char **text;        /* Text lines, NULL-terminated array of strings */
-    int num_lines;      /* Number of lines in 'text'. */
+    char *slots;        /* Line storage: 'capacity' slots of 'slot_size'. */
+    int capacity;       /* Number of slots in 'slots'. */
+    int slot_size;      /* Bytes per slot (max_width + 1). */
+    int first;          /* Slot holding line 0. */
+
+    int num_lines;      /* Number of lines in the buffer. */
     int total_lines;    /* Total num. lines appended */
     bool newline;       /* Next append starts a new line. */
 
-    int max_lines;      /* Max. lines in 'text' or -1 for unlimited. */
-    int max_width;      /* Max. num. chars in a line in 'text'. */
+    int max_lines;      /* Max. lines kept or -1 for unlimited. */
+    int max_width;      /* Max. num. chars in a line. */
+
+    char *work;         /* Scratch space for splitting appended text. */
+    size_t work_size;   /* Size of 'work'. */
 };
 
 struct TextBuffer *tb_malloc(int length, int linewidth);
@@ -38,11 +51,15 @@ void tb_free(struct TextBuffer *tb);
 void tb_appendline(struct TextBuffer *tb, const char *line);
 void tb_append(struct TextBuffer *tb, const char *line);
 const char *tb_getlastn(struct TextBuffer *tb, int index, int scrollback, int windowSize);
+int tb_lastn_start(struct TextBuffer *tb, int scrollback, int windowSize);
 void tb_center_all(struct TextBuffer *tb);
 void tb_backspace_last_line(struct TextBuffer *tb);
 
 
 static inline int tb_num_lines(struct TextBuffer *tb) { return tb->num_lines; }
+static inline const char *tb_getline(struct TextBuffer *tb, int index) {
+    return tb->slots + ((tb->first + index) % tb->capacity) * tb->slot_size;
+}
 static inline int tb_total_lines(struct TextBuffer *tb) {
     return tb->total_lines;
 }
@@ -0,0 +1,123 @@
+// This file is part of ReLarn; Copyright (C) 1986 - 2023; GPLv2; NO WARRANTY!
+// See Copyright.txt, LICENSE.txt and AUTHORS.txt for terms.
+
+#include "trace.h"
+
+#include "util.h"
+#include "internal_assert.h"
+
+#include <stdio.h>
+#include <stdint.h>
+
+
+// The buffer is written out once there's less than MAX_EVENT bytes
+// left in it.
+#define TRACE_BUFSIZE (256 * 1024)
+#define MAX_EVENT 200
+
+__thread bool TraceActive = false;
+
+static FILE *TraceFile = NULL;
+static char *Buffer = NULL;
+static size_t BufLen = 0;
+static uint64_t StartTime = 0;
+static bool FirstEvent = true;
+static bool InTurn = false;
+static int OpenSpans = 0;
+
+
+static void
+flush_buffer() {
+    if (BufLen > 0 && fwrite(Buffer, 1, BufLen, TraceFile) != BufLen) {
+        // Not worth stopping the game over; just quit tracing.
+        TraceActive = false;
+    }
+    BufLen = 0;
+}// flush_buffer
+
+
+// Append one event to the buffer.  'fmt' is the body of the JSON
+// object after the common fields.
+static void
+emit(const char *name, char phase, const char *fmt, long value) {
+    if (TRACE_BUFSIZE - BufLen < MAX_EVENT) { flush_buffer(); }
+
+    char *dest = Buffer + BufLen;
+    int len = snprintf(dest, MAX_EVENT,
+                       "%s{\"name\":\"%s\",\"ph\":\"%c\",\"ts\":%llu,"
+                       "\"pid\":1,\"tid\":1",
+                       FirstEvent ? "" : ",\n", name, phase,
+                       (unsigned long long)(monotonic_usec() - StartTime));
+    len += snprintf(dest + len, MAX_EVENT - len, fmt, value);
+    ENSURE_MSG(len < MAX_EVENT, "Trace event is too long.");
+
+    BufLen += len;
+    FirstEvent = false;
+
+    if (phase == 'B') { ++OpenSpans; }
+    if (phase == 'E' && OpenSpans > 0) { --OpenSpans; }
+}// emit
+
+
+void
+trace_event(char phase, const char *name) {
+    emit(name, phase, "}", 0);
+}// trace_event
+
+
+void
+trace_counter_event(const char *name, long value) {
+    emit(name, 'C', ",\"args\":{\"value\":%ld}}", value);
+}// trace_counter_event
+
+
+// Start tracing to 'path'.  Returns false if the file can't be
+// created.
+bool
+trace_start(const char *path) {
+    ASSERT(!TraceActive);
+
+    TraceFile = fopen(path, "w");
+    if (!TraceFile) { return false; }
+
+    Buffer = xmalloc(TRACE_BUFSIZE);
+    StartTime = monotonic_usec();
+    TraceActive = true;
+
+    fputs("[\n", TraceFile);
+    emit("process_name", 'M', ",\"args\":{\"name\":\"relarn\"}}", 0);
+
+    return true;
+}// trace_start
+
+
+// Write out everything and close the file.  Registered with atexit()
+// so this may be called during a crash-ish exit.
+void
+trace_stop() {
+    if (!TraceFile) { return; }
+
+    // We're probably exiting from inside a turn, so close whatever
+    // spans are still open.
+    while (TraceActive && OpenSpans > 0) { trace_event('E', "exit"); }
+    flush_buffer();
+    fputs("\n]\n", TraceFile);
+    fclose(TraceFile);
+
+    free(Buffer);
+    Buffer = NULL;
+    TraceFile = NULL;
+    TraceActive = false;
+}// trace_stop
+
+
+// Close the span of the previous turn and open a new one.
+void
+trace_next_turn(int level) {
+    if (!TraceActive) { return; }
+
+    if (InTurn) { trace_event('E', "turn"); }
+    trace_counter_event("level", level);
+    trace_event('B', "turn");
+    InTurn = true;
+}// trace_next_turn
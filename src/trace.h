@@ -0,0 +1,48 @@
+// This file is part of ReLarn; Copyright (C) 1986 - 2023; GPLv2; NO WARRANTY!
+// See Copyright.txt, LICENSE.txt and AUTHORS.txt for terms.
+
+// Session tracing.
+//
+// If enabled (via the 'trace-file' option or '-t'), we record
+// begin/end spans and counters for the interesting parts of the game
+// (the phases of each turn, saving, level creation, spell animations,
+// screen updates and waiting for input) as Chrome trace-event JSON.
+// The result can be loaded into chrome://tracing or Perfetto to find
+// individual slow turns.
+//
+// Events are collected in a large memory buffer and written out
+// when it fills up and at exit.  When tracing is off, each hook is
+// just a test of TraceActive.
+//
+// Span names must be string constants without quotes or
+// backslashes; they're written to the file as-is.
+//
+// Only the thread that started tracing records anything; the hooks do
+// nothing in other threads (e.g. levels being built in the
+// background, see pregen.h), so they're safe to call from anywhere.
+
+#ifndef HDR_GUARD_TRACE_H
+#define HDR_GUARD_TRACE_H
+
+#include <stdbool.h>
+
+extern __thread bool TraceActive;     // Tracing and this is its thread
+
+bool trace_start(const char *path);
+void trace_stop(void);
+void trace_next_turn(int level);
+
+void trace_event(char phase, const char *name);
+void trace_counter_event(const char *name, long value);
+
+static inline void trace_begin(const char *name) {
+    if (TraceActive) { trace_event('B', name); }
+}
+static inline void trace_end(const char *name) {
+    if (TraceActive) { trace_event('E', name); }
+}
+static inline void trace_counter(const char *name, long value) {
+    if (TraceActive) { trace_counter_event(name, value); }
+}
+
+#endif
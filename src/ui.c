@@ -7,6 +7,9 @@
 #include "settings.h"
 #include "version_info.h"
 #include "player.h"
+#include "profile.h"
+#include "trace.h"
+#include "arena.h"
 
 #include "ui.h"
 
@@ -47,6 +50,14 @@ static void backspace(void);
 static struct TextBuffer *ConsoleBuffer = NULL;
 static int ScrollbackPos = 0;
 
+// What ConsoleWin is currently showing: the position (as returned
+// by tb_lastn_start()) of the buffer line in the top row and a copy
+// of the text in each row.  ConsoleTop is negative if the window
+// contents are unknown (e.g. before the first update).
+static int ConsoleTop = -1;
+static char ConsoleRows[CONSOLE_H][SCREEN_W + 1];
+
+
 static WINDOW *ConsoleWin = NULL;
 static WINDOW *IndWin = NULL;
 static WINDOW *MapWin = NULL;
@@ -61,6 +72,45 @@ static const int IndHeight = MAXY;
 static const short StatsY = MAXY;
 static const short StatsHeight = 2;
 
+// Render statistics.  These count what the display code does to the
+// terminal so that we can measure the effect of drawing
+// optimizations (e.g. on ssh traffic) instead of guessing.  'Render'
+// accumulates the current turn; 'LastRender' holds the previous one.
+struct RenderStats {
+    long cells_drawn;       // Calls to mapdraw()
+    long cells_changed;     // ...that actually changed the map window
+    long updates;           // Calls to doupdate()
+    long tty_bytes;         // Bytes sent to the terminal; -1 if unknown
+    uint64_t curses_usec;   // Time spent pushing updates to the screen
+};
+static struct RenderStats Render, LastRender;
+static long TtyBytesAtTurnStart = 0;
+static FILE *RenderStatsFile = NULL;
+
+static bool ShowRenderOverlay = false;
+static WINDOW *RenderOverlayWin = NULL;
+static const int RenderOverlayWidth = 52;
+
+// Are the render statistics being logged or shown?
+static inline bool
+render_stats_wanted() {
+    return ShowRenderOverlay || GameSettings.renderStatsFile[0];
+}// render_stats_wanted
+
+
+// Read a key from 'win'.  All keyboard input goes through here so
+// that the turn profiler can leave out the time spent waiting for
+// the player.
+static int
+wait_key(WINDOW *win) {
+    prof_pause();
+    trace_begin("input");
+    int key = wgetch(win);
+    trace_end("input");
+    prof_resume();
+    return key;
+}// wait_key
+
 
 // Normalize the keycode corresponding to the ENTER key.  That is,
 // Replace any of the three(?) keycodes that can be interpreted as a
@@ -168,8 +218,9 @@ init_ui() {
     }/* if */
 
     ConsoleWin = newwin(CONSOLE_H, SCREEN_W, CONSOLE_Y, 0);
-    scrollok(ConsoleWin, true);
+    scrollok(ConsoleWin, false);    // See scroll_console()
     idlok(ConsoleWin, true);
+    ConsoleTop = -1;
 
     StatsWin = newwin(StatsHeight, SCREEN_W, StatsY, 0);
     IndWin = newwin(IndHeight, IndWidth, 0, MapWidth);
@@ -185,11 +236,21 @@ init_ui() {
 void
 teardown_ui() {
 
+    if (RenderStatsFile) {
+        fclose(RenderStatsFile);
+        RenderStatsFile = NULL;
+    }// if
+
     // Tolerate calling this multiple times.
     if (!ConsoleWin || !IndWidth || !MapWin || !StatsWin) {
         return;
     }// if
 
+    if (RenderOverlayWin) {
+        delwin(RenderOverlayWin);
+        RenderOverlayWin = NULL;
+    }// if
+
     delwin(ConsoleWin);
     delwin(IndWin);
     delwin(MapWin);
@@ -203,10 +264,111 @@ teardown_ui() {
     endwin();
 }/* teardown_ui*/
 
+// Draw the render statistics for the previous turn over the top
+// right corner of the map if requested (and in wizard mode);
+// otherwise, remove the overlay if it's present.
+static void
+draw_render_overlay() {
+    bool show = ShowRenderOverlay && UU.wizardMode;
+
+    if (!show) {
+        if (RenderOverlayWin) {
+            delwin(RenderOverlayWin);
+            RenderOverlayWin = NULL;
+            touchwin(MapWin);       // Restore what was underneath
+            wnoutrefresh(MapWin);
+        }// if
+        return;
+    }// if
+
+    if (!RenderOverlayWin) {
+        RenderOverlayWin = newwin(1, RenderOverlayWidth, 0,
+                                  MapWidth - RenderOverlayWidth);
+        ENSURE_MSG(RenderOverlayWin, "Error creating curses window.");
+        wattrset(RenderOverlayWin, A_REVERSE);
+    }// if
+
+    char bytes[20];
+    if (LastRender.tty_bytes >= 0) {
+        snprintf(bytes, sizeof(bytes), "%ldB", LastRender.tty_bytes);
+    } else {
+        snprintf(bytes, sizeof(bytes), "?B");
+    }
+
+    mvwprintw(RenderOverlayWin, 0, 0, "%-*.*s",
+              RenderOverlayWidth, RenderOverlayWidth, "");
+    mvwprintw(RenderOverlayWin, 0, 0,
+              " drw %4ld chg %4ld upd %2ld tty %-7s %5.1fms",
+              LastRender.cells_drawn, LastRender.cells_changed,
+              LastRender.updates, bytes,
+              (double)LastRender.curses_usec / 1000.0);
+
+    // The map may have been copied over us so we always redo it.
+    touchwin(RenderOverlayWin);
+    wnoutrefresh(RenderOverlayWin);
+}// draw_render_overlay
+
+
+// Toggle the render statistics overlay (only visible in wizard mode)
+// and return its new state.
+bool
+toggle_render_overlay() {
+    ShowRenderOverlay = !ShowRenderOverlay;
+    return ShowRenderOverlay;
+}// toggle_render_overlay
+
+
+// Append 'stats' for 'turn' to the render statistics file if one was
+// requested.  The file is opened on first use.
+static void
+write_render_stats(long turn, const struct RenderStats *stats) {
+    if (!GameSettings.renderStatsFile[0]) { return; }
+
+    if (!RenderStatsFile) {
+        RenderStatsFile = fopen(GameSettings.renderStatsFile, "a");
+        if (!RenderStatsFile) {
+            say("Unable to open '%s'; render stats disabled.\n",
+                GameSettings.renderStatsFile);
+            GameSettings.renderStatsFile[0] = 0;
+            return;
+        }// if
+
+        // Print a header if this is a new file
+        if (ftell(RenderStatsFile) == 0) {
+            fprintf(RenderStatsFile, "turn,cells_drawn,cells_changed,"
+                    "updates,tty_bytes,curses_usec\n");
+        }// if
+    }// if
+
+    fprintf(RenderStatsFile, "%ld,%ld,%ld,%ld,%ld,%llu\n",
+            turn, stats->cells_drawn, stats->cells_changed, stats->updates,
+            stats->tty_bytes, (unsigned long long)stats->curses_usec);
+    fflush(RenderStatsFile);
+}// write_render_stats
+
+
+// Close out the render statistics for the turn that just ended,
+// logging them if enabled and keeping them for the overlay.
+void
+render_stats_end_turn(long turn) {
+    long bytes = tty_bytes_written();
+    Render.tty_bytes = bytes >= 0 ? bytes - TtyBytesAtTurnStart : -1;
+    TtyBytesAtTurnStart = bytes;
+
+    write_render_stats(turn, &Render);
+    trace_counter("cells_changed", Render.cells_changed);
+    if (Render.tty_bytes >= 0) { trace_counter("tty_bytes", Render.tty_bytes); }
+
+    LastRender = Render;
+    memset(&Render, 0, sizeof(Render));
+}// render_stats_end_turn
+
+
 /* If the UI delays displaying results, it should update now.  If
  * 'force' is true, redraw everything. */
 void
 sync_ui(bool force) {
+    uint64_t start = monotonic_usec();
 
     if (force) {
         redrawwin(ConsoleWin);
@@ -222,27 +384,67 @@ sync_ui(bool force) {
     wnoutrefresh(MapWin);
     wnoutrefresh(StatsWin);
 
+    draw_render_overlay();
+
+    trace_begin("doupdate");
     doupdate();
+    trace_end("doupdate");
+
+    ++Render.updates;
+    Render.curses_usec += monotonic_usec() - start;
 }/* sync_ui*/
 
 
-// Write out a line of text to the StatsWin window.  If '^' is
-// encountered, modify the text (either bold or reverse) until '|' is
-// found.  This is used to hilight changed stats on the display.
+// The cells currently displayed in StatsWin, minus any debugging
+// colours.  We keep this so that we can redraw only those cells that
+// have actually changed.
+static chtype StatsCells[2][SCREEN_W];
+
+// Write out a line of text to row 'y' of the StatsWin window.  If '^'
+// is encountered, modify the text (either bold or reverse) until '|'
+// is found.  This is used to hilight changed stats on the display.
+//
+// Only cells that differ from the previous contents of StatsCells
+// are drawn unless 'force' is true.
 static void
-write_stats_line(const char *line) {
+write_stats_line(int y, const char *line, bool force) {
+    ASSERT(y >= 0 && y < 2);
+
+    chtype cells[SCREEN_W];
     chtype mod = 0;
-    for (int n = 0; line[n]; n++) {
+    int len = 0;
+    for (int n = 0; line[n] && len < SCREEN_W; n++) {
         chtype c = line[n];
         if (c == '^') {
             mod = GameSettings.hilightReverse ? A_REVERSE : A_BOLD;
         } else if (c == '|') {
             mod = 0;
         } else {
-            waddch(StatsWin, c | mod);
+            cells[len++] = c | mod;
         }
     }
-}
+
+    // Blank out whatever's left over from a previous (longer) line.
+    for (; len < SCREEN_W; len++) {
+        cells[len] = ' ';
+    }
+
+    // And draw the changes, moving the cursor only at gaps.
+    bool contiguous = false;
+    for (int x = 0; x < SCREEN_W; x++) {
+        if (!force && cells[x] == StatsCells[y][x]) {
+            contiguous = false;
+            continue;
+        }
+
+        if (!contiguous) {
+            wmove(StatsWin, y, x);
+            contiguous = true;
+        }
+        waddch(StatsWin, cells[x]);
+        StatsCells[y][x] = cells[x];
+    }// for
+}// write_stats_line
 
 
 struct StatDisp {
@@ -251,91 +453,141 @@ struct StatDisp {
 };
 
 // Return '^' or '|' (hilight or don't highlight) depending on whether
-// the item in `stati[*ndx]` is different from `value` or has changed
+// the item in `stati[ndx]` is different from `value` or has changed
 // in the last few seconds.  (This is used to highlight changed
 // stats.)
 static char
-hl(struct StatDisp stati[], size_t *ndx, long value, bool disable) {
-    time_t now = time(NULL);
-
-    if (value != stati[*ndx].value) {
-        stati[*ndx].age = GameSettings.hilightTime + now;
-        stati[*ndx].value = value;
+hl(struct StatDisp stati[], size_t ndx, long value, bool disable, time_t now) {
+    if (value != stati[ndx].value) {
+        stati[ndx].age = GameSettings.hilightTime + now;
+        stati[ndx].value = value;
     }
 
     if (disable) {
-        stati[*ndx].age = 0;
+        stati[ndx].age = 0;
     }
 
-    char result =  stati[*ndx].age > now ? '^' : '|';
-    ++*ndx;
-    return result;
+    return stati[ndx].age > now ? '^' : '|';
 }// hl
 
+
+// Stats that can be highlighted, in order of the 'hlval' and 'hl'
+// arrays below.
+enum HLSTAT {
+    HL_SPELLMAX, HL_AC, HL_WC, HL_LEVEL, HL_HPMAX,
+    HL_STR, HL_INT, HL_WIS, HL_CON, HL_DEX, HL_CHA,
+
+    HL_COUNT
+};
+
+// Everything that shows up in StatsWin.  showstats() keeps the last
+// one it drew so that it can skip the whole thing when nothing has
+// changed.  (Always memset() before filling in so that padding
+// doesn't break memcmp().)
+struct StatsSnapshot {
+    bool iswiz;
+    bool hidefloor;
+    int floor;
+    long spells, time, experience, hp, gold;
+    long hlval[HL_COUNT];
+    char hl[HL_COUNT];
+};
+
 // Display the stats in StatsWin, temporarily highlighting those that
-// changed.
+// changed.  If nothing visible has changed since the last call (and
+// 'force' is false), this makes no curses calls at all.
 void
 showstats(bool iswiz, bool force) {
-    bool hidefloor = !lev()->known;
-
-    static struct StatDisp stati[20];  // oversize
-    size_t n = 0;
+    static struct StatDisp stati[HL_COUNT];
     static bool disable = true;
 
+    static struct StatsSnapshot prev;
+    static bool prev_valid = false;
+
+    struct StatsSnapshot st;
+    memset(&st, 0, sizeof(st));
+
+    st.iswiz = iswiz;
+    st.hidefloor = !lev()->known;
+    st.floor = getlevel();
+    st.spells = UU.spells;
+    st.time = iswiz ? (long)UU.gtime : (long)(UU.gtime / MOBUL);
+    st.experience = UU.experience;
+    st.hp = UU.hp;
+    st.gold = UU.gold;
+
+    st.hlval[HL_SPELLMAX]   = UU.spellmax;
+    st.hlval[HL_AC]         = stat_val(&UU.defense);
+    st.hlval[HL_WC]         = weaponclass();
+    st.hlval[HL_LEVEL]      = UU.level;
+    st.hlval[HL_HPMAX]      = UU.hpmax;
+    st.hlval[HL_STR]        = stat_val(&UU.strength);
+    st.hlval[HL_INT]        = stat_val(&UU.intelligence);
+    st.hlval[HL_WIS]        = stat_val(&UU.wisdom);
+    st.hlval[HL_CON]        = stat_val(&UU.constitution);
+    st.hlval[HL_DEX]        = stat_val(&UU.dexterity);
+    st.hlval[HL_CHA]        = stat_val(&UU.charisma);
+
+    time_t now = time(NULL);
+    for (int n = 0; n < HL_COUNT; n++) {
+        st.hl[n] = hl(stati, n, st.hlval[n], disable, now);
+    }
+    disable = false;
+
+    // Nothing to do if nothing changed.
+    if (!force && prev_valid && memcmp(&st, &prev, sizeof(st)) == 0) {
+        return;
+    }
+    prev = st;
+    prev_valid = true;
+
     // Macro to produce a pair of arguments: the highlight character
     // for the stat to determine whether it should be highlighted
-    // followed by the actual value cast to long.
-#define STATPAIR(s) hl(stati, &n, s, disable), (long)(s)
+    // followed by the value.
+#define STATPAIR(s) st.hl[s], st.hlval[s]
 
     char line1[120];
     snprintf(line1, sizeof(line1),
              "Spells:%3ld(%c%2ld|) AC:%c%-3ld| WC:%c%-3ld| LV:%c%-2ld| %s:%-4ld"
              " Exp: %-9ld %s",
-             (long)UU.spells,
+             st.spells,
 
-             STATPAIR(UU.spellmax),
-             STATPAIR(stat_val(&UU.defense)),
-             STATPAIR(weaponclass()),
-             STATPAIR(UU.level),
+             STATPAIR(HL_SPELLMAX),
+             STATPAIR(HL_AC),
+             STATPAIR(HL_WC),
+             STATPAIR(HL_LEVEL),
 
              iswiz ? "Trns": "Time",
-             iswiz ? (long)UU.gtime : (long)(UU.gtime / MOBUL),
-             (long)UU.experience, levelDesc(UU.level));
+             st.time,
+             st.experience, levelDesc(UU.level));
 
     char buf[20], line2[120];
-    snprintf(buf, sizeof(buf), "%d (%c%ld|)",
-             (int)UU.hp,
-             STATPAIR(UU.hpmax));
+    snprintf(buf, sizeof(buf), "%ld (%c%ld|)",
+             st.hp,
+             STATPAIR(HL_HPMAX));
 
     snprintf(line2, sizeof(line2),
              "HP: %11s STR=%c%-2ld| INT=%c%-2ld| WIS=%c%-2ld| CON=%c%-2ld| "
              "DEX=%c%-2ld| CHA=%c%-2ld| LV:%2s%s Gold: %-8ld",
              buf,
 
-             STATPAIR(stat_val(&UU.strength)),
-             STATPAIR(stat_val(&UU.intelligence)),
-             STATPAIR(stat_val(&UU.wisdom)),
-             STATPAIR(stat_val(&UU.constitution)),
-             STATPAIR(stat_val(&UU.dexterity)),
-             STATPAIR(stat_val(&UU.charisma)),
+             STATPAIR(HL_STR),
+             STATPAIR(HL_INT),
+             STATPAIR(HL_WIS),
+             STATPAIR(HL_CON),
+             STATPAIR(HL_DEX),
+             STATPAIR(HL_CHA),
 
-             hidefloor ? " ?" : getlevelname(),
+             st.hidefloor ? " ?" : getlevelname(),
              iswiz ? " W" : "  ",
-             (long)UU.gold);
+             st.gold);
 
 #undef STATPAIR
 
-    ASSERT(n < sizeof(stati) / sizeof(stati[0]));
-
     debugCycleBackground(StatsWin);
 
-    wmove(StatsWin, 0, 0);
-    write_stats_line(line1);
-
-    wmove(StatsWin, 1, 0);
-    write_stats_line(line2);
-
-    disable = false;
+    write_stats_line(0, line1, force);
+    write_stats_line(1, line2, force);
 }/* showstats*/
 
 
@@ -344,7 +596,7 @@ showstats(bool iswiz, bool force) {
 // translates a few key sequences.
 char
 map_getch() {
-    int key = wgetch(MapWin);
+    int key = wait_key(MapWin);
 
     // Translate arrow keys.
     switch(key) {
@@ -459,6 +711,14 @@ mapdraw(int x, int y, char sym, enum MAPFLAGS flags, bool inFoV, bool isTown) {
         debugCycleBackground(MapWin);
     }
 
+    // Render statistics; we count both attempts and actual changes.
+    // (Checking for a change costs a read from curses, so we only do
+    // it if someone's looking.)
+    ++Render.cells_drawn;
+    if (render_stats_wanted() && mvwinch(MapWin, y, x) != symbol) {
+        ++Render.cells_changed;
+    }
+
     mvwaddch(MapWin, y, x, symbol);
 }/* mapdraw*/
 
@@ -552,16 +812,16 @@ showpages_prompt(struct TextBuffer *tb, bool prompt) {
 
         clear();
         while (currline < tb->num_lines &&
-               *(tb->text[currline]) != '\f' &&
+               *tb_getline(tb, currline) != '\f' &&
                pos < SCREEN_H) {
             wmove (win, pos, 0);
-            addfmt(win, tb->text[currline]);
+            addfmt(win, tb_getline(tb, currline));
             ++pos;
             ++currline;
         }/* while */
 
         /* If we're at a \f line, advance past it. */
-        if (currline < tb->num_lines && *(tb->text[currline]) == '\f') {
+        if (currline < tb->num_lines && *tb_getline(tb, currline) == '\f') {
             ++currline;
         }/* if */
 
@@ -574,7 +834,7 @@ showpages_prompt(struct TextBuffer *tb, bool prompt) {
         for (;;) {
             int i;
 
-            i = norm_return( wgetch(win) );
+            i = norm_return( wait_key(win) );
 
             // If space, advance to next page
             if (i == ' ' && currline < tb->num_lines) { break; }
@@ -628,6 +888,8 @@ menu(const char *heading, const char* items) {
     char **itemLines;
     int num_itemLines;
 
+    // Menus are often shown in a loop, so give back the lines as we go.
+    struct ArenaMark scope = arena_mark();
     itemLines = splitstring(items, &num_itemLines);
 
     pl = pl_malloc();
@@ -661,8 +923,7 @@ menu(const char *heading, const char* items) {
     pick_item(pl, heading, &id);
 
     pl_free(pl);
-    free(itemLines[0]);
-    free(itemLines);
+    arena_release(scope);
 
     return (char)id;
 }/* menu*/
@@ -670,14 +931,14 @@ menu(const char *heading, const char* items) {
 
 static bool *
 mk_sel_vec(struct PickList *pl) {
-    bool *result = xcalloc(pl_count(pl), sizeof(bool));
+    bool *result = arena_calloc(pl_count(pl), sizeof(bool));
     return result;
 }// mk_sel_vec
 
-static int*
-find_sel_ids(struct PickList *pl, bool *selected, int *num_ids) {
-    int *ids = xcalloc(pl_count(pl), sizeof(int));
-
+// Store the IDs of the selected items of 'pl' in 'ids' (which has
+// room for all of them) and return how many there are.
+static int
+find_sel_ids(struct PickList *pl, bool *selected, int *ids) {
     int count = 0;
     for (int n = 0; n < pl_count(pl); n++) {
         if (selected[n]) {
@@ -685,15 +946,15 @@ find_sel_ids(struct PickList *pl, bool *selected, int *num_ids) {
         }// if
     }// for
 
-    *num_ids = count;
-    return ids;
+    return count;
 }// find_sel_indexes
 
 
 // Let the user select multiple items from PickList `pl`.  Returns the
 // number of items selected and a list of indexes stored in *ids
-// (which is NULL if no items were selected.)  If not NULL, the
-// pointer returned in *ids must be freed.
+// (which is NULL if no items were selected.)  The list is allocated
+// from the arena, so it lasts until the end of the current command
+// and mustn't be freed.
 //
 // If 'multi' is false, returns as soon as the first item is selected.
 // This kind of defeats the '_multi' aspect but it's useful as a
@@ -705,6 +966,12 @@ pick_multi (struct PickList *pl, const char *heading, int **ids, bool multi) {
 
     *ids = NULL;
 
+    // The result has to outlive the temporaries below, so it comes
+    // from the arena first.
+    int *found = arena_alloc(max(pl_count(pl), 1) * sizeof(int));
+
+    struct ArenaMark scope = arena_mark();
+
     int headings_sz = 0;
     char **headings = splitstring(heading, &headings_sz);
 
@@ -713,20 +980,10 @@ pick_multi (struct PickList *pl, const char *heading, int **ids, bool multi) {
     bool status = pick_backend(pl, (const char **)headings, headings_sz,
                                selections, multi);
 
-    free(headings[0]);
-    free(headings);
+    int count = status ? find_sel_ids(pl, selections, found) : 0;
+    arena_release(scope);
 
-    if (!status) {
-        free(selections);
-        return 0;
-    }
-
-    int count;
-    *ids = find_sel_ids(pl, selections, &count);
-    if (!count) {
-        free(*ids);
-        *ids = NULL;
-    }
+    if (count) { *ids = found; }
 
     return count;
 }// pick_some
@@ -739,15 +996,16 @@ pick_multi (struct PickList *pl, const char *heading, int **ids, bool multi) {
 bool
 pick_item (struct PickList *pl, const char *heading, int *id) {
 
+    struct ArenaMark scope = arena_mark();
+
     int *ids;
     int count = pick_multi(pl, heading, &ids, false);
     ASSERT(count <= 1 && count >= 0);
-    if (count == 0) { return false; }
+    if (count == 1) { *id = ids[0]; }
 
-    *id = ids[0];
-    free(ids);
+    arena_release(scope);
 
-    return true;
+    return count == 1;
 }/* pick_item */
 
 
@@ -916,13 +1174,13 @@ pick_backend(struct PickList *pl, const char *headings[], int hcount,
 
     while (true) {
         bool selected = false;
-        int key = norm_return( wgetch(parent) );
+        int key = norm_return( wait_key(parent) );
 
         /* Handle literal keys separately. */
         switch(key) {
         case 'j':       key = KEY_DOWN;         break;
         case 'k':       key = KEY_UP;           break;
-        case CTRL_V:    key = wgetch(parent);   break;
+        case CTRL_V:    key = wait_key(parent);   break;
         }
 
         // Now do the action
@@ -1035,7 +1293,7 @@ fullscreen_prompt(const char *prompt, char *result, size_t resultLen) {
         wmove(win, editline_y, left + 1 + end);
 
         curs_set(2);        // show cursor
-        int key = norm_return( wgetch(win) );
+        int key = norm_return( wait_key(win) );
         curs_set(0);        // hide it again
 
         if (key == 12 || key == 18) { // ^R or ^L
@@ -1144,7 +1402,7 @@ static int
 cursor_getch() {
     int key;
     curs_set(2);
-    key = wgetch(ConsoleWin);
+    key = wait_key(ConsoleWin);
     curs_set(0);
 
     return key;
@@ -1303,7 +1561,7 @@ promptToContinue() {
     say("Press ENTER, ESCAPE or SPACE to continue:");
 
     while(true) {
-        char c = norm_return( wgetch(ConsoleWin) );
+        char c = norm_return( wait_key(ConsoleWin) );
 
         if (c == ESC || c == '\n' || c == ' ') {
             return;
@@ -1436,54 +1694,88 @@ billboard(bool center, const char *heading, ...) {
 }/* billboard*/
 
 
-// Redraw the console with last CONSOLE_H lines of ConsoleBuffer and
-// move the cursor to the end of the last non-empty line written. (We
-// do this so that the cursor is in the right place when prompting.)
+// Make row 'row' of ConsoleWin show 'line', drawing only the part
+// after the first character that differs from what's already there.
 static void
-update_msg(bool force_redraw) {
-    static int last_update_line = 0;
+draw_console_row(int row, const char *line) {
+    char *shown = ConsoleRows[row];
 
-    debugCycleBackground(ConsoleWin);
+    int start = 0;
+    while (start < SCREEN_W && line[start] && line[start] == shown[start]) {
+        ++start;
+    }// while
 
-    // If we just need to append one line to the bottom of the buffer
-    // AND it's the start of a new line, we use the scroller and add
-    // just the line.  This is relatively low-hanging fruit when
-    // optimizing for network use.
-    if (!force_redraw &&
-        ScrollbackPos == 0 &&
-        tb_newline(ConsoleBuffer) &&
-        tb_total_lines(ConsoleBuffer) - last_update_line == 1) {
-        int ypos = tb_num_lines(ConsoleBuffer) - 1;
-
-        if (ypos >= CONSOLE_H) {
-            scroll(ConsoleWin);
-            ypos = CONSOLE_H - 1;
-        }
+    if (start >= SCREEN_W || line[start] == shown[start]) { return; }
 
-        const char *line = tb_getlastn(ConsoleBuffer, 0, 0, 1);
-        mvwaddnstr(ConsoleWin, ypos, 0, line, SCREEN_W);
+    size_t oldlen = strlen(shown);
 
-        goto done;
+    zstrncpy(shown, line, SCREEN_W + 1);
+    mvwaddnstr(ConsoleWin, row, start, shown + start, SCREEN_W - start);
+    if (strlen(shown) < oldlen) {
+        wclrtoeol(ConsoleWin);
     }// if
+}// draw_console_row
 
-    // Otherwise, redraw the entire window
-    wclear(ConsoleWin);
+// Move the contents of ConsoleWin (and ConsoleRows) up by 'delta'
+// lines (down if negative).  Exposed rows are left blank.
+static void
+scroll_console(int delta) {
+    const size_t rowsz = sizeof(ConsoleRows[0]);
+    int amount = abs(delta);
+    ASSERT(amount > 0 && amount < CONSOLE_H);
+
+    // The window normally has scrolling disabled so that writing to
+    // the bottom-right corner can't shift things behind our back.
+    scrollok(ConsoleWin, true);
+    wscrl(ConsoleWin, delta);
+    scrollok(ConsoleWin, false);
+
+    if (delta > 0) {
+        memmove(ConsoleRows[0], ConsoleRows[amount], (CONSOLE_H-amount)*rowsz);
+        memset(ConsoleRows[CONSOLE_H - amount], 0, amount * rowsz);
+    } else {
+        memmove(ConsoleRows[amount], ConsoleRows[0], (CONSOLE_H-amount)*rowsz);
+        memset(ConsoleRows[0], 0, amount * rowsz);
+    }// if .. else
+}// scroll_console
+
+// Make the console show the last CONSOLE_H lines of ConsoleBuffer
+// (adjusted for scrollback) and move the cursor to the end of the
+// last non-empty line written. (We do this so that the cursor is in
+// the right place when prompting.)
+//
+// Rather than redrawing the window, we scroll it by however many
+// lines the view has moved and then rewrite only the characters that
+// differ from what's on screen.  In the common cases (appending
+// lines, extending a partial last line, scrolling back by one line),
+// this sends the terminal little more than the new text.
+static void
+update_msg() {
+    debugCycleBackground(ConsoleWin);
+
+    int top = tb_lastn_start(ConsoleBuffer, ScrollbackPos, CONSOLE_H);
+
+    if (ConsoleTop < 0) {
+        scrollok(ConsoleWin, false);
+        wclear(ConsoleWin);
+        memset(ConsoleRows, 0, sizeof(ConsoleRows));
+    } else if (top != ConsoleTop && abs(top - ConsoleTop) < CONSOLE_H) {
+        scroll_console(top - ConsoleTop);
+    }// if .. else
+    ConsoleTop = top;
 
     int lastx = 0, lasty = 0;
     for (int n = 0; n < CONSOLE_H; n++) {
         const char *line = tb_getlastn(ConsoleBuffer,n,ScrollbackPos,CONSOLE_H);
-        mvwaddnstr(ConsoleWin, n, 0, line, SCREEN_W);
+        draw_console_row(n, line);
         if (*line) {
-            lastx = strlen(line);
+            lastx = min(strlen(line), SCREEN_W - 1);
             lasty = n;
         }
     }/* for */
 
     // Move the cursor to the end of the last non-empty line.
     wmove(ConsoleWin, lasty, lastx);
-
-done:
-    last_update_line = tb_total_lines(ConsoleBuffer);
 }/* update_msg*/
 
 
@@ -1497,7 +1789,7 @@ scroll_back() {
     }
 
     ++ScrollbackPos;
-    update_msg(true);
+    update_msg();
 }// scroll_back
 
 void
@@ -1505,7 +1797,7 @@ scroll_forward() {
     if (!ConsoleBuffer || ScrollbackPos <= 0) { return; }
 
     --ScrollbackPos;
-    update_msg(true);
+    update_msg();
 }// scroll_forward
 
 void
@@ -1530,9 +1822,8 @@ say(const char *fmt, ...) {
     // If say() was called before UI initialization, we skip the
     // update.
     if (ConsoleWin) {
-        bool force = (ScrollbackPos != 0);
         ScrollbackPos = 0;      // Undo any scrolling.
-        update_msg(force);
+        update_msg();
     }// if
 }/* say*/
 
@@ -1543,66 +1834,61 @@ backspace() {
 
     tb_backspace_last_line(ConsoleBuffer);
 
-    // We just redraw everything.  This could be optimized but it
-    // happens rarely enough that I'm not going to worry about it
-    // right now.
-
     ScrollbackPos = 0;      // Undo any scrolling.
-    update_msg(true);
+    update_msg();
 }// backspace
 
 
 // Update the visible display of active effects (e.g. stealth).  If
-// 'force' is false, it may skip drawing some or all of the text that
-// is not present.
-//
-// (Currently, it skips redrawing if no effects have changed since the
-// last call.)
+// 'force' is false, only the lines whose effect has started or ended
+// since the last call are redrawn.
 void
 show_indicators(bool force) {
-    static uint32_t last_update = (uint32_t)(-1);
+    static uint32_t shown = 0;  // Bit n is set if indicator n is on screen
 
     struct {
         bool show;
         const char *label;
     } indicators [] = {
-        {!!UU.stealth,         "Stealth"},
-        {!!UU.undeadpro,       "Undead Pro"},
-        {!!UU.spiritpro,       "Spirit Pro"},
-        {!!UU.charmcount,      "Charm"},
-        {!!UU.timestop,        "Time Stop"},
-        {!!UU.holdmonst,       "Hold Monst"},
-        {!!UU.giantstr,        "Giant Str"},
-        {!!UU.fireresistance,  "Fire Resist"},
-        {!!UU.dexCount,        "Dexterity"},
-        {!!UU.strcount,        "Strength"},
-        {!!UU.scaremonst,      "Scare"},
-        {!!UU.hasteSelf,       "Haste Self"},
-        {!!UU.cancellation,    "Cancel"},
-        {!!UU.invisibility,    "Invisible"},
-        {!!UU.altpro,          "Shielded"},
-        {!!UU.protectionTime,  "Protected"},
-        {!!UU.wtw,             "Wall-Walk"},
-
-        // Note: must be less than 32 items so that the initial
-        // last_update will never equal the current this_update.
+        {!!effect_left(EFF_STEALTH),         "Stealth"},
+        {!!effect_left(EFF_UNDEADPRO),       "Undead Pro"},
+        {!!effect_left(EFF_SPIRITPRO),       "Spirit Pro"},
+        {!!effect_left(EFF_CHARM),      "Charm"},
+        {!!effect_left(EFF_TIMESTOP),        "Time Stop"},
+        {!!effect_left(EFF_HOLDMONST),       "Hold Monst"},
+        {!!effect_left(EFF_GIANTSTR),        "Giant Str"},
+        {!!effect_left(EFF_FIRERESISTANCE),  "Fire Resist"},
+        {!!effect_left(EFF_DEXCOUNT),        "Dexterity"},
+        {!!effect_left(EFF_STRCOUNT),        "Strength"},
+        {!!effect_left(EFF_SCAREMONST),      "Scare"},
+        {!!effect_left(EFF_HASTESELF),       "Haste Self"},
+        {!!effect_left(EFF_CANCELLATION),    "Cancel"},
+        {!!effect_left(EFF_INVISIBILITY),    "Invisible"},
+        {!!effect_left(EFF_ALTPRO),          "Shielded"},
+        {!!effect_left(EFF_PROTECTION),  "Protected"},
+        {!!effect_left(EFF_WTW),             "Wall-Walk"},
+
+        // Note: must be no more than 32 items so they all fit in
+        // 'shown'.
         {!!false, NULL}
     };
 
     uint32_t this_update = 0;
     for (int i = 0; indicators[i].label; i++) {
-        if (indicators[i].show) { this_update |= 1; }
-        this_update <<= 1;
+        ASSERT(i < 32);
+        if (indicators[i].show) { this_update |= (uint32_t)1 << i; }
     }
 
-    bool status_changed = this_update != last_update;
-    last_update = this_update;
+    uint32_t changed = force ? ~(uint32_t)0 : (this_update ^ shown);
+    shown = this_update;
 
     // If nothing changed (and it's not required), do nothing.
-    if (!force && !status_changed) { return; }
+    if (!changed) { return; }
 
-    // Update the indicator display.
+    // Update the indicator lines that changed.
     for (int i = 0; indicators[i].label; i++) {
+        if (!(changed & ((uint32_t)1 << i))) { continue; }
+
         const char *str =
             indicators[i].show ? indicators[i].label
                                : "                      ";
@@ -57,6 +57,8 @@ enum MAPFLAGS {
 void init_ui(void);
 void teardown_ui(void);
 void sync_ui(bool force);
+void render_stats_end_turn(long turn);
+bool toggle_render_overlay(void);
 
 char map_getch(void);
 
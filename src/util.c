@@ -3,8 +3,16 @@
 
 #include "util.h"
 
+#include "arena.h"
 #include "internal_assert.h"
 
+#include <time.h>
+
+
+// Number of allocations made by this thread through the functions
+// below.  See xalloc_count().
+static __thread unsigned long AllocCount = 0;
+
 
 /* Test if 'filename' is a file that exists and is readable. */
 bool
@@ -21,28 +29,44 @@ freadable(const char *filename) {
 }/* freadable*/
 
 
-/* Call malloc() with 'size' and die if there's an error. */
+// The allocators we call: the C library's or, in an ALLOC_STATS
+// build, wrappers around them that keep track of who's using what.
+#ifdef ALLOC_STATS
+#   define MALLOC(sz, file, func)       alloc_stats_malloc(sz, file, func)
+#   define CALLOC(n, sz, file, func)    alloc_stats_calloc(n, sz, file, func)
+#   define REALLOC(p, sz, file, func)   alloc_stats_realloc(p, sz, file, func)
+#else
+#   define MALLOC(sz, file, func)       malloc(sz)
+#   define CALLOC(n, sz, file, func)    calloc(n, sz)
+#   define REALLOC(p, sz, file, func)   realloc(p, sz)
+#endif
+
+
+/* Call malloc() with 'size' and die if there's an error.  (This is
+ * xmalloc(); 'file' and 'func' identify the caller.) */
 void *
-xmalloc(size_t size) {
+xmalloc_at(size_t size, const char *file, const char *func) {
     void *result;
 
-    result = malloc(size);
+    ++AllocCount;
+    result = MALLOC(size, file, func);
     ENSURE_MSG(!!result, "malloc() failed.");
 
     return result;
-}// xmalloc
+}// xmalloc_at
 
 
 /* Call calloc() with 'size' and die if there's an error. */
 void *
-xcalloc(size_t count, size_t size) {
+xcalloc_at(size_t count, size_t size, const char *file, const char *func) {
     void *result;
 
-    result = calloc(count, size);
+    ++AllocCount;
+    result = CALLOC(count, size, file, func);
     ENSURE_MSG(!!result, "calloc() failed.");
 
     return result;
-}// xcalloc
+}// xcalloc_at
 
 
 
@@ -51,26 +75,34 @@ xcalloc(size_t count, size_t size) {
  * that would legitimately trigger a return value of NULL (e.g. size
  * == 0). */
 void *
-xrealloc(void *ptr, size_t size) {
+xrealloc_at(void *ptr, size_t size, const char *file, const char *func) {
     void *result;
 
-    result = realloc(ptr, size);
+    ++AllocCount;
+    result = REALLOC(ptr, size, file, func);
     ENSURE_MSG(!!result, "realloc() failed.");
 
     return result;
-}// xrealloc
+}// xrealloc_at
 
 
-/* Call malloc() with 'size' and die if there's an error. */
+/* Like strdup() but dies if there's an error. */
 char *
-xstrdup(const char *src) {
-    char *result;
-
-    result = strdup(src);
-    ENSURE_MSG(!!result, "strdup() failed.");
+xstrdup_at(const char *src, const char *file, const char *func) {
+    size_t size = strlen(src) + 1;
+    char *result = xmalloc_at(size, file, func);
+    memcpy(result, src, size);
 
     return result;
-}// xstrdup
+}// xstrdup_at
+
+// Return the number of allocations (including reallocations) this
+// thread has made with xmalloc() and friends so far.  Subtract two
+// readings to count the allocations made by some piece of code.
+unsigned long
+xalloc_count() {
+    return AllocCount;
+}// xalloc_count
 
 /* Return the appropriate indefinite article ("a" or "an") to precede
  * 'word'. */
@@ -83,29 +115,26 @@ an(const char *word) {
 
 /* Given a string 'orig', split it along newlines ('\n') and return an
  * array of strings containing each segment.  Sets *nitems to the
- * number of items in the array.  Both the array and its contents must
- * be freed, but the string is allocated in one contiguous block so the
- * caller should only ever free the first element.  Memory errors are
- * instantly fatal.*/
+ * number of items in the array.  The array and its contents are
+ * allocated from the arena (see arena.h) and so only last until the
+ * end of the current command; don't free them. */
 char **
 splitstring(const char* orig, int* nitems) {
-    char *curr, *copy;
-    char **splitstr = NULL;
-    int segments;
-
-    copy = xstrdup(orig);
+    int segments = 1;
+    for (const char *c = orig; *c; c++) {
+        if (*c == '\n') { ++segments; }
+    }
 
-    segments = 1;
-    splitstr = xmalloc(segments * sizeof(char *));
-    splitstr[0] = copy;
+    char *copy = arena_strdup(orig);
+    char **splitstr = arena_alloc(segments * sizeof(char *));
 
-    for (curr = copy; *curr; curr++) {
+    int n = 0;
+    splitstr[n++] = copy;
+    for (char *curr = copy; *curr; curr++) {
         if (*curr != '\n') continue;
 
         *curr = 0;
-        ++segments;
-        splitstr = xrealloc(splitstr, segments * sizeof(char *));
-        splitstr[segments - 1] = curr + 1;
+        splitstr[n++] = curr + 1;
     }
 
     *nitems = segments;
@@ -141,3 +170,23 @@ char* zstrncpy(char *dest, const char *src, size_t max) {
     dest[max - 1] = 0;
     return result;
 }// zstrncpy
+
+
+// Return the current time in microseconds from some arbitrary but
+// fixed starting point.  This is only useful for measuring
+// intervals; unlike time(), it never goes backward.
+uint64_t
+monotonic_usec() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + (uint64_t)ts.tv_nsec / 1000;
+}// monotonic_usec
+
+
+__thread uint64_t RngState = 0;
+
+// Seed the current thread's random number generator.
+void
+seed_rng(unsigned long seed) {
+    RngState = seed;
+}// seed_rng
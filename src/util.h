@@ -39,20 +39,57 @@ typedef enum {
 
 
 bool freadable(const char *filename);
-void *xmalloc(size_t size);
-void *xcalloc(size_t count, size_t size);
-char *xstrdup(const char *);
-void *xrealloc(void *ptr, size_t size);
+unsigned long xalloc_count(void);
 char **splitstring(const char* orig, int* nitems);
 void adjpoint(int8_t x, int8_t y, DIRECTION dir, int8_t *outx, int8_t *outy);
 char* zstrncpy(char *dest, const char *src, size_t max);
+uint64_t monotonic_usec(void);
 
 const char *an(const char *word);
 
 
+// Heap allocation.  These are like their namesakes in the C library
+// but never return NULL; running out of memory is fatal.  They're
+// macros so that they can pass their callers' locations on to
+// allocstats.h in an ALLOC_STATS build (which also has free() go to
+// xfree()).
+void *xmalloc_at(size_t size, const char *file, const char *func);
+void *xcalloc_at(size_t count, size_t size, const char *file,
+                 const char *func);
+void *xrealloc_at(void *ptr, size_t size, const char *file,
+                  const char *func);
+char *xstrdup_at(const char *src, const char *file, const char *func);
+
+#define xmalloc(size)           xmalloc_at((size), __FILE__, __func__)
+#define xcalloc(count, size)    xcalloc_at((count), (size), __FILE__, __func__)
+#define xrealloc(ptr, size)     xrealloc_at((ptr), (size), __FILE__, __func__)
+#define xstrdup(src)            xstrdup_at((src), __FILE__, __func__)
+
+#ifdef ALLOC_STATS
+#   include "allocstats.h"
+#   define free(ptr)            xfree(ptr)
+#endif
+
+
+
+// The random number generator.  Its state is per-thread so that games
+// running in different threads don't contend for it (as they would
+// for random()) and each can be reproduced from its seed.  Use
+// seed_rng() in place of srandom().
+extern __thread uint64_t RngState;
+void seed_rng(unsigned long seed);
+
+// Return the next random number in the range 0 .. 2^31-1 (like
+// random()).  This is SplitMix64.
+static inline long rng_next() {
+    uint64_t z = (RngState += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return (long)((z ^ (z >> 31)) >> 33);
+}
 
-static inline int rnd(int x)  { return (random() % x) + 1; }
-static inline int rund(int x) { return random() % x; }
+static inline int rnd(int x)  { return (rng_next() % x) + 1; }
+static inline int rund(int x) { return rng_next() % x; }
 static inline int min(int x, int y) { return x > y ? y : x; }
 static inline int max(int x, int y) { return x < y ? y : x; }
 static inline long min_l(long x, long y) { return x > y ? y : x; }